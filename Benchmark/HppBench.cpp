@@ -0,0 +1,191 @@
+//******************************************************************************
+//!
+//! \file    HppBench.cpp
+//! \brief   Traverse benchmark of C++ template, inlined functor against C callback.
+//!          The same \ref BinaryTree is traversed by its typed functions, whose
+//!          functor is inlined into the walk loop, and by the C functions on
+//!          \ref BinaryTree::Root with a callback called through function pointer.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Build with the default configure, then run it:
+//!            gcc -O2 -I.. -c ../BinaryTree.c ../BinarySearchTree.c
+//!            g++ -O2 -std=c++11 -I.. HppBench.cpp BinaryTree.o BinarySearchTree.o
+//!                -o hpp_bench
+//!            ./hpp_bench [node count]
+//!          Default node count is 2M, small tree is traversed many times.
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#include "BinaryTree.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+//! Default node count.
+#define BENCH_NODE_COUNT       (2L * 1000L * 1000L)
+
+//! Repeat times of every case, the best one is reported.
+#define BENCH_REPEAT           3
+
+//! Nodes visited by one timed run at least, small tree is traversed many times, so
+//! the run is long enough for clock().
+#define BENCH_RUN_NODES        (8L * 1000L * 1000L)
+
+typedef BinaryTree<unsigned long> BenchTree_t;
+
+//! \brief Benchmark case.
+typedef struct BenchCase
+{
+    const char* pName;   //!< Case name.
+    int         Order;   //!< Traverse order, TREE_ITER_XXX.
+    int         Typed;   //!< Use typed function of template ?
+}BenchCase_t;
+
+static const BenchCase_t s_Cases[] =
+{
+    {"pre-order callback",  TREE_ITER_PRE_ORDER,  0},
+    {"pre-order functor",   TREE_ITER_PRE_ORDER,  1},
+    {"in-order callback",   TREE_ITER_IN_ORDER,   0},
+    {"in-order functor",    TREE_ITER_IN_ORDER,   1},
+    {"post-order callback", TREE_ITER_POST_ORDER, 0},
+    {"post-order functor",  TREE_ITER_POST_ORDER, 1},
+};
+
+//****************************************************************************************
+//
+//! \brief  C callback, add value to the sum, Data is the address of value.
+//
+//****************************************************************************************
+static int SumFun(void* Ctx, void* Data)
+{
+    *(unsigned long*)Ctx += *(unsigned long*)Data;
+    return (0);
+}
+
+//****************************************************************************************
+//
+//! \brief  Traverse tree once in Order, by C callback or by inlined functor.
+//
+//****************************************************************************************
+static TreeErrorCode_t BenchRun(const BenchTree_t& Tree, const BenchCase_t* pCase,
+                                unsigned long* pSum)
+{
+    auto Fun = [pSum](const unsigned long& Value)
+    {
+        *pSum += Value;
+        return (0);
+    };
+
+    if(pCase->Typed)
+    {
+        switch(pCase->Order)
+        {
+            case TREE_ITER_PRE_ORDER: return Tree.TravesePreOrder(Fun);
+            case TREE_ITER_IN_ORDER:  return Tree.TraveseInOrder(Fun);
+            default:                  return Tree.TravesePostOrder(Fun);
+        }
+    }
+
+    switch(pCase->Order)
+    {
+        case TREE_ITER_PRE_ORDER: return Tree_TravesePreOrder(Tree.Root(), SumFun, pSum);
+        case TREE_ITER_IN_ORDER:  return Tree_TraveseInOrder(Tree.Root(), SumFun, pSum);
+        default:                  return Tree_TravesePostOrder(Tree.Root(), SumFun, pSum);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    long          Count  = BENCH_NODE_COUNT;
+    long          Loops  = 0;
+    unsigned long Expect = 0;
+    BenchTree_t   Tree;
+
+    if(argc > 1)
+    {
+        Count = atol(argv[1]);
+    }
+
+    if(Count < 1 || Count > 0xFFFFFFFFL)
+    {
+        printf("usage: %s [node count >= 1]\n", argv[0]);
+        return (1);
+    }
+
+    //! Multiply by an odd number modulo 2^32 is a bijection, so keys are distinct and
+    //! inserted in random order.
+    for(long i = 0; i < Count; i++)
+    {
+        unsigned long Key = ((unsigned long)i * 2654435761UL) & 0xFFFFFFFFUL;
+
+        if(ERR_SUCCESS != Tree.Insert(Key))
+        {
+            printf("insert failed\n");
+            return (1);
+        }
+        Expect += Key;
+    }
+
+    Loops = (Count < BENCH_RUN_NODES) ? (BENCH_RUN_NODES / Count) : 1;
+    printf("nodes: %ld, depth: %d\n", Count, Tree_DepthGet(Tree.Root()));
+
+    for(size_t c = 0; c < sizeof(s_Cases) / sizeof(s_Cases[0]); c++)
+    {
+        const BenchCase_t* pCase = &s_Cases[c];
+        double             Best  = 0.0;
+
+        for(int r = 0; r < BENCH_REPEAT; r++)
+        {
+            unsigned long   Sum   = 0;
+            TreeErrorCode_t Ret   = ERR_SUCCESS;
+            clock_t         Start = clock();
+            double          Time  = 0.0;
+
+            for(long l = 0; l < Loops && ERR_SUCCESS == Ret; l++)
+            {
+                Ret = BenchRun(Tree, pCase, &Sum);
+            }
+
+            Time = (double)(clock() - Start) / CLOCKS_PER_SEC;
+            if(ERR_SUCCESS != Ret || Sum != Expect * (unsigned long)Loops)
+            {
+                printf("%s: wrong result\n", pCase->pName);
+                return (1);
+            }
+
+            if(0 == r || Time < Best)
+            {
+                Best = Time;
+            }
+        }
+
+        printf("%-20s %8.2f ns/node\n", pCase->pName, Best * 1e9 / (double)Count / (double)Loops);
+    }
+
+    return (0);
+}
@@ -0,0 +1,762 @@
+//******************************************************************************
+//!
+//! \file    StressMT.c
+//! \brief   Stress test of multi-thread functions of BinaryTreeMT.
+//!          Work stealing traverse, parallel clone and delete, background reclaimer,
+//!          node cache, epoch grace period and RCU publish/replace are run by several
+//!          threads at once, sums, sizes and node counts are checked.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Build it with sanitizers, "make stress" in this directory runs both:
+//!            gcc -g -O1 -fsanitize=address,undefined -I.. -DUSE_DYNAMIC_MEMORY
+//!                -DUSE_NODE_CACHE -DUSE_TREE_STATS ../BinaryTree.c ../BinaryTreeMT.c
+//!                ../BinaryTreeStats.c StressMT.c -o stress_asan -lpthread
+//!            gcc -g -O1 -fsanitize=thread -I.. -DUSE_DYNAMIC_MEMORY -DUSE_NODE_CACHE
+//!                -DUSE_TREE_STATS ../BinaryTree.c ../BinaryTreeMT.c
+//!                ../BinaryTreeStats.c StressMT.c -o stress_tsan -lpthread
+//!            ./stress_asan [rounds] ; ./stress_tsan [rounds]
+//!          AddressSanitizer reports nodes used after free, ThreadSanitizer reports
+//!          data races. Nodes are poisoned before they are freed, so a reader that
+//!          outlives the grace period is caught by value too, as node cache does not
+//!          return memory to malloc. The first failed check exits with 1.
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#include "BinaryTree.h"
+#include "BinaryTreeMT.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef USE_TREE_STATS
+#include "BinaryTreeStats.h"
+#endif
+
+#ifndef USE_DYNAMIC_MEMORY
+#error "StressMT create and free nodes, select USE_DYNAMIC_MEMORY."
+#endif
+
+#ifdef USE_INLINE_DATA
+#error "StressMT store values in data pointer, do not select USE_INLINE_DATA."
+#endif
+
+//! Threads of parallel functions and of reclaimer case.
+#define STRESS_THREADS         8
+
+//! Nodes of the trees of traverse case.
+#define STRESS_NODES           20000L
+
+//! Reclaimer case, every thread makes STRESS_TREES trees of STRESS_TREE_NODES nodes,
+//! STRESS_KEEP of them are alive at once.
+#define STRESS_TREES           200
+#define STRESS_TREE_NODES      200L
+#define STRESS_KEEP            4
+
+//! RCU case, readers and writer steps, the tree starts with STRESS_RCU_NODES nodes.
+#define STRESS_READERS         4
+#define STRESS_RCU_STEPS       20000
+#define STRESS_RCU_NODES       1000L
+
+//! Biggest subtree unlinked by RCU case.
+#define STRESS_RCU_UNLINK      16
+
+//! RCU case reader yields every STRESS_RCU_YIELD nodes in read side critical section.
+#define STRESS_RCU_YIELD       64
+
+//! Values of live nodes are in [1, STRESS_VALUE_MAX], freed nodes have STRESS_POISON.
+#define STRESS_VALUE_MAX       ((uintptr_t)1 << 40)
+#define STRESS_POISON          UINTPTR_MAX
+
+//! Stop value of callback, see \ref TREE_STOP_BASE.
+#define STRESS_STOP            (TREE_STOP_BASE + 1)
+
+//! Default number of rounds.
+#define STRESS_ROUNDS          3
+
+#if STRESS_THREADS > TREE_MT_MAX_THREADS || STRESS_READERS > TREE_MT_MAX_READERS
+#error "StressMT use more threads than BinaryTreeMT support."
+#endif
+
+//! \brief Check a condition, the first failed one ends the program.
+#define STRESS_CHECK(Cond)                                                            \
+    do                                                                                \
+    {                                                                                 \
+        if(!(Cond))                                                                   \
+        {                                                                             \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Cond);           \
+            exit(1);                                                                  \
+        }                                                                             \
+    } while(0)
+
+//! \brief Value of node data.
+#define STRESS_VALUE(pData)    ((uintptr_t)(pData))
+
+//! \brief Shape of tree.
+typedef enum StressShape
+{
+    SHAPE_RANDOM,      //!< Random descent from root, depth is about 2*log2(n).
+    SHAPE_VINE,        //!< Right spine with a left leaf at every node, depth is n/2.
+    SHAPE_NUM,
+}StressShape_t;
+
+//! \brief Sum of traversal, padded so contexts of threads do not share lines.
+typedef struct StressSum
+{
+    uint64_t Sum;
+    long     Count;
+    char     Pad[TREE_MT_CACHE_LINE - sizeof(uint64_t) - sizeof(long)];
+}StressSum_t;
+
+//! \brief Context of reclaimer case thread.
+typedef struct StressWorker
+{
+    pthread_t Thread;
+    int       Id;
+}StressWorker_t;
+
+//! \brief Context of RCU case reader.
+typedef struct StressReader
+{
+    pthread_t Thread;
+    int       Slot;
+    long      Reads;   //!< Read side critical sections.
+    long      Nodes;   //!< Nodes visited in all of them.
+}StressReader_t;
+
+static const char* s_ShapeName[SHAPE_NUM] = {"random", "vine"};
+
+//! Stop value is returned when this value is visited.
+static uintptr_t       s_StopAt = 0;
+
+//! Reclaimer shared by reclaimer case and RCU case.
+static TreeReclaimer_t s_Reclaimer;
+
+//! RCU case.
+static TreeEpoch_t     s_Epoch;
+static TreeNode_t*     s_pRcuRoot  = NULL;
+static int             s_RcuStop   = 0;
+static int             s_RcuReady  = 0;
+
+#ifdef USE_TREE_STATS
+//! Statistics blocks, 0 is main thread, then reclaimer case threads, then readers.
+static TreeStats_t     s_Stats[1 + STRESS_THREADS + STRESS_READERS];
+#endif
+
+//****************************************************************************************
+//
+//! \brief  Get random number of [0, Max), every thread has its own seed.
+//
+//****************************************************************************************
+static long RandGet(uint64_t* pSeed, long Max)
+{
+    *pSeed = *pSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    return ((long)((*pSeed >> 33) % (uint64_t)Max));
+}
+
+//****************************************************************************************
+//
+//! \brief  Make a dynamic tree of Count nodes, values are First ... First + Count - 1.
+//
+//****************************************************************************************
+static TreeNode_t* TreeMake(long Count, StressShape_t Shape, uintptr_t First, uint64_t* pSeed)
+{
+    TreeNode_t* pRoot   = NULL;
+    TreeNode_t* pTail   = NULL;
+    TreeNode_t* pParent = NULL;
+    TreeNode_t* pNode   = NULL;
+    int         Mode    = 0;
+    long        i       = 0;
+
+    for(i = 0; i < Count; i++)
+    {
+        pNode = Tree_NodeCreate();
+        STRESS_CHECK(NULL != pNode);
+        Tree_NodeValueSet(pNode, (void*)(First + (uintptr_t)i));
+
+        if(NULL == pRoot)
+        {
+            pRoot = pTail = pNode;
+            continue;
+        }
+
+        if(SHAPE_VINE == Shape)
+        {
+            pParent = pTail;
+            Mode    = (0 == (i & 1)) ? INSERT_POS_RIGHT : INSERT_POS_LEFT;
+            if(INSERT_POS_RIGHT == Mode)
+            {
+                pTail = pNode;
+            }
+        }
+        else
+        {
+            //! Walk down by random sides until a free child slot is found.
+            pParent = pRoot;
+            for(;;)
+            {
+                Mode = (0 == RandGet(pSeed, 2)) ? INSERT_POS_LEFT : INSERT_POS_RIGHT;
+                if(NULL == ((INSERT_POS_LEFT == Mode) ? pParent->left : pParent->right))
+                {
+                    break;
+                }
+                pParent = (INSERT_POS_LEFT == Mode) ? pParent->left : pParent->right;
+            }
+        }
+
+        STRESS_CHECK(ERR_SUCCESS == Tree_NodeAppend(pParent, pNode, Mode));
+    }
+
+    return (pRoot);
+}
+
+//****************************************************************************************
+//
+//! \brief  Sum of values First ... First + Count - 1.
+//
+//****************************************************************************************
+static uint64_t SumGet(long Count, uintptr_t First)
+{
+    return ((uint64_t)Count * (uint64_t)First + (uint64_t)Count * (uint64_t)(Count - 1) / 2);
+}
+
+//****************************************************************************************
+//
+//! \brief  Callback, sum values into context, stop on freed node.
+//
+//****************************************************************************************
+static int SumFun(void* Ctx, void* Data)
+{
+    StressSum_t* pSum  = (StressSum_t*)Ctx;
+    uintptr_t    Value = STRESS_VALUE(Data);
+
+    if(0 == Value || Value > STRESS_VALUE_MAX)
+    {
+        return (STRESS_STOP);
+    }
+
+    pSum->Sum += Value;
+    pSum->Count++;
+
+    return (0);
+}
+
+//****************************************************************************************
+//
+//! \brief  Callback, stop when s_StopAt is visited.
+//
+//****************************************************************************************
+static int StopFun(void* Ctx, void* Data)
+{
+    (void)Ctx;
+
+    return ((STRESS_VALUE(Data) == s_StopAt) ? STRESS_STOP : 0);
+}
+
+//****************************************************************************************
+//
+//! \brief  Check count and sum of tree by serial traversal.
+//
+//****************************************************************************************
+static void TreeCheck(TreeNode_t* pRoot, long Count, uint64_t Sum)
+{
+    StressSum_t Result;
+
+    memset(&Result, 0, sizeof(Result));
+    STRESS_CHECK(ERR_SUCCESS == Tree_TravesePreOrder(pRoot, SumFun, &Result));
+    STRESS_CHECK(Count == Result.Count && Sum == Result.Sum);
+}
+
+//****************************************************************************************
+//
+//! \brief  Check parallel traverse of every thread count and some split depths.
+//
+//****************************************************************************************
+static void ParallelCheck(TreeNode_t* pRoot, long Count, uint64_t Sum)
+{
+    static const int Split[] = {0, 3, 10};
+    StressSum_t      Result[STRESS_THREADS];
+    void*            ppCtx[STRESS_THREADS];
+    StressSum_t      Total;
+    size_t           s       = 0;
+    int              Threads = 0;
+    int              i       = 0;
+
+    for(Threads = 1; Threads <= STRESS_THREADS; Threads++)
+    {
+        for(s = 0; s < sizeof(Split) / sizeof(Split[0]); s++)
+        {
+            memset(Result, 0, sizeof(Result));
+            memset(&Total, 0, sizeof(Total));
+            for(i = 0; i < Threads; i++)
+            {
+                ppCtx[i] = &Result[i];
+            }
+
+            STRESS_CHECK(ERR_SUCCESS == Tree_TraveseParallel(pRoot, SumFun, ppCtx, Threads,
+                                                             Split[s]));
+            for(i = 0; i < Threads; i++)
+            {
+                Total.Sum   += Result[i].Sum;
+                Total.Count += Result[i].Count;
+            }
+            STRESS_CHECK(Count == Total.Count && Sum == Total.Sum);
+        }
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Traverse case: parallel traverse, stop value, parallel clone and parallel
+//!         delete of random and vine trees.
+//
+//****************************************************************************************
+static void StressTraverse(uint64_t* pSeed)
+{
+    void*        ppCtx[STRESS_THREADS];
+    TreeArena_t* pArena = NULL;
+    TreeNode_t*  pRoot  = NULL;
+    TreeNode_t*  pCopy  = NULL;
+    uint64_t     Sum    = SumGet(STRESS_NODES, 1);
+    int          Shape  = 0;
+    int          i      = 0;
+
+    for(Shape = 0; Shape < SHAPE_NUM; Shape++)
+    {
+        pRoot = TreeMake(STRESS_NODES, (StressShape_t)Shape, 1, pSeed);
+        TreeCheck(pRoot, STRESS_NODES, Sum);
+        ParallelCheck(pRoot, STRESS_NODES, Sum);
+
+        //! Every thread stops at its next task after one of them stopped.
+        for(i = 0; i < STRESS_THREADS; i++)
+        {
+            ppCtx[i] = NULL;
+        }
+        s_StopAt = 1 + (uintptr_t)RandGet(pSeed, STRESS_NODES);
+        STRESS_CHECK(STRESS_STOP == Tree_TraveseParallel(pRoot, StopFun, ppCtx,
+                                                         STRESS_THREADS, 3));
+
+        pArena = Tree_ArenaCreate((int)STRESS_NODES);
+        STRESS_CHECK(NULL != pArena);
+        pCopy = Tree_SubTreeClone_Parallel(pArena, pRoot, 1 + (int)RandGet(pSeed, STRESS_THREADS));
+        STRESS_CHECK(NULL != pCopy && STRESS_NODES == pArena->Used);
+        TreeCheck(pCopy, STRESS_NODES, Sum);
+        ParallelCheck(pCopy, STRESS_NODES, Sum);
+        STRESS_CHECK(ERR_SUCCESS == Tree_ArenaDestory(&pArena));
+
+        STRESS_CHECK(ERR_SUCCESS == Tree_SubTreeDelete_Parallel(&pRoot,
+                                        1 + (int)RandGet(pSeed, STRESS_THREADS)));
+        STRESS_CHECK(NULL == pRoot);
+        printf("traverse   %-8s ok\n", s_ShapeName[Shape]);
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Reclaimer case thread: make trees and free them by every dynamic delete
+//!         function, a few trees are kept alive while other threads free nodes.
+//
+//****************************************************************************************
+static void* WorkerRun(void* pArg)
+{
+    StressWorker_t* pWorker = (StressWorker_t*)pArg;
+    TreeNode_t*     pKeep[STRESS_KEEP];
+    uintptr_t       First[STRESS_KEEP];
+    uint64_t        Seed    = (uint64_t)pWorker->Id + 1;
+    uintptr_t       Next    = 1 + (uintptr_t)pWorker->Id * STRESS_TREES * STRESS_TREE_NODES;
+    long            Slot    = 0;
+    int             t       = 0;
+
+#ifdef USE_TREE_STATS
+    Tree_StatsBind(&s_Stats[1 + pWorker->Id]);
+#endif
+
+    memset(pKeep, 0, sizeof(pKeep));
+    for(t = 0; t < STRESS_TREES + STRESS_KEEP; t++)
+    {
+        Slot = t % STRESS_KEEP;
+
+        //! A node handed out twice by node cache has a wrong value now.
+        if(NULL != pKeep[Slot])
+        {
+            TreeCheck(pKeep[Slot], STRESS_TREE_NODES, SumGet(STRESS_TREE_NODES, First[Slot]));
+            switch(RandGet(&Seed, 3))
+            {
+            case 0:
+                STRESS_CHECK(ERR_SUCCESS == Tree_SubTreeDelete_Async(&s_Reclaimer, &pKeep[Slot]));
+                break;
+            case 1:
+                STRESS_CHECK(ERR_SUCCESS == Tree_SubTreeDelete_Parallel(&pKeep[Slot], 2));
+                break;
+            default:
+                STRESS_CHECK(ERR_SUCCESS == Tree_SubTreeDelete_Dynamic(&pKeep[Slot]));
+                break;
+            }
+            STRESS_CHECK(NULL == pKeep[Slot]);
+        }
+
+        if(t < STRESS_TREES)
+        {
+            First[Slot] = Next;
+            pKeep[Slot] = TreeMake(STRESS_TREE_NODES, SHAPE_RANDOM, Next, &Seed);
+            Next       += STRESS_TREE_NODES;
+        }
+    }
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \brief  Reclaimer case: nodes are got and put by several threads and by reclaimer.
+//
+//****************************************************************************************
+static void StressReclaim(void)
+{
+    StressWorker_t Worker[STRESS_THREADS];
+    int            i = 0;
+
+    for(i = 0; i < STRESS_THREADS; i++)
+    {
+        Worker[i].Id = i;
+        STRESS_CHECK(0 == pthread_create(&Worker[i].Thread, NULL, WorkerRun, &Worker[i]));
+    }
+
+    for(i = 0; i < STRESS_THREADS; i++)
+    {
+        pthread_join(Worker[i].Thread, NULL);
+    }
+    printf("reclaim    %-8s ok\n", "random");
+}
+
+//****************************************************************************************
+//
+//! \brief  Callback of RCU case reader, sum values and yield now and then, so the
+//!         writer runs while readers hold nodes even when cores are fewer than threads.
+//
+//****************************************************************************************
+static int ReadFun(void* Ctx, void* Data)
+{
+    StressSum_t* pSum = (StressSum_t*)Ctx;
+
+    if(0 == (pSum->Count + 1) % STRESS_RCU_YIELD)
+    {
+        sched_yield();
+    }
+
+    return (SumFun(Ctx, Data));
+}
+
+//****************************************************************************************
+//
+//! \brief  Compare function of RCU case reader, check and count the value like
+//!         \ref ReadFun, then go left or right by a bit of value, so \ref Tree_RcuFind
+//!         walks a random path down to a leaf.
+//
+//****************************************************************************************
+static int FindFun(void* Ctx, void* Key, void* Data)
+{
+    STRESS_CHECK(0 == ReadFun(Ctx, Data));
+
+    return (((STRESS_VALUE(Data) ^ (uintptr_t)Key) & 1) ? -1 : 1);
+}
+
+//****************************************************************************************
+//
+//! \brief  RCU case reader: walk the tree lock free in pre-order and in-order by
+//!         turns, and search down a random path, until writer stops.
+//
+//****************************************************************************************
+static void* ReaderRun(void* pArg)
+{
+    StressReader_t* pReader = (StressReader_t*)pArg;
+    StressSum_t     Result;
+    TreeNode_t*     pRoot   = NULL;
+    TreeNode_t*     pNode   = NULL;
+    TreeErrorCode_t Ret     = ERR_SUCCESS;
+
+#ifdef USE_TREE_STATS
+    Tree_StatsBind(&s_Stats[1 + STRESS_THREADS + pReader->Slot]);
+#endif
+
+    __atomic_add_fetch(&s_RcuReady, 1, __ATOMIC_RELEASE);
+    do
+    {
+        memset(&Result, 0, sizeof(Result));
+
+        Tree_EpochReadEnter(&s_Epoch, pReader->Slot);
+        pRoot = TREE_RCU_DEREF(s_pRcuRoot);
+        if(0 == pReader->Reads % 2)
+        {
+            Ret = Tree_RcuTravesePreOrder(pRoot, ReadFun, &Result);
+        }
+        else
+        {
+            Ret = Tree_RcuTraveseInOrder(pRoot, ReadFun, &Result);
+        }
+        pNode = Tree_RcuFind(pRoot, (void*)(uintptr_t)pReader->Reads, FindFun, &Result);
+        Tree_EpochReadExit(&s_Epoch, pReader->Slot);
+
+        //! Root is never unlinked, and FindFun never matches.
+        STRESS_CHECK(ERR_SUCCESS == Ret && NULL == pNode);
+        pReader->Reads++;
+        pReader->Nodes += Result.Count;
+    } while(!__atomic_load_n(&s_RcuStop, __ATOMIC_ACQUIRE));
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \brief  Count nodes of published subtree by writer. \ref Tree_SizeGet borrows links
+//!         without parent pointer, so it can not be used while readers walk the tree.
+//
+//****************************************************************************************
+static long SubTreeCount(TreeNode_t* pNode)
+{
+    long Count = 0;
+
+    while(NULL != pNode)
+    {
+        Count += 1 + SubTreeCount(pNode->left);
+        pNode  = pNode->right;
+    }
+
+    return (Count);
+}
+
+//****************************************************************************************
+//
+//! \brief  Poison values of a retired subtree, readers stop on them.
+//
+//****************************************************************************************
+static void SubTreePoison(TreeNode_t* pNode)
+{
+    while(NULL != pNode)
+    {
+        Tree_NodeValueSet(pNode, (void*)STRESS_POISON);
+        SubTreePoison(pNode->left);
+        pNode = pNode->right;
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  RCU case: one writer appends, replaces and unlinks nodes, waits grace
+//!         periods and frees them, while readers walk the tree.
+//
+//****************************************************************************************
+static void StressRcu(uint64_t* pSeed)
+{
+    StressReader_t Reader[STRESS_READERS];
+    TreeNode_t**   ppLink  = NULL;
+    TreeNode_t*    pParent = NULL;
+    TreeNode_t*    pNode   = NULL;
+    TreeNode_t*    pOld    = NULL;
+    uintptr_t      Next    = 1 + STRESS_RCU_NODES;
+    long           Live    = STRESS_RCU_NODES;
+    long           Reads   = 0;
+    long           Nodes   = 0;
+    long           Retired = 0;
+    long           Op      = 0;
+    int            Mode    = 0;
+    int            Step    = 0;
+    int            i       = 0;
+
+    STRESS_CHECK(ERR_SUCCESS == Tree_EpochInit(&s_Epoch));
+    s_pRcuRoot = TreeMake(STRESS_RCU_NODES, SHAPE_RANDOM, 1, pSeed);
+    s_RcuStop  = 0;
+    s_RcuReady = 0;
+
+    memset(Reader, 0, sizeof(Reader));
+    for(i = 0; i < STRESS_READERS; i++)
+    {
+        Reader[i].Slot = i;
+        STRESS_CHECK(0 == pthread_create(&Reader[i].Thread, NULL, ReaderRun, &Reader[i]));
+    }
+    while(__atomic_load_n(&s_RcuReady, __ATOMIC_ACQUIRE) < STRESS_READERS)
+    {
+        sched_yield();
+    }
+
+    for(Step = 0; Step < STRESS_RCU_STEPS; Step++)
+    {
+        //! Let readers run when there are fewer cores than threads.
+        sched_yield();
+        Tree_EpochWriteEnter(&s_Epoch);
+
+        //! Writers are serialized, links are read by plain loads here.
+        ppLink  = &s_pRcuRoot;
+        pParent = NULL;
+        while(NULL != *ppLink && 0 != RandGet(pSeed, 16))
+        {
+            pParent = *ppLink;
+            ppLink  = (0 == RandGet(pSeed, 2)) ? &pParent->left : &pParent->right;
+        }
+
+        pNode = Tree_NodeCreate();
+        STRESS_CHECK(NULL != pNode);
+        Tree_NodeValueSet(pNode, (void*)Next++);
+
+        if(NULL == *ppLink)
+        {
+            Mode = (ppLink == &pParent->left) ? INSERT_POS_LEFT : INSERT_POS_RIGHT;
+            STRESS_CHECK(ERR_SUCCESS == Tree_RcuNodeAppend(pParent, pNode, Mode));
+            Tree_EpochWriteExit(&s_Epoch);
+            Live++;
+            continue;
+        }
+
+        //! Replace 3/8, unlink 1/8, append 1/2. Root and big subtrees are not unlinked,
+        //! so the tree does not shrink, append to them instead.
+        pOld = *ppLink;
+        Op   = RandGet(pSeed, 8);
+        if(3 == Op && (ppLink == &s_pRcuRoot || SubTreeCount(pOld) > STRESS_RCU_UNLINK))
+        {
+            Op = 4;
+        }
+
+        switch(Op)
+        {
+        case 0:
+        case 1:
+        case 2:
+            //! New copy of old value.
+            Tree_NodeValueSet(pNode, Tree_NodeValueGet(pOld));
+            STRESS_CHECK(ERR_SUCCESS == Tree_RcuNodeReplace(ppLink, pNode));
+            Tree_EpochWriteExit(&s_Epoch);
+
+            Tree_EpochSynchronize(&s_Epoch);
+            Tree_NodeInit(pOld);
+            Tree_NodeValueSet(pOld, (void*)STRESS_POISON);
+            STRESS_CHECK(ERR_SUCCESS == Tree_NodeDestory(&pOld));
+            Retired++;
+            break;
+
+        case 3:
+            Retired += SubTreeCount(pOld);
+            Live    -= SubTreeCount(pOld);
+            STRESS_CHECK(ERR_SUCCESS == Tree_RcuSubTreeUnlink(ppLink));
+            Tree_EpochWriteExit(&s_Epoch);
+            STRESS_CHECK(ERR_SUCCESS == Tree_NodeDestory(&pNode));
+
+            Tree_EpochSynchronize(&s_Epoch);
+            SubTreePoison(pOld);
+            if(0 == RandGet(pSeed, 2))
+            {
+                STRESS_CHECK(ERR_SUCCESS == Tree_SubTreeDelete_Async(&s_Reclaimer, &pOld));
+            }
+            else
+            {
+                STRESS_CHECK(ERR_SUCCESS == Tree_SubTreeDelete_Dynamic(&pOld));
+            }
+            break;
+
+        default:
+            Mode = (0 == RandGet(pSeed, 2)) ? INSERT_POS_LEFT : INSERT_POS_RIGHT;
+            if(ERR_SUCCESS == Tree_RcuNodeAppend(pOld, pNode, Mode))
+            {
+                Live++;
+                Tree_EpochWriteExit(&s_Epoch);
+            }
+            else
+            {
+                Tree_EpochWriteExit(&s_Epoch);
+                STRESS_CHECK(ERR_SUCCESS == Tree_NodeDestory(&pNode));
+            }
+            break;
+        }
+    }
+
+    __atomic_store_n(&s_RcuStop, 1, __ATOMIC_RELEASE);
+    for(i = 0; i < STRESS_READERS; i++)
+    {
+        pthread_join(Reader[i].Thread, NULL);
+        STRESS_CHECK(Reader[i].Reads > 0);
+        Reads += Reader[i].Reads;
+        Nodes += Reader[i].Nodes;
+    }
+
+    STRESS_CHECK(Live == Tree_SizeGet(s_pRcuRoot));
+    STRESS_CHECK(ERR_SUCCESS == Tree_SubTreeDelete_Dynamic(&s_pRcuRoot));
+    STRESS_CHECK(ERR_SUCCESS == Tree_EpochDestory(&s_Epoch));
+    printf("rcu        %-8s ok, %ld reads of %ld nodes on average, %ld nodes retired\n",
+           "random", Reads, Nodes / Reads, Retired);
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t        Seed   = 1;
+    long            Rounds = STRESS_ROUNDS;
+    long            r      = 0;
+#ifdef USE_TREE_STATS
+    TreeStatsSnap_t Snap;
+#endif
+
+    if(argc > 1)
+    {
+        Rounds = atol(argv[1]);
+    }
+
+    if(Rounds < 1)
+    {
+        printf("usage: %s [rounds, 1..]\n", argv[0]);
+        return (1);
+    }
+
+#ifdef USE_TREE_STATS
+    Tree_StatsBind(&s_Stats[0]);
+#endif
+    STRESS_CHECK(ERR_SUCCESS == Tree_ReclaimerCreate(&s_Reclaimer));
+
+    for(r = 0; r < Rounds; r++)
+    {
+        printf("round %ld\n", r + 1);
+        StressTraverse(&Seed);
+        StressReclaim();
+        StressRcu(&Seed);
+    }
+
+    //! All pending subtrees are freed, then every node got is put back.
+    STRESS_CHECK(ERR_SUCCESS == Tree_ReclaimerDestory(&s_Reclaimer));
+#ifdef USE_TREE_STATS
+    Tree_StatsSnapshot(&Snap, s_Stats, (int)(sizeof(s_Stats) / sizeof(s_Stats[0])));
+    STRESS_CHECK(Snap.Allocs > 0 && 0 == Snap.Nodes);
+    STRESS_CHECK(Snap.Traverses > 0 && Snap.TraveseDepthMax > 0);
+    printf("stats      %llu allocs, %llu frees, %llu traverses of depth %.1f, max %llu\n",
+           (unsigned long long)Snap.Allocs, (unsigned long long)Snap.Frees,
+           (unsigned long long)Snap.Traverses, Snap.TraveseDepthMean,
+           (unsigned long long)Snap.TraveseDepthMax);
+#endif
+    printf("passed\n");
+
+    return (0);
+}
@@ -0,0 +1,283 @@
+//******************************************************************************
+//!
+//! \file    TraverseBench.c
+//! \brief   Traverse benchmark of pointer based binary tree.
+//!          Nodes and user data are scattered in memory, so every step of traversal
+//!          is a cache miss when the tree is bigger than last level cache.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Build it twice, with and without prefetch, then compare the output:
+//!            gcc -O2 -I.. -DUSE_STACK_ALGORITHM ../BinaryTree.c TraverseBench.c -o bench
+//!            gcc -O2 -I.. -DUSE_STACK_ALGORITHM -DUSE_PREFETCH ../BinaryTree.c
+//!                TraverseBench.c -o bench_prefetch
+//!            ./bench [node count] ; ./bench_prefetch [node count]
+//!          Default node count is 8M, about 256MB of nodes plus 64MB of data on 64-bit host.
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#include "BinaryTree.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef USE_STACK_ALGORITHM
+#error "TraverseBench need USE_STACK_ALGORITHM, the _Ex traverse functions are benchmarked."
+#endif
+
+#ifdef USE_INLINE_DATA
+#error "TraverseBench store the pointer of user data, do not select USE_INLINE_DATA."
+#endif
+
+//! Default node count.
+#define BENCH_NODE_COUNT       (8L * 1024L * 1024L)
+
+//! Batch size of \ref Tree_TraveseBatch.
+#define BENCH_BATCH_SIZE       64
+
+//! Repeat times of every case, the best one is reported.
+#define BENCH_REPEAT           3
+
+//! Nodes visited by one timed run at least, small tree is traversed many times, so
+//! the run is long enough for clock().
+#define BENCH_RUN_NODES        (8L * 1024L * 1024L)
+
+//! \brief Benchmark case.
+typedef struct BenchCase
+{
+    const char* pName;   //!< Case name.
+    int         Order;   //!< Traverse order, -1 for level-order.
+    int         Batch;   //!< Use batch callback ?
+}BenchCase_t;
+
+static const BenchCase_t s_Cases[] =
+{
+    {"pre-order",          TREE_ITER_PRE_ORDER,  0},
+    {"in-order",           TREE_ITER_IN_ORDER,   0},
+    {"post-order",         TREE_ITER_POST_ORDER, 0},
+    {"level-order",        -1,                   0},
+    {"pre-order batch",    TREE_ITER_PRE_ORDER,  1},
+    {"in-order batch",     TREE_ITER_IN_ORDER,   1},
+    {"post-order batch",   TREE_ITER_POST_ORDER, 1},
+};
+
+//****************************************************************************************
+//
+//! \brief  Per node callback, add user data to the sum.
+//
+//****************************************************************************************
+static int SumFun(void* Ctx, void* Data)
+{
+    *(unsigned long*)Ctx += *(unsigned long*)Data;
+    return (0);
+}
+
+//****************************************************************************************
+//
+//! \brief  Batch callback, add user data of the whole batch to the sum.
+//
+//****************************************************************************************
+static int SumBatchFun(void* Ctx, void** ppData, int Count)
+{
+    unsigned long Sum = 0;
+    int           i   = 0;
+
+    for(i = 0; i < Count; i++)
+    {
+        Sum += *(unsigned long*)ppData[i];
+    }
+    *(unsigned long*)Ctx += Sum;
+
+    return (0);
+}
+
+//****************************************************************************************
+//
+//! \brief  Get random number of [0, Max), rand() may only give 15 bits.
+//
+//****************************************************************************************
+static long RandGet(long Max)
+{
+    unsigned long Value = ((unsigned long)rand() << 30) ^ ((unsigned long)rand() << 15)
+                        ^ (unsigned long)rand();
+
+    return ((long)(Value % (unsigned long)Max));
+}
+
+//****************************************************************************************
+//
+//! \brief  Shuffle index array.
+//
+//****************************************************************************************
+static void Shuffle(long* pIndex, long Count)
+{
+    long i    = 0;
+    long j    = 0;
+    long Temp = 0;
+
+    for(i = 0; i < Count; i++)
+    {
+        pIndex[i] = i;
+    }
+
+    for(i = Count - 1; i > 0; i--)
+    {
+        j         = RandGet(i + 1);
+        Temp      = pIndex[i];
+        pIndex[i] = pIndex[j];
+        pIndex[j] = Temp;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    long           Count   = BENCH_NODE_COUNT;
+    TreeNode_t*    pNodes  = NULL;
+    unsigned long* pValues = NULL;
+    long*          pIndex  = NULL;
+    TreeNode_t**   pBuf    = NULL;
+    void*          Batch[BENCH_BATCH_SIZE];
+    TreeStack_t    Stack;
+    TreeQueue_t    Queue;
+    TreeNode_t*    pRoot   = NULL;
+    unsigned long  Expect  = 0;
+    long           Loops   = 0;
+    long           i       = 0;
+    long           l       = 0;
+    size_t         c       = 0;
+
+    if(argc > 1)
+    {
+        Count = atol(argv[1]);
+    }
+
+    if(Count < 2)
+    {
+        printf("usage: %s [node count >= 2]\n", argv[0]);
+        return (1);
+    }
+
+    pNodes  = (TreeNode_t*)malloc(sizeof(TreeNode_t) * (size_t)Count);
+    pValues = (unsigned long*)malloc(sizeof(unsigned long) * (size_t)Count);
+    pIndex  = (long*)malloc(sizeof(long) * (size_t)Count);
+    pBuf    = (TreeNode_t**)malloc(sizeof(TreeNode_t*) * (size_t)Count);
+    if(NULL == pNodes || NULL == pValues || NULL == pIndex || NULL == pBuf)
+    {
+        printf("out of memory\n");
+        return (1);
+    }
+
+    //! Random data placement.
+    srand(1);
+    Shuffle(pIndex, Count);
+    for(i = 0; i < Count; i++)
+    {
+        Tree_NodeInit(&pNodes[i]);
+        pValues[i] = (unsigned long)i;
+        Expect    += (unsigned long)i;
+        Tree_NodeValueSet(&pNodes[i], &pValues[pIndex[i]]);
+    }
+
+    //! Random node placement, node k of complete tree is stored at pNodes[pIndex[k]].
+    Shuffle(pIndex, Count);
+    for(i = 1; i < Count; i++)
+    {
+        Tree_NodeAppend(&pNodes[pIndex[(i - 1) / 2]], &pNodes[pIndex[i]],
+                        (i & 1) ? INSERT_POS_LEFT : INSERT_POS_RIGHT);
+    }
+    pRoot = &pNodes[pIndex[0]];
+
+    Tree_StackInit(&Stack, pBuf, (int)Count);
+    Tree_QueueInit(&Queue, pBuf, (int)Count);
+    Loops = (Count < BENCH_RUN_NODES) ? (BENCH_RUN_NODES / Count) : 1;
+
+#ifdef USE_PREFETCH
+    printf("prefetch: ON, nodes: %ld\n", Count);
+#else
+    printf("prefetch: OFF, nodes: %ld\n", Count);
+#endif
+
+    for(c = 0; c < sizeof(s_Cases) / sizeof(s_Cases[0]); c++)
+    {
+        const BenchCase_t* pCase = &s_Cases[c];
+        double             Best  = 0.0;
+        int                r     = 0;
+
+        for(r = 0; r < BENCH_REPEAT; r++)
+        {
+            unsigned long Sum   = 0;
+            clock_t       Start = clock();
+            double        Time  = 0.0;
+
+            for(l = 0; l < Loops; l++)
+            {
+                if(pCase->Batch)
+                {
+                    Tree_TraveseBatchEx(pRoot, pCase->Order, SumBatchFun, &Sum, Batch,
+                                        BENCH_BATCH_SIZE, &Stack);
+                }
+                else if(TREE_ITER_PRE_ORDER == pCase->Order)
+                {
+                    Tree_TravesePreOrderEx(pRoot, SumFun, &Sum, &Stack);
+                }
+                else if(TREE_ITER_IN_ORDER == pCase->Order)
+                {
+                    Tree_TraveseInOrderEx(pRoot, SumFun, &Sum, &Stack);
+                }
+                else if(TREE_ITER_POST_ORDER == pCase->Order)
+                {
+                    Tree_TravesePostOrderEx(pRoot, SumFun, &Sum, &Stack);
+                }
+                else
+                {
+                    Tree_TraveseLevelOrderEx(pRoot, SumFun, &Sum, &Queue);
+                }
+            }
+
+            Time = (double)(clock() - Start) / CLOCKS_PER_SEC;
+            if(Sum != Expect * (unsigned long)Loops)
+            {
+                printf("%s: wrong result\n", pCase->pName);
+                return (1);
+            }
+
+            if(0 == r || Time < Best)
+            {
+                Best = Time;
+            }
+        }
+
+        printf("%-16s %8.2f ns/node\n", pCase->pName, Best * 1e9 / (double)Count / (double)Loops);
+    }
+
+    free(pBuf);
+    free(pIndex);
+    free(pValues);
+    free(pNodes);
+
+    return (0);
+}
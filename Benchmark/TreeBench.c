@@ -0,0 +1,1042 @@
+//******************************************************************************
+//!
+//! \file    TreeBench.c
+//! \brief   Benchmark suite of build, traversal, depth, lookup and teardown.
+//!          Balanced, random and degenerate trees from 1K nodes up to the given
+//!          count (x10 per step) are measured, ns/node, cache misses/node (when perf
+//!          counters are available), peak call stack and peak heap are reported.
+//!          Node data are numbered in in-order, so every tree is a binary search
+//!          tree, lookup cases search one random key per node.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Build once per engine, optionally with dynamic memory, then compare:
+//!            gcc -O2 -I.. -DUSE_DYNAMIC_MEMORY ../BinaryTree.c ../BinarySearchTree.c
+//!                TreeBench.c -o bench_rec -lpthread
+//!            gcc -O2 -I.. -DUSE_DYNAMIC_MEMORY -DUSE_STACK_ALGORITHM ../BinaryTree.c
+//!                ../BinarySearchTree.c TreeBench.c -o bench_stack -lpthread
+//!            ./bench_rec [max node count] ; ./bench_stack [max node count]
+//!          "make" in this directory builds both of them, see Makefile.
+//!          Stack engine runs the traversals twice: by the _Ex functions with a work
+//!          stack of all nodes, and by the default functions ("default" cases), whose
+//!          failures are reported with the error code.
+//!          Default max node count is 1M, 100M nodes need about 12GB of memory.
+//!          Peak stack/heap are measured by resident pages (mincore), cache misses by
+//!          perf_event_open, both are Linux only and "n/a" is printed elsewhere.
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#define _GNU_SOURCE
+
+#include "BinaryTree.h"
+#include "BinarySearchTree.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define BENCH_USE_PERF
+#define BENCH_USE_MINCORE
+#endif
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_USE_MALLINFO
+#endif
+
+#ifdef USE_INLINE_DATA
+#error "TreeBench store the pointer of user data, do not select USE_INLINE_DATA."
+#endif
+
+#ifdef USE_NODE_CACHE
+#error "TreeBench link BinaryTree.c only, do not select USE_NODE_CACHE."
+#endif
+
+//! Smallest node count, it is multiplied by 10 until the max node count.
+#define BENCH_MIN_COUNT        1000L
+
+//! Default max node count.
+#define BENCH_MAX_COUNT        (1000L * 1000L)
+
+//! Every case is repeated to handle BENCH_WORK_COUNT nodes at least, and
+//! BENCH_REPEAT times at least, the best one is reported.
+#define BENCH_WORK_COUNT       (4L * 1000L * 1000L)
+#define BENCH_REPEAT           3
+
+//! Call stack of benchmark thread, it is reserved but only touched pages are used.
+#define BENCH_STACK_SIZE       ((size_t)256 * 1024 * 1024)
+
+//! Recursive engine need one frame per level, degenerate tree bigger than this is
+//! skipped so the call stack is never overflowed.
+#define BENCH_RECURSIVE_DEPTH  (1000L * 1000L)
+
+//! Lookup cost grows with depth of tree, degenerate tree bigger than this is skipped by
+//! lookup cases, or they take O(n^2).
+#define BENCH_SEARCH_DEPTH     (1000L)
+
+//! Result of case function when traversal succeeds but the result is wrong, positive
+//! results are \ref TreeErrorCode_t.
+#define BENCH_WRONG            (-1)
+
+//! \brief Tree shape.
+typedef enum BenchShape
+{
+    SHAPE_BALANCED  ,   //!< Complete tree, node k is the parent of node 2k+1 and 2k+2.
+    SHAPE_RANDOM    ,   //!< Random binary search tree shape, height is O(log n).
+    SHAPE_DEGENERATE,   //!< Every node is the left child of previous one.
+    SHAPE_NUM       ,
+}BenchShape_t;
+
+static const char* s_ShapeName[SHAPE_NUM] = {"balanced", "random", "degenerate"};
+
+static const char* s_ErrName[] =
+{
+    "ERR_SUCCESS", "ERR_FAILURE", "ERR_INVALID_POINTER", "ERR_MEM", "ERR_WRONG_PARAM",
+    "ERR_NODE_EXIST",
+};
+
+//! \brief Benchmark context, shared by all cases of one tree.
+typedef struct Bench
+{
+    BenchShape_t   Shape   ;   //!< Tree shape.
+    long           Count   ;   //!< Number of nodes.
+    long*          pLink   ;   //!< Node i is linked to pLink[i]/2, left if it is even.
+    long*          pRank   ;   //!< In-order rank of node i, its data is pValues[pRank[i]].
+    void**         ppKey   ;   //!< Keys of lookup cases, they point into pValues.
+    TreeNode_t*    pNodes  ;   //!< Nodes of static tree.
+    unsigned long* pValues ;   //!< User data, pValues[i] is i.
+    TreeNode_t*    pRoot   ;   //!< Root of static tree.
+    TreeNode_t**   ppDyn   ;   //!< Nodes of dynamic tree.
+    TreeNode_t*    pDynRoot;   //!< Root of dynamic tree.
+    TreeNode_t**   ppWork  ;   //!< Work stack/queue buffer, only touched pages are used.
+    size_t         WorkSize;   //!< Size of work buffer, in bytes.
+    unsigned long  Expect  ;   //!< Sum of user data.
+}Bench_t;
+
+//! \brief Case function, return zero if the result is right, \ref BENCH_WRONG if it is
+//!        wrong, or the error code of failed function.
+typedef int (*BenchFun_t)(Bench_t* pBench);
+
+//! \brief Benchmark case.
+typedef struct BenchCase
+{
+    const char* pName;    //!< Case name.
+    BenchFun_t  pFun ;    //!< Case function.
+    int         Deep ;    //!< Call stack grow with depth of tree in recursive engine ?
+    int         Find ;    //!< Lookup case, cost grows with depth of tree ?
+}BenchCase_t;
+
+//! \brief Result of one run.
+typedef struct BenchRun
+{
+    Bench_t*           pBench ;   //!< Benchmark context.
+    const BenchCase_t* pCase  ;   //!< Case that is run.
+    int                Measure;   //!< Measure stack and heap ? it is slow.
+    int                Ret    ;   //!< Return value of case function.
+    double             Time   ;   //!< Time of case function, in seconds.
+    long long          Misses ;   //!< Cache misses, -1 if not available.
+    long               Heap   ;   //!< Heap growth of case function, -1 if not available.
+}BenchRun_t;
+
+//! Call stack of benchmark thread.
+static void*  s_pStack    = NULL;
+static long   s_StackBase = 0;   //!< Stack used by an empty case.
+static size_t s_PageSize  = 0;
+
+//****************************************************************************************
+//
+//! \brief  Get random number of [0, Max), rand() may only give 15 bits.
+//
+//****************************************************************************************
+static long RandGet(long Max)
+{
+    unsigned long Value = ((unsigned long)rand() << 30) ^ ((unsigned long)rand() << 15)
+                        ^ (unsigned long)rand();
+
+    return ((long)(Value % (unsigned long)Max));
+}
+
+//****************************************************************************************
+//
+//! \brief  Get time in seconds, monotonic clock is used as small trees take a few
+//!         microseconds only.
+//
+//****************************************************************************************
+static double TimeGet(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+
+    return ((double)Now.tv_sec + (double)Now.tv_nsec * 1e-9);
+}
+
+//****************************************************************************************
+//
+//! \brief  Reserve memory, pages are allocated when they are touched.
+//
+//****************************************************************************************
+static void* MemReserve(size_t Size)
+{
+    void* pMem = mmap(NULL, Size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    return ((MAP_FAILED == pMem) ? NULL : pMem);
+}
+
+//****************************************************************************************
+//
+//! \brief  Get bytes of resident pages, -1 if not available.
+//
+//****************************************************************************************
+static long MemTouched(void* pMem, size_t Size)
+{
+#ifdef BENCH_USE_MINCORE
+    unsigned char Vec[4096];
+    size_t        Pages = Size / s_PageSize;
+    size_t        Done  = 0;
+    size_t        n     = 0;
+    size_t        i     = 0;
+    long          Count = 0;
+
+    for(Done = 0; Done < Pages; Done += n)
+    {
+        n = (Pages - Done < sizeof(Vec)) ? (Pages - Done) : sizeof(Vec);
+        if(0 != mincore((char*)pMem + Done * s_PageSize, n * s_PageSize, Vec))
+        {
+            return (-1);
+        }
+        for(i = 0; i < n; i++)
+        {
+            Count += Vec[i] & 1;
+        }
+    }
+
+    return (Count * (long)s_PageSize);
+#else
+    (void)pMem;
+    (void)Size;
+    return (-1);
+#endif
+}
+
+//****************************************************************************************
+//
+//! \brief  Give pages back, so they are counted again by \ref MemTouched.
+//
+//****************************************************************************************
+static void MemDrop(void* pMem, size_t Size)
+{
+    madvise(pMem, Size, MADV_DONTNEED);
+}
+
+//****************************************************************************************
+//
+//! \brief  Get bytes of heap in use, -1 if not available.
+//
+//****************************************************************************************
+static long HeapGet(void)
+{
+#ifdef BENCH_USE_MALLINFO
+    struct mallinfo2 Info = mallinfo2();
+
+    return ((long)(Info.uordblks + Info.hblkhd));
+#else
+    return (-1);
+#endif
+}
+
+#ifdef BENCH_USE_PERF
+//****************************************************************************************
+//
+//! \brief  Open cache miss counter of calling thread, -1 if not available.
+//
+//****************************************************************************************
+static int PerfOpen(void)
+{
+    struct perf_event_attr Attr;
+
+    memset(&Attr, 0, sizeof(Attr));
+    Attr.type           = PERF_TYPE_HARDWARE;
+    Attr.size           = sizeof(Attr);
+    Attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+    Attr.disabled       = 1;
+    Attr.exclude_kernel = 1;
+    Attr.exclude_hv     = 1;
+
+    return ((int)syscall(SYS_perf_event_open, &Attr, 0, -1, -1, 0));
+}
+#endif // BENCH_USE_PERF
+
+//****************************************************************************************
+//!                     CASES
+//****************************************************************************************
+
+static int SumFun(void* Ctx, void* Data)
+{
+    *(unsigned long*)Ctx += *(unsigned long*)Data;
+    return (0);
+}
+
+//! \brief  Node i of shape, it is one of ppDyn if not NULL, or of the static array.
+#define BENCH_NODE(pBench, ppDyn, i)                                                  \
+    ((NULL != (ppDyn)) ? (ppDyn)[i] : &(pBench)->pNodes[i])
+
+//****************************************************************************************
+//
+//! \brief  Link all nodes by \ref Tree_NodeAppend in the order of shape.
+//
+//****************************************************************************************
+static void BuildLink(Bench_t* pBench, TreeNode_t** ppDyn)
+{
+    long i = 0;
+
+    for(i = 1; i < pBench->Count; i++)
+    {
+        Tree_NodeAppend(BENCH_NODE(pBench, ppDyn, pBench->pLink[i] / 2),
+                        BENCH_NODE(pBench, ppDyn, i),
+                        (0 == (pBench->pLink[i] & 1)) ? INSERT_POS_LEFT : INSERT_POS_RIGHT);
+    }
+}
+
+static int CaseBuild(Bench_t* pBench)
+{
+    long i = 0;
+
+    for(i = 0; i < pBench->Count; i++)
+    {
+        Tree_NodeInit(&pBench->pNodes[i]);
+        Tree_NodeValueSet(&pBench->pNodes[i], &pBench->pValues[pBench->pRank[i]]);
+    }
+    BuildLink(pBench, NULL);
+    pBench->pRoot = &pBench->pNodes[0];
+
+    return (0);
+}
+
+//! \brief  Check sum of traversal.
+#define BENCH_SUM_CHECK(pBench, Ret, Sum)                                             \
+    ((ERR_SUCCESS != (Ret)) ? (int)(Ret) : (((Sum) == (pBench)->Expect) ? 0 : BENCH_WRONG))
+
+#ifdef USE_STACK_ALGORITHM
+//! \brief  Stack engine: _Ex functions with a work stack of all nodes, the default
+//!         stack of <TREE_STACK_DEPTH> entries is too small for deep tree.
+#define BENCH_TRAVESE(Name, pBench, Sum)                                              \
+    do                                                                                \
+    {                                                                                 \
+        TreeStack_t Stack;                                                            \
+        Tree_StackInit(&Stack, (pBench)->ppWork, (int)(pBench)->Count);               \
+        Ret = Name##Ex((pBench)->pRoot, SumFun, &(Sum), &Stack);                      \
+    } while(0)
+#else
+#define BENCH_TRAVESE(Name, pBench, Sum)                                              \
+    (Ret = Name((pBench)->pRoot, SumFun, &(Sum)))
+#endif
+
+static int CasePreOrder(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = ERR_FAILURE;
+
+    BENCH_TRAVESE(Tree_TravesePreOrder, pBench, Sum);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+
+static int CaseInOrder(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = ERR_FAILURE;
+
+    BENCH_TRAVESE(Tree_TraveseInOrder, pBench, Sum);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+
+static int CasePostOrder(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = ERR_FAILURE;
+
+    BENCH_TRAVESE(Tree_TravesePostOrder, pBench, Sum);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+
+static int CaseLevelOrder(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = ERR_FAILURE;
+    TreeQueue_t     Queue;
+
+    //! Queue is sized once, the default queue grows by doubling on the way.
+    Tree_QueueInit(&Queue, pBench->ppWork, (int)pBench->Count);
+    Ret = Tree_TraveseLevelOrderEx(pBench->pRoot, SumFun, &Sum, &Queue);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+
+#ifdef USE_PARENT_POINTER
+static int CaseInOrderParent(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = Tree_TraveseInOrder_Parent(pBench->pRoot, SumFun, &Sum);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+#endif
+
+static int CaseDepth(Bench_t* pBench)
+{
+    int Depth = 0;
+
+#ifdef USE_STACK_ALGORITHM
+    TreeStack_t Stack;
+
+    Tree_StackInit(&Stack, pBench->ppWork, (int)pBench->Count);
+    Depth = Tree_DepthGetEx(pBench->pRoot, &Stack);
+#else
+    Depth = Tree_DepthGet(pBench->pRoot);
+#endif
+
+    return ((Depth > 0) ? 0 : BENCH_WRONG);
+}
+
+#ifdef USE_STACK_ALGORITHM
+static int CasePreOrderDefault(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = Tree_TravesePreOrder(pBench->pRoot, SumFun, &Sum);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+
+static int CaseInOrderDefault(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = Tree_TraveseInOrder(pBench->pRoot, SumFun, &Sum);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+
+static int CasePostOrderDefault(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = Tree_TravesePostOrder(pBench->pRoot, SumFun, &Sum);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+
+static int CaseDepthDefault(Bench_t* pBench)
+{
+    return ((Tree_DepthGet(pBench->pRoot) > 0) ? 0 : BENCH_WRONG);
+}
+#endif // USE_STACK_ALGORITHM
+
+static int CaseLevelOrderDefault(Bench_t* pBench)
+{
+    unsigned long   Sum = 0;
+    TreeErrorCode_t Ret = Tree_TraveseLevelOrder(pBench->pRoot, SumFun, &Sum);
+
+    return BENCH_SUM_CHECK(pBench, Ret, Sum);
+}
+
+static int KeyCmp(void* Ctx, void* Key, void* Data)
+{
+    unsigned long KeyValue  = *(unsigned long*)Key;
+    unsigned long DataValue = *(unsigned long*)Data;
+
+    (void)Ctx;
+    return ((KeyValue < DataValue) ? -1 : ((KeyValue > DataValue) ? 1 : 0));
+}
+
+static int CaseFind(Bench_t* pBench)
+{
+    TreeNode_t* pNode = NULL;
+    long        i     = 0;
+
+    for(i = 0; i < pBench->Count; i++)
+    {
+        pNode = Tree_BstFind(pBench->pRoot, pBench->ppKey[i], KeyCmp, NULL);
+        if(NULL == pNode || Tree_NodeValueGet(pNode) != pBench->ppKey[i])
+        {
+            return (BENCH_WRONG);
+        }
+    }
+
+    return (0);
+}
+
+static int CaseFindBatch(Bench_t* pBench)
+{
+    TreeErrorCode_t Ret = ERR_FAILURE;
+    long            i   = 0;
+
+    //! Results are written to the work buffer.
+    Ret = Tree_BstFindBatch(pBench->pRoot, pBench->ppKey, pBench->ppWork, (int)pBench->Count,
+                            KeyCmp, NULL);
+    if(ERR_SUCCESS != Ret)
+    {
+        return ((int)Ret);
+    }
+
+    for(i = 0; i < pBench->Count; i++)
+    {
+        if(NULL == pBench->ppWork[i] || Tree_NodeValueGet(pBench->ppWork[i]) != pBench->ppKey[i])
+        {
+            return (BENCH_WRONG);
+        }
+    }
+
+    return (0);
+}
+
+static int CaseDeleteStatic(Bench_t* pBench)
+{
+    Tree_SubTreeDelete_Static(&pBench->pRoot);
+
+    return ((NULL == pBench->pRoot) ? 0 : BENCH_WRONG);
+}
+
+#ifdef USE_DYNAMIC_MEMORY
+static int CaseBuildDynamic(Bench_t* pBench)
+{
+    long i = 0;
+
+    for(i = 0; i < pBench->Count; i++)
+    {
+        pBench->ppDyn[i] = Tree_NodeCreate();
+        if(NULL == pBench->ppDyn[i])
+        {
+            return ((int)ERR_MEM);
+        }
+        Tree_NodeValueSet(pBench->ppDyn[i], &pBench->pValues[pBench->pRank[i]]);
+    }
+    BuildLink(pBench, pBench->ppDyn);
+    pBench->pDynRoot = pBench->ppDyn[0];
+
+    return (0);
+}
+
+static int CaseDeleteDynamic(Bench_t* pBench)
+{
+    Tree_SubTreeDelete_Dynamic(&pBench->pDynRoot);
+
+    return ((NULL == pBench->pDynRoot) ? 0 : BENCH_WRONG);
+}
+#endif // USE_DYNAMIC_MEMORY
+
+static int CaseEmpty(Bench_t* pBench)
+{
+    (void)pBench;
+    return (0);
+}
+
+//! Cases are run in this order on every tree, so the static tree is built before and
+//! deleted after all traversals, the dynamic tree is built just before it is deleted.
+//! Dynamic build is marked deep as its tree can only be released by dynamic delete.
+//! Depth is not deep, \ref Tree_DepthGet walks without recursion in both engines.
+static const BenchCase_t s_Cases[] =
+{
+    {"build append",       CaseBuild,             0, 0},
+    {"pre-order",          CasePreOrder,          1, 0},
+    {"in-order",           CaseInOrder,           1, 0},
+    {"post-order",         CasePostOrder,         1, 0},
+    {"level-order",        CaseLevelOrder,        0, 0},
+#ifdef USE_PARENT_POINTER
+    {"in-order parent",    CaseInOrderParent,     0, 0},
+#endif
+#ifdef USE_STACK_ALGORITHM
+    {"pre default",        CasePreOrderDefault,   0, 0},
+    {"in default",         CaseInOrderDefault,    0, 0},
+    {"post default",       CasePostOrderDefault,  0, 0},
+#endif
+    {"level default",      CaseLevelOrderDefault, 0, 0},
+    {"depth",              CaseDepth,             0, 0},
+#ifdef USE_STACK_ALGORITHM
+    {"depth default",      CaseDepthDefault,      0, 0},
+#endif
+    {"bst find",           CaseFind,              0, 1},
+    {"bst find batch",     CaseFindBatch,         0, 1},
+    {"delete static",      CaseDeleteStatic,      1, 0},
+#ifdef USE_DYNAMIC_MEMORY
+    {"build dynamic",      CaseBuildDynamic,      1, 0},
+    {"delete dynamic",     CaseDeleteDynamic,     1, 0},
+#endif
+};
+
+//****************************************************************************************
+//!                     RUNNER
+//****************************************************************************************
+
+//****************************************************************************************
+//
+//! \brief  Thread entry of one run, the case is timed and counted on this thread.
+//
+//****************************************************************************************
+static void* RunThread(void* Arg)
+{
+    BenchRun_t* pRun  = (BenchRun_t*)Arg;
+    double      Start = 0.0;
+    long        Heap  = 0;
+    int         Fd    = -1;
+
+    pRun->Misses = -1;
+#ifdef BENCH_USE_PERF
+    Fd = PerfOpen();
+    if(Fd >= 0)
+    {
+        ioctl(Fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(Fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+
+    //! mallinfo2() walk the free lists, so it is never called in timed repeats.
+    Heap       = pRun->Measure ? HeapGet() : -1;
+    Start      = TimeGet();
+    pRun->Ret  = pRun->pCase->pFun(pRun->pBench);
+    pRun->Time = TimeGet() - Start;
+    pRun->Heap = (Heap < 0) ? -1 : (HeapGet() - Heap);
+
+#ifdef BENCH_USE_PERF
+    if(Fd >= 0)
+    {
+        long long Misses = 0;
+
+        ioctl(Fd, PERF_EVENT_IOC_DISABLE, 0);
+        if(sizeof(Misses) == read(Fd, &Misses, sizeof(Misses)))
+        {
+            pRun->Misses = Misses;
+        }
+        close(Fd);
+    }
+#else
+    (void)Fd;
+#endif
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \brief  Run case on a thread whose call stack is \ref s_pStack.
+//!
+//! \retval stack used by the thread, -1 if not measured or not available.
+//
+//****************************************************************************************
+static long RunCase(BenchRun_t* pRun)
+{
+    pthread_attr_t Attr;
+    pthread_t      Thread;
+    long           Stack = -1;
+
+    if(pRun->Measure)
+    {
+        MemDrop(s_pStack, BENCH_STACK_SIZE);
+    }
+    pthread_attr_init(&Attr);
+    pthread_attr_setstack(&Attr, s_pStack, BENCH_STACK_SIZE);
+    if(0 != pthread_create(&Thread, &Attr, RunThread, pRun))
+    {
+        pthread_attr_destroy(&Attr);
+        pRun->Ret = 1;
+        return (-1);
+    }
+    pthread_join(Thread, NULL);
+    pthread_attr_destroy(&Attr);
+
+    if(!pRun->Measure)
+    {
+        return (-1);
+    }
+
+    Stack = MemTouched(s_pStack, BENCH_STACK_SIZE);
+
+    return ((Stack < 0) ? -1 : (Stack - s_StackBase));
+}
+
+//****************************************************************************************
+//
+//! \brief  Print size in KB, or n/a.
+//
+//****************************************************************************************
+static void SizePrint(long Size)
+{
+    if(Size < 0)
+    {
+        printf(" %10s", "n/a");
+    }
+    else
+    {
+        printf(" %9ldK", (Size + 1023) / 1024);
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Number nodes of shape in in-order and pick the keys of lookup cases.
+//
+//****************************************************************************************
+static void RankMake(Bench_t* pBench)
+{
+    long  Count  = pBench->Count;
+    long* pChild = (long*)malloc(sizeof(long) * (size_t)Count * 2);
+    long* pPath  = (long*)malloc(sizeof(long) * (size_t)Count);
+    long  Depth  = 0;
+    long  Rank   = 0;
+    long  i      = 0;
+
+    if(NULL == pChild || NULL == pPath)
+    {
+        printf("out of memory\n");
+        exit(1);
+    }
+
+    //! Child slot of node i is pChild[i*2], left, and pChild[i*2+1], right, a slot
+    //! is encoded like pLink.
+    for(i = 0; i < Count * 2; i++)
+    {
+        pChild[i] = -1;
+    }
+    for(i = 1; i < Count; i++)
+    {
+        pChild[pBench->pLink[i]] = i;
+    }
+
+    i = 0;
+    while(i >= 0 || Depth > 0)
+    {
+        if(i >= 0)
+        {
+            pPath[Depth++] = i;
+            i              = pChild[i * 2];
+        }
+        else
+        {
+            i                = pPath[--Depth];
+            pBench->pRank[i] = Rank++;
+            i                = pChild[i * 2 + 1];
+        }
+    }
+
+    for(i = 0; i < Count; i++)
+    {
+        pBench->ppKey[i] = &pBench->pValues[RandGet(Count)];
+    }
+
+    free(pPath);
+    free(pChild);
+}
+
+//****************************************************************************************
+//
+//! \brief  Make link table of shape, node 0 is the root.
+//
+//****************************************************************************************
+static void ShapeMake(Bench_t* pBench)
+{
+    long* pLink = pBench->pLink;
+    long  Count = pBench->Count;
+    long  i     = 0;
+
+    if(SHAPE_BALANCED == pBench->Shape)
+    {
+        for(i = 1; i < Count; i++)
+        {
+            pLink[i] = ((i - 1) / 2) * 2 + ((0 == (i & 1)) ? 1 : 0);
+        }
+    }
+    else if(SHAPE_DEGENERATE == pBench->Shape)
+    {
+        for(i = 1; i < Count; i++)
+        {
+            pLink[i] = (i - 1) * 2;
+        }
+    }
+    else
+    {
+        //! Every free child slot is picked with the same chance, so the shape is the
+        //! shape of a random binary search tree. A slot is encoded like pLink, one
+        //! slot is taken and two are added by every node.
+        long* pSlot = (long*)malloc(sizeof(long) * (size_t)(Count + 1));
+        long  nSlot = 2;
+        long  j     = 0;
+
+        if(NULL == pSlot)
+        {
+            printf("out of memory\n");
+            exit(1);
+        }
+
+        pSlot[0] = 0;
+        pSlot[1] = 1;
+        for(i = 1; i < Count; i++)
+        {
+            j            = RandGet(nSlot);
+            pLink[i]     = pSlot[j];
+            pSlot[j]     = i * 2;
+            pSlot[nSlot] = i * 2 + 1;
+            nSlot++;
+        }
+        free(pSlot);
+    }
+
+    RankMake(pBench);
+}
+
+//****************************************************************************************
+//
+//! \brief  Run all cases on one tree and print the results.
+//
+//****************************************************************************************
+static void BenchTree(Bench_t* pBench)
+{
+    double    Best  [sizeof(s_Cases) / sizeof(s_Cases[0])];
+    long long Misses[sizeof(s_Cases) / sizeof(s_Cases[0])];
+    long      Stack [sizeof(s_Cases) / sizeof(s_Cases[0])];
+    long      Heap  [sizeof(s_Cases) / sizeof(s_Cases[0])];
+    int       Bad   [sizeof(s_Cases) / sizeof(s_Cases[0])];
+    size_t    Num    = sizeof(s_Cases) / sizeof(s_Cases[0]);
+    long      Repeat = BENCH_WORK_COUNT / pBench->Count;
+    int       Skip   = 0;
+    int       Flat   = 0;
+    size_t    c      = 0;
+    long      r      = 0;
+
+    if(Repeat < BENCH_REPEAT)
+    {
+        Repeat = BENCH_REPEAT;
+    }
+
+#ifdef USE_RECURSIVE_ALGORITHM
+    Skip = (SHAPE_DEGENERATE == pBench->Shape && pBench->Count > BENCH_RECURSIVE_DEPTH);
+#endif
+
+    Flat = (SHAPE_DEGENERATE == pBench->Shape && pBench->Count > BENCH_SEARCH_DEPTH);
+
+    for(r = 0; r < Repeat; r++)
+    {
+        for(c = 0; c < Num; c++)
+        {
+            BenchRun_t Run;
+
+            if((Skip && s_Cases[c].Deep) || (Flat && s_Cases[c].Find))
+            {
+                continue;
+            }
+
+            memset(&Run, 0, sizeof(Run));
+            Run.pBench  = pBench;
+            Run.pCase   = &s_Cases[c];
+            Run.Measure = (0 == r);
+
+            //! Stack and heap are the same in every repeat, they are measured once.
+            if(Run.Measure)
+            {
+                MemDrop(pBench->ppWork, pBench->WorkSize);
+                Stack[c]  = RunCase(&Run);
+                Best[c]   = Run.Time;
+                Misses[c] = Run.Misses;
+                Bad[c]    = 0;
+
+                //! Work buffer is reserved memory, its touched part is counted as heap.
+                Heap[c] = MemTouched(pBench->ppWork, pBench->WorkSize);
+                if(Heap[c] >= 0 && Run.Heap > 0)
+                {
+                    Heap[c] += Run.Heap;
+                }
+            }
+            else
+            {
+                RunCase(&Run);
+                if(Run.Time < Best[c])
+                {
+                    Best[c]   = Run.Time;
+                    Misses[c] = Run.Misses;
+                }
+            }
+            if(0 == Bad[c])
+            {
+                Bad[c] = Run.Ret;
+            }
+        }
+
+        //! Static tree is deleted, dynamic tree is released by delete case.
+        pBench->pRoot = NULL;
+    }
+
+    for(c = 0; c < Num; c++)
+    {
+        printf("%-10s %10ld %-16s ", s_ShapeName[pBench->Shape], pBench->Count,
+               s_Cases[c].pName);
+        if(Skip && s_Cases[c].Deep)
+        {
+            printf("skipped, deeper than call stack\n");
+            continue;
+        }
+        if(Flat && s_Cases[c].Find)
+        {
+            printf("skipped, lookup of degenerate tree is O(n)\n");
+            continue;
+        }
+        if(BENCH_WRONG == Bad[c])
+        {
+            printf("wrong result\n");
+            continue;
+        }
+        if(Bad[c] > 0 && Bad[c] < (int)(sizeof(s_ErrName) / sizeof(s_ErrName[0])))
+        {
+            printf("failed, %s\n", s_ErrName[Bad[c]]);
+            continue;
+        }
+        if(Bad[c])
+        {
+            printf("failed, error %d\n", Bad[c]);
+            continue;
+        }
+
+        printf("%9.2f", Best[c] * 1e9 / (double)pBench->Count);
+        if(Misses[c] < 0)
+        {
+            printf(" %10s", "n/a");
+        }
+        else
+        {
+            printf(" %10.3f", (double)Misses[c] / (double)pBench->Count);
+        }
+        SizePrint(Stack[c]);
+        SizePrint(Heap[c]);
+        printf("\n");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Bench_t     Bench;
+    BenchRun_t  Run;
+    BenchCase_t Empty = {"empty", CaseEmpty, 0, 0};
+    long        Max   = BENCH_MAX_COUNT;
+    long        Count = 0;
+    int         Shape = 0;
+    long        i     = 0;
+
+    if(argc > 1)
+    {
+        Max = atol(argv[1]);
+    }
+
+    if(Max < BENCH_MIN_COUNT || Max > INT32_MAX)
+    {
+        printf("usage: %s [max node count, %ld..%ld]\n", argv[0], BENCH_MIN_COUNT,
+               (long)INT32_MAX);
+        return (1);
+    }
+
+#ifdef BENCH_USE_MALLINFO
+    //! mallinfo2() only report the main arena, keep nodes of case threads there.
+    mallopt(M_ARENA_MAX, 1);
+#endif
+
+    memset(&Bench, 0, sizeof(Bench));
+    s_PageSize     = (size_t)sysconf(_SC_PAGESIZE);
+    s_pStack       = MemReserve(BENCH_STACK_SIZE);
+    Bench.WorkSize = sizeof(TreeNode_t*) * (size_t)Max;
+    Bench.ppWork   = (TreeNode_t**)MemReserve(Bench.WorkSize);
+    Bench.pLink    = (long*)malloc(sizeof(long) * (size_t)Max);
+    Bench.pRank    = (long*)malloc(sizeof(long) * (size_t)Max);
+    Bench.ppKey    = (void**)malloc(sizeof(void*) * (size_t)Max);
+    Bench.pNodes   = (TreeNode_t*)malloc(sizeof(TreeNode_t) * (size_t)Max);
+    Bench.pValues  = (unsigned long*)malloc(sizeof(unsigned long) * (size_t)Max);
+#ifdef USE_DYNAMIC_MEMORY
+    Bench.ppDyn    = (TreeNode_t**)malloc(sizeof(TreeNode_t*) * (size_t)Max);
+    if(NULL == Bench.ppDyn)
+    {
+        printf("out of memory\n");
+        return (1);
+    }
+#endif
+    if(NULL == s_pStack || NULL == Bench.ppWork || NULL == Bench.pLink ||
+       NULL == Bench.pRank || NULL == Bench.ppKey || NULL == Bench.pNodes ||
+       NULL == Bench.pValues)
+    {
+        printf("out of memory\n");
+        return (1);
+    }
+
+    for(i = 0; i < Max; i++)
+    {
+        Bench.pValues[i] = (unsigned long)i;
+    }
+
+    //! Stack used by thread itself, it is subtracted from every case.
+    memset(&Run, 0, sizeof(Run));
+    Run.pBench  = &Bench;
+    Run.pCase   = &Empty;
+    Run.Measure = 1;
+    s_StackBase = RunCase(&Run);
+
+#ifdef USE_STACK_ALGORITHM
+    printf("engine: stack, perf counters: ");
+#else
+    printf("engine: recursive, perf counters: ");
+#endif
+    printf("%s\n", (Run.Misses < 0) ? "not available" : "available");
+    printf("%-10s %10s %-16s %9s %10s %10s %10s\n",
+           "shape", "nodes", "case", "ns/node", "miss/node", "stack", "heap");
+
+    srand(1);
+    for(Shape = 0; Shape < SHAPE_NUM; Shape++)
+    {
+        for(Count = BENCH_MIN_COUNT; Count <= Max; Count *= 10)
+        {
+            Bench.Shape  = (BenchShape_t)Shape;
+            Bench.Count  = Count;
+            Bench.Expect = (unsigned long)Count * (unsigned long)(Count - 1) / 2;
+            ShapeMake(&Bench);
+            BenchTree(&Bench);
+        }
+    }
+
+    free(Bench.ppDyn);
+    free(Bench.pValues);
+    free(Bench.pNodes);
+    free(Bench.ppKey);
+    free(Bench.pRank);
+    free(Bench.pLink);
+    munmap(Bench.ppWork, Bench.WorkSize);
+    munmap(s_pStack, BENCH_STACK_SIZE);
+
+    return (0);
+}
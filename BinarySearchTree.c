@@ -0,0 +1,1125 @@
+//******************************************************************************
+//!
+//! \file    BinarySearchTree.c
+//! \brief   Binary Search Tree Implement
+//!          Ordered insert/find/erase API built on \ref TreeNode_t, the order of
+//!          nodes is defined by user's compare function.
+//!          Red-black tree API keep the tree balanced, the height of a tree with n
+//!          nodes is O(log n).
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#include "BinarySearchTree.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef   USE_TREE_STATS
+#include "BinaryTreeStats.h"
+#endif
+
+//**************************************************************************************
+//!                     ASSERT MACRO
+//**************************************************************************************
+#ifndef ASSERT
+
+#ifdef  NDEBUG
+#define ASSERT(x)
+#else
+#define ASSERT(x) do {while(!(x));} while(0)
+#endif
+
+#endif  // ASSERT
+
+//! \internal
+//! \brief Update cached fields from pNode up to root after relinking.
+#ifdef USE_NODE_AUGMENT
+#define BST_AUGMENT_UPDATE(pNode)   Tree_NodeAugmentUpdate(pNode)
+#else
+#define BST_AUGMENT_UPDATE(pNode)   ((void)(pNode))
+#endif
+
+//! \internal
+//! \brief Count nodes passed by a descent, and account it when the descent ends.
+#ifdef USE_TREE_STATS
+#define BST_DEPTH_STEP(Depth)       ((Depth)++)
+#define BST_DEPTH_DONE(Depth)       Tree_StatsDescent(Depth)
+#else
+#define BST_DEPTH_STEP(Depth)       ((void)0)
+#define BST_DEPTH_DONE(Depth)       ((void)(Depth))
+#endif
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Set link to child node, and update parent pointer of child.
+//!
+//! \param  [in] ppLink is the address of link.
+//! \param  [in] pChild is the new child node, it can be NULL.
+//! \param  [in] pParent is the owner of link, NULL if ppLink is the root pointer.
+//
+//****************************************************************************************
+static void BstLinkSet(TreeNode_t** ppLink, TreeNode_t* pChild, TreeNode_t* pParent)
+{
+    *ppLink = pChild;
+
+#ifdef USE_PARENT_POINTER
+    if(NULL != pChild)
+    {
+        TREE_PARENT_SET(pChild, pParent);
+    }
+#else
+    (void)pParent;
+#endif
+}
+
+//****************************************************************************************
+//! \brief  Insert node into binary search tree.
+//! The data of new node is used as its key, the new node is appended as a leaf node
+//! by \ref Tree_NodeAppend.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated if tree is empty.
+//! \param  [in] pNewNode is the node that want to insert, it must not be in a tree.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_NODE_EXIST if a node
+//!         with the same key is existing.
+//****************************************************************************************
+TreeErrorCode_t Tree_BstInsert(TreeNode_t** ppRoot, TreeNode_t* pNewNode, TreeCompareFun_t pCmp, void* Ctx)
+{
+    TreeNode_t* pNode = NULL;
+    int         Ret   = 0;
+    int         Depth = 0;
+
+    //! Check input parameters
+    if(NULL == ppRoot || NULL == pNewNode || NULL == pCmp)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! Empty tree, new node become root.
+    pNode = *ppRoot;
+    if(NULL == pNode)
+    {
+        BstLinkSet(ppRoot, pNewNode, NULL);
+        return (ERR_SUCCESS);
+    }
+
+    //! Go down to the leaf position of new key.
+    for(;;)
+    {
+        BST_DEPTH_STEP(Depth);
+        Ret = pCmp(Ctx, pNewNode->data, pNode->data);
+        if(0 == Ret)
+        {
+            BST_DEPTH_DONE(Depth);
+            return (ERR_NODE_EXIST);
+        }
+
+        if(Ret < 0)
+        {
+            if(NULL == pNode->left)
+            {
+                BST_DEPTH_DONE(Depth);
+                return Tree_NodeAppend(pNode, pNewNode, INSERT_POS_LEFT);
+            }
+            pNode = pNode->left;
+        }
+        else
+        {
+            if(NULL == pNode->right)
+            {
+                BST_DEPTH_DONE(Depth);
+                return Tree_NodeAppend(pNode, pNewNode, INSERT_POS_RIGHT);
+            }
+            pNode = pNode->right;
+        }
+    }
+}
+
+//****************************************************************************************
+//! \brief  Find node in binary search tree.
+//!
+//! \param  [in] pRoot is the root of tree.
+//! \param  [in] Key is the key that want to find, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the node whose data is equal to Key, or NULL if not found.
+//!
+//! \note   O(height), no recursion.
+//****************************************************************************************
+TreeNode_t* Tree_BstFind(TreeNode_t* pRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx)
+{
+    int Ret   = 0;
+    int Depth = 0;
+
+    //! Check input parameters
+    if(NULL == pCmp)
+    {
+        return (NULL);
+    }
+
+    while(NULL != pRoot)
+    {
+        BST_DEPTH_STEP(Depth);
+        Ret = pCmp(Ctx, Key, pRoot->data);
+        if(0 == Ret)
+        {
+            BST_DEPTH_DONE(Depth);
+            return (pRoot);
+        }
+
+        pRoot = (Ret < 0) ? pRoot->left : pRoot->right;
+    }
+
+    BST_DEPTH_DONE(Depth);
+    return (NULL);
+}
+
+//****************************************************************************************
+//! \brief  Find the first node which is not less than Key.
+//!
+//! \param  [in] pRoot is the root of tree.
+//! \param  [in] Key is the key that want to find, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the smallest node whose data is greater than or equal to Key, or NULL if
+//!         all nodes are less than Key.
+//!
+//! \note   O(height), no recursion.
+//****************************************************************************************
+TreeNode_t* Tree_BstLowerBound(TreeNode_t* pRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx)
+{
+    TreeNode_t* pBound = NULL;
+    int         Depth  = 0;
+
+    //! Check input parameters
+    if(NULL == pCmp)
+    {
+        return (NULL);
+    }
+
+    while(NULL != pRoot)
+    {
+        BST_DEPTH_STEP(Depth);
+        if(pCmp(Ctx, Key, pRoot->data) <= 0)
+        {
+            //! Node is not less than Key, a smaller one may be in left subtree.
+            pBound = pRoot;
+            pRoot  = pRoot->left;
+        }
+        else
+        {
+            pRoot  = pRoot->right;
+        }
+    }
+
+    BST_DEPTH_DONE(Depth);
+    return (pBound);
+}
+
+//! \internal
+//! \brief Fetch user data of node in its own step ? Only pays when prefetch is real,
+//!        inline data is in the node itself.
+#if defined(USE_PREFETCH) && !defined(USE_INLINE_DATA)
+#define BST_DATA_STEP
+#endif
+
+//! \internal
+//! \brief One descent of \ref Tree_BstFindBatch.
+typedef struct BstLane
+{
+    TreeNode_t* pNode;     //!< Current node, it has been prefetched.
+    int         Index;     //!< Index of key, -1 if lane is idle.
+    int         Depth;     //!< Nodes passed, for <USE_TREE_STATS>.
+#ifdef BST_DATA_STEP
+    int         Ready;     //!< User data of current node has been prefetched.
+#endif
+}BstLane_t;
+
+//****************************************************************************************
+//! \brief  Find a batch of keys in binary search tree.
+//! Descents of several keys are stepped in round-robin, one node each time, and the
+//! next node of every descent is prefetched before the other descents are stepped, so
+//! cache misses of independent keys are overlapped instead of waited one by one.
+//!
+//! \param  [in]  pRoot is the root of tree.
+//! \param  [in]  ppKey is the array of keys, every key is passed to pCmp.
+//! \param  [out] ppNode is the array of results, ppNode[i] is the node whose data is
+//!               equal to ppKey[i], or NULL if not found.
+//! \param  [in]  Count is the number of keys.
+//! \param  [in]  pCmp is the user's compare function.
+//! \param  [in]  Ctx is context environment, just for compare function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Count is
+//!         negative.
+//!
+//! \note
+//!         -# Results are the same as \ref Tree_BstFind of every key, but pCmp is
+//!            called in interleaved order of keys.
+//!         -# <TREE_BST_BATCH_WIDTH> descents are in flight, no memory is allocated.
+//!         -# Prefetch needs <USE_PREFETCH> macro. Without <USE_INLINE_DATA>, user
+//!            data of the next node is prefetched in one more step.
+//!         -# It pays off for trees much bigger than cache, a small tree is found
+//!            faster by \ref Tree_BstFind.
+//****************************************************************************************
+TreeErrorCode_t Tree_BstFindBatch(TreeNode_t* pRoot, void** ppKey, TreeNode_t** ppNode, int Count,
+                                  TreeCompareFun_t pCmp, void* Ctx)
+{
+    BstLane_t   Lane[TREE_BST_BATCH_WIDTH];
+    BstLane_t*  pLane  = NULL;
+    TreeNode_t* pNode  = NULL;
+    int         Width  = 0;
+    int         Active = 0;
+    int         Next   = 0;
+    int         Ret    = 0;
+    int         i      = 0;
+
+    //! Check input parameters
+    if(NULL == ppKey || NULL == ppNode || NULL == pCmp)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(Count < 0)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    //! Every lane starts a descent from root.
+    Width = (Count < TREE_BST_BATCH_WIDTH) ? Count : TREE_BST_BATCH_WIDTH;
+    for(i = 0; i < Width; i++)
+    {
+        Lane[i].pNode = pRoot;
+        Lane[i].Index = Next++;
+        Lane[i].Depth = 0;
+#ifdef BST_DATA_STEP
+        Lane[i].Ready = 0;
+#endif
+    }
+
+    Active = Width;
+    while(0 != Active)
+    {
+        for(i = 0; i < Width; i++)
+        {
+            pLane = &Lane[i];
+            if(pLane->Index < 0)
+            {
+                continue;
+            }
+
+            pNode = pLane->pNode;
+            if(NULL != pNode)
+            {
+#ifdef BST_DATA_STEP
+                //! Node is loaded now, load its data while the other lanes are stepped.
+                if(!pLane->Ready)
+                {
+                    TREE_PREFETCH(pNode->data);
+                    pLane->Ready = 1;
+                    continue;
+                }
+                pLane->Ready = 0;
+#endif
+                BST_DEPTH_STEP(pLane->Depth);
+                Ret = pCmp(Ctx, ppKey[pLane->Index], pNode->data);
+                if(0 != Ret)
+                {
+                    pNode = (Ret < 0) ? pNode->left : pNode->right;
+                    if(NULL != pNode)
+                    {
+                        //! Step down, the node is loaded while the other lanes are stepped.
+                        TREE_PREFETCH(pNode);
+                        pLane->pNode = pNode;
+                        continue;
+                    }
+                }
+            }
+
+            //! Descent is finished, pNode is the node found or NULL.
+            ppNode[pLane->Index] = pNode;
+            BST_DEPTH_DONE(pLane->Depth);
+
+            //! Start the next key in this lane, or make it idle.
+            if(Next < Count)
+            {
+                pLane->pNode = pRoot;
+                pLane->Index = Next++;
+                pLane->Depth = 0;
+            }
+            else
+            {
+                pLane->Index = -1;
+                Active--;
+            }
+        }
+    }
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Erase node from binary search tree by the link to it.
+//! A node with two children is replaced by its in-order successor.
+//!
+//! \param  [in] ppLink is the address of link to the node, it is the root pointer or
+//!              the left/right field of pParent.
+//! \param  [in] pParent is the owner of link, NULL if ppLink is the root pointer.
+//!
+//! \retval the erased node, or NULL if link is empty. Its links are cleared and its
+//!         data is kept, caller can release it by \ref Tree_NodeDestory,
+//!         \ref Tree_PoolFree or reuse it.
+//!
+//! \note   Caller find the link by itself, so nothing is compared, see
+//!         \ref Tree_BstErase.
+//****************************************************************************************
+TreeNode_t* Tree_BstLinkErase(TreeNode_t** ppLink, TreeNode_t* pParent)
+{
+    TreeNode_t** ppSucc  = NULL;
+    TreeNode_t*  pNode   = NULL;
+    TreeNode_t*  pSucc   = NULL;
+    TreeNode_t*  pLowest = NULL;   //!< Lowest node whose children are changed.
+
+    //! Check input parameters
+    if(NULL == ppLink || NULL == (pNode = *ppLink))
+    {
+        return (NULL);
+    }
+
+    pLowest = pParent;
+    if(NULL == pNode->left)
+    {
+        BstLinkSet(ppLink, pNode->right, pParent);
+    }
+    else if(NULL == pNode->right)
+    {
+        BstLinkSet(ppLink, pNode->left, pParent);
+    }
+    else
+    {
+        //! Find successor, the most left node of right subtree.
+        TreeNode_t* pSuccParent = pNode;
+
+        ppSucc = &pNode->right;
+        while(NULL != (*ppSucc)->left)
+        {
+            pSuccParent = *ppSucc;
+            ppSucc      = &pSuccParent->left;
+        }
+        pSucc = *ppSucc;
+
+        //! Splice successor out, its right subtree take its place.
+        BstLinkSet(ppSucc, pSucc->right, pSuccParent);
+
+        //! Successor take the place of node.
+        BstLinkSet(&pSucc->left,  pNode->left,  pSucc);
+        BstLinkSet(&pSucc->right, pNode->right, pSucc);
+        BstLinkSet(ppLink, pSucc, pParent);
+        pLowest = (pSuccParent == pNode) ? pSucc : pSuccParent;
+    }
+    BST_AUGMENT_UPDATE(pLowest);
+
+    //! Clear links of erased node, data is kept for caller.
+    pNode->left   = NULL;
+    pNode->right  = NULL;
+#ifdef USE_PARENT_POINTER
+    pNode->parent = NULL;
+#endif
+#ifdef USE_NODE_AUGMENT
+    pNode->height = 1;
+    pNode->size   = 1;
+#endif
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//! \brief  Erase node from binary search tree.
+//! The node is found by pCmp, then it is erased by \ref Tree_BstLinkErase.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated if root is erased.
+//! \param  [in] Key is the key that want to erase, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the erased node, or NULL if not found. Its links are cleared and its data
+//!         is kept, caller can release it by \ref Tree_NodeDestory, \ref Tree_PoolFree
+//!         or reuse it.
+//!
+//! \note   O(height), no recursion, parent pointer is not required.
+//****************************************************************************************
+TreeNode_t* Tree_BstErase(TreeNode_t** ppRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx)
+{
+    TreeNode_t** ppLink  = ppRoot;
+    TreeNode_t*  pNode   = NULL;
+    TreeNode_t*  pParent = NULL;
+    int          Ret     = 0;
+    int          Depth   = 0;
+
+    //! Check input parameters
+    if(NULL == ppRoot || NULL == pCmp)
+    {
+        return (NULL);
+    }
+
+    //! Find node and the link to it.
+    while(NULL != (pNode = *ppLink))
+    {
+        BST_DEPTH_STEP(Depth);
+        Ret = pCmp(Ctx, Key, pNode->data);
+        if(0 == Ret)
+        {
+            break;
+        }
+
+        pParent = pNode;
+        ppLink  = (Ret < 0) ? &pNode->left : &pNode->right;
+    }
+
+    BST_DEPTH_DONE(Depth);
+    return Tree_BstLinkErase(ppLink, pParent);
+}
+
+//****************************************************************************************
+//!                     EYTZINGER INDEX
+//****************************************************************************************
+
+//! \internal
+//! \brief Entries 4 levels below entry k start at 16k, they are prefetched while the 4
+//!        levels between are searched. Only entries inside the array are prefetched.
+#define EYTZ_PREFETCH_STEP     ((size_t)16)
+
+//! \internal
+//! \brief The most left entry of Eytzinger array of Size entries, 0 if it's empty.
+#define EYTZ_FIRST(Size)       EytzLeftMost(((Size) > 0) ? 1 : 0, (Size))
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Go to the most left entry of subtree Pos.
+//
+//****************************************************************************************
+static int EytzLeftMost(int Pos, int Size)
+{
+    //! Pos <= Size / 2 is 2 * Pos <= Size without overflow.
+    while(Pos > 0 && Pos <= Size / 2)
+    {
+        Pos = 2 * Pos;
+    }
+
+    return (Pos);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the next entry of in-order sequence, 0 after the last one.
+//
+//****************************************************************************************
+static int EytzNext(int Pos, int Size)
+{
+    //! Pos <= (Size - 1) / 2 is 2 * Pos + 1 <= Size without overflow.
+    if(Size > 0 && Pos <= (Size - 1) / 2)
+    {
+        return (EytzLeftMost(2 * Pos + 1, Size));
+    }
+
+    //! Go up while Pos is a right child, then the parent is the next one.
+    while(Pos & 1)
+    {
+        Pos >>= 1;
+    }
+
+    return (Pos >> 1);
+}
+
+//****************************************************************************************
+//! \brief  Build Eytzinger index from binary search tree.
+//! Nodes are read by in-order iterator, and their keys are written to the Eytzinger
+//! position of the same rank, so the index of n keys is built in O(n).
+//!
+//! \param  [in] pIdx is the index.
+//! \param  [in] pKeyBuf is the key buffer, it has Size + 1 entries.
+//! \param  [in] ppNodeBuf is the node buffer, it has Size + 1 entries.
+//! \param  [in] Size is the max number of keys.
+//! \param  [in] pRoot is the root of tree, frozen tree is the typical one.
+//! \param  [in] pKey is the user's key function.
+//! \param  [in] Ctx is context environment, just for key function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if input
+//!         parameters contain invalid pointer, \ref ERR_MEM if tree has more than Size
+//!         nodes or the depth of tree is more than <TREE_ITER_DEPTH> (without parent
+//!         pointer only).
+//!
+//! \note   The index does not follow later change of tree, build it again.
+//****************************************************************************************
+TreeErrorCode_t Tree_EytzBuild(TreeEytz_t* pIdx, TreeKey_t* pKeyBuf, TreeNode_t** ppNodeBuf, int Size,
+                               TreeNode_t* pRoot, TreeKeyFun_t pKey, void* Ctx)
+{
+    TreeIter_t  Iter;
+    TreeNode_t* pNode = NULL;
+    int         Count = 0;
+    int         Pos   = 0;
+
+    //! Check input parameters
+    if(NULL == pIdx || NULL == pKeyBuf || NULL == ppNodeBuf || NULL == pKey)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    Count = (NULL == pRoot) ? 0 : Tree_SizeGet(pRoot);
+    if(Count > Size)
+    {
+        return (ERR_MEM);
+    }
+
+    pIdx->pKey   = pKeyBuf;
+    pIdx->ppNode = ppNodeBuf;
+    pIdx->Size   = Count;
+
+    //! The first in-order position is the most left entry.
+    Pos = EYTZ_FIRST(Count);
+    for(pNode = Tree_IterFirst(&Iter, pRoot, TREE_ITER_IN_ORDER); NULL != pNode;
+        pNode = Tree_IterNext(&Iter))
+    {
+        pKeyBuf[Pos]   = pKey(Ctx, pNode->data);
+        ppNodeBuf[Pos] = pNode;
+        Pos            = EytzNext(Pos, Count);
+    }
+
+    return (TREE_ITER_OVERFLOW(&Iter) ? ERR_MEM : ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Find the first key which is not less than Key.
+//!
+//! \param  [in] pIdx is the index.
+//! \param  [in] Key is the key that want to find.
+//!
+//! \retval the position of the smallest key greater than or equal to Key, 0 if all
+//!         keys are less than Key. pIdx->pKey[Pos] and pIdx->ppNode[Pos] are the key
+//!         and the node.
+//!
+//! \note   O(log n), the compare result is not a branch, the only branches are the loop
+//!         condition and the bound of prefetch, both are well predicted.
+//****************************************************************************************
+int Tree_EytzLowerBound(TreeEytz_t* pIdx, TreeKey_t Key)
+{
+    const TreeKey_t* pKey = NULL;
+    size_t           Size = 0;
+    size_t           Pos  = 1;
+
+    //! Check input parameter
+    ASSERT(NULL != pIdx);
+    pKey = pIdx->pKey;
+    Size = (size_t)pIdx->Size;
+
+    //! Go right when key is less than Key, the compare result is the next bit of path.
+    //! Pos is size_t, it goes up to 2 * Size + 1 at last.
+    while(Pos <= Size)
+    {
+        if(EYTZ_PREFETCH_STEP * Pos <= Size)
+        {
+            TREE_PREFETCH(pKey + EYTZ_PREFETCH_STEP * Pos);
+        }
+        Pos = 2 * Pos + (size_t)(pKey[Pos] < Key);
+    }
+
+    //! Drop the right turns after the last left turn, the node of left turn is found.
+    while(Pos & 1)
+    {
+        Pos >>= 1;
+    }
+
+    return ((int)(Pos >> 1));
+}
+
+//****************************************************************************************
+//! \brief  Find node by key in Eytzinger index.
+//!
+//! \param  [in] pIdx is the index.
+//! \param  [in] Key is the key that want to find.
+//!
+//! \retval the first node whose key is equal to Key, or NULL if not found.
+//!
+//! \note   O(log n), see \ref Tree_EytzLowerBound.
+//****************************************************************************************
+TreeNode_t* Tree_EytzFind(TreeEytz_t* pIdx, TreeKey_t Key)
+{
+    int Pos = Tree_EytzLowerBound(pIdx, Key);
+
+    if(0 == Pos || pIdx->pKey[Pos] != Key)
+    {
+        return (NULL);
+    }
+
+    return (pIdx->ppNode[Pos]);
+}
+
+#ifdef USE_PARENT_POINTER
+//****************************************************************************************
+//!                     RED-BLACK TREE
+//****************************************************************************************
+
+//! \internal
+//! \brief Node colour, stored in the tag bit of parent pointer.
+#define RB_RED                 ((uintptr_t)0x00)
+#define RB_BLACK               ((uintptr_t)0x01)
+
+//! \internal
+//! \brief Get/Set node colour, NULL node is black.
+#define RB_COLOR(pNode)        ((uintptr_t)(pNode)->parent & TREE_PARENT_TAG_MASK)
+#define RB_IS_RED(pNode)       (NULL != (pNode) && RB_RED == RB_COLOR(pNode))
+#define RB_IS_BLACK(pNode)     (!RB_IS_RED(pNode))
+#define RB_COLOR_SET(pNode, Color)                                                    \
+    ((pNode)->parent = (TreeNode_t*)((uintptr_t)TREE_PARENT(pNode) | (Color)))
+#define RB_RED_SET(pNode)      RB_COLOR_SET(pNode, RB_RED)
+#define RB_BLACK_SET(pNode)    RB_COLOR_SET(pNode, RB_BLACK)
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Replace child link of parent.
+//!
+//! \param  [in] ppRoot is the address of root pointer.
+//! \param  [in] pParent is the parent node, NULL if pOld is root.
+//! \param  [in] pOld is the old child node.
+//! \param  [in] pNew is the new child node.
+//
+//****************************************************************************************
+static void RbChildReplace(TreeNode_t** ppRoot, TreeNode_t* pParent, TreeNode_t* pOld,
+                           TreeNode_t* pNew)
+{
+    if(NULL == pParent)
+    {
+        *ppRoot = pNew;
+    }
+    else if(pParent->left == pOld)
+    {
+        pParent->left = pNew;
+    }
+    else
+    {
+        pParent->right = pNew;
+    }
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Rotate left, the right child of pNode take its place.
+//
+//****************************************************************************************
+static void RbRotateLeft(TreeNode_t** ppRoot, TreeNode_t* pNode)
+{
+    TreeNode_t* pChild = pNode->right;
+
+    pNode->right = pChild->left;
+    if(NULL != pChild->left)
+    {
+        TREE_PARENT_SET(pChild->left, pNode);
+    }
+
+    TREE_PARENT_SET(pChild, TREE_PARENT(pNode));
+    RbChildReplace(ppRoot, TREE_PARENT(pNode), pNode, pChild);
+
+    pChild->left = pNode;
+    TREE_PARENT_SET(pNode, pChild);
+
+    //! Height of subtree may change, so all ancestors are updated.
+    BST_AUGMENT_UPDATE(pNode);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Rotate right, the left child of pNode take its place.
+//
+//****************************************************************************************
+static void RbRotateRight(TreeNode_t** ppRoot, TreeNode_t* pNode)
+{
+    TreeNode_t* pChild = pNode->left;
+
+    pNode->left = pChild->right;
+    if(NULL != pChild->right)
+    {
+        TREE_PARENT_SET(pChild->right, pNode);
+    }
+
+    TREE_PARENT_SET(pChild, TREE_PARENT(pNode));
+    RbChildReplace(ppRoot, TREE_PARENT(pNode), pNode, pChild);
+
+    pChild->right = pNode;
+    TREE_PARENT_SET(pNode, pChild);
+
+    //! Height of subtree may change, so all ancestors are updated.
+    BST_AUGMENT_UPDATE(pNode);
+}
+
+//****************************************************************************************
+//! \brief  Rebalance red-black tree after a new node is linked as a leaf.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated when root changed.
+//! \param  [in] pNode is the new leaf node, it is linked by \ref Tree_NodeAppend or
+//!              it is the only node of tree, so its colour is red.
+//!
+//! \retval \ref ERR_SUCCESS if rebalance successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!
+//! \note
+//!         -# Caller find the leaf position by itself, so nothing is compared, see
+//!            \ref Tree_RbInsert.
+//!         -# MUST keep <USE_PARENT_POINTER> macro in order to use this function.
+//****************************************************************************************
+TreeErrorCode_t Tree_RbInsertFixup(TreeNode_t** ppRoot, TreeNode_t* pNode)
+{
+    TreeNode_t* pParent = NULL;
+    TreeNode_t* pGrand  = NULL;
+    TreeNode_t* pUncle  = NULL;
+
+    //! Check input parameters
+    if(NULL == ppRoot || NULL == pNode || NULL == *ppRoot)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! Fix red-red violation from bottom to top.
+    while(NULL != (pParent = TREE_PARENT(pNode)) && RB_IS_RED(pParent))
+    {
+        //! Red node is never the root, so grandparent is existing.
+        pGrand = TREE_PARENT(pParent);
+
+        if(pParent == pGrand->left)
+        {
+            pUncle = pGrand->right;
+            if(RB_IS_RED(pUncle))
+            {
+                RB_BLACK_SET(pParent);
+                RB_BLACK_SET(pUncle);
+                RB_RED_SET(pGrand);
+                pNode = pGrand;
+                continue;
+            }
+
+            if(pNode == pParent->right)
+            {
+                RbRotateLeft(ppRoot, pParent);
+                pNode   = pParent;
+                pParent = TREE_PARENT(pNode);
+            }
+
+            RB_BLACK_SET(pParent);
+            RB_RED_SET(pGrand);
+            RbRotateRight(ppRoot, pGrand);
+        }
+        else
+        {
+            pUncle = pGrand->left;
+            if(RB_IS_RED(pUncle))
+            {
+                RB_BLACK_SET(pParent);
+                RB_BLACK_SET(pUncle);
+                RB_RED_SET(pGrand);
+                pNode = pGrand;
+                continue;
+            }
+
+            if(pNode == pParent->left)
+            {
+                RbRotateRight(ppRoot, pParent);
+                pNode   = pParent;
+                pParent = TREE_PARENT(pNode);
+            }
+
+            RB_BLACK_SET(pParent);
+            RB_RED_SET(pGrand);
+            RbRotateLeft(ppRoot, pGrand);
+        }
+    }
+
+    RB_BLACK_SET(*ppRoot);
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Insert node into red-black tree.
+//! The node is inserted like \ref Tree_BstInsert, then the tree is rebalanced by
+//! \ref Tree_RbInsertFixup, so the height of tree is never greater than 2*log2(n+1).
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated when root changed.
+//! \param  [in] pNewNode is the node that want to insert, it must not be in a tree.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_NODE_EXIST if a node
+//!         with the same key is existing.
+//!
+//! \note
+//!         -# Node colour is stored in parent pointer, see \ref TREE_PARENT.
+//!         -# \ref Tree_BstFind and \ref Tree_BstLowerBound can be used on red-black
+//!            tree, but \ref Tree_BstInsert and \ref Tree_BstErase can not.
+//!         -# MUST keep <USE_PARENT_POINTER> macro in order to use this function.
+//****************************************************************************************
+TreeErrorCode_t Tree_RbInsert(TreeNode_t** ppRoot, TreeNode_t* pNewNode, TreeCompareFun_t pCmp, void* Ctx)
+{
+    TreeErrorCode_t ErrCode = ERR_FAILURE;
+
+    //! Insert as a red leaf node.
+    ErrCode = Tree_BstInsert(ppRoot, pNewNode, pCmp, Ctx);
+    if(ERR_SUCCESS != ErrCode)
+    {
+        return (ErrCode);
+    }
+
+    return Tree_RbInsertFixup(ppRoot, pNewNode);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Fix black height after a black node is removed.
+//!
+//! \param  [in] ppRoot is the address of root pointer.
+//! \param  [in] pNode is the node that take the place of removed node, it can be NULL.
+//! \param  [in] pParent is the parent of pNode.
+//
+//****************************************************************************************
+static void RbEraseFixup(TreeNode_t** ppRoot, TreeNode_t* pNode, TreeNode_t* pParent)
+{
+    TreeNode_t* pSibling = NULL;
+
+    while(pNode != *ppRoot && RB_IS_BLACK(pNode))
+    {
+        //! pNode is one black short, so its sibling is existing.
+        if(pNode == pParent->left)
+        {
+            pSibling = pParent->right;
+            if(RB_IS_RED(pSibling))
+            {
+                RB_BLACK_SET(pSibling);
+                RB_RED_SET(pParent);
+                RbRotateLeft(ppRoot, pParent);
+                pSibling = pParent->right;
+            }
+
+            if(RB_IS_BLACK(pSibling->left) && RB_IS_BLACK(pSibling->right))
+            {
+                RB_RED_SET(pSibling);
+                pNode   = pParent;
+                pParent = TREE_PARENT(pNode);
+                continue;
+            }
+
+            if(RB_IS_BLACK(pSibling->right))
+            {
+                RB_BLACK_SET(pSibling->left);
+                RB_RED_SET(pSibling);
+                RbRotateRight(ppRoot, pSibling);
+                pSibling = pParent->right;
+            }
+
+            RB_COLOR_SET(pSibling, RB_COLOR(pParent));
+            RB_BLACK_SET(pParent);
+            RB_BLACK_SET(pSibling->right);
+            RbRotateLeft(ppRoot, pParent);
+        }
+        else
+        {
+            pSibling = pParent->left;
+            if(RB_IS_RED(pSibling))
+            {
+                RB_BLACK_SET(pSibling);
+                RB_RED_SET(pParent);
+                RbRotateRight(ppRoot, pParent);
+                pSibling = pParent->left;
+            }
+
+            if(RB_IS_BLACK(pSibling->left) && RB_IS_BLACK(pSibling->right))
+            {
+                RB_RED_SET(pSibling);
+                pNode   = pParent;
+                pParent = TREE_PARENT(pNode);
+                continue;
+            }
+
+            if(RB_IS_BLACK(pSibling->left))
+            {
+                RB_BLACK_SET(pSibling->right);
+                RB_RED_SET(pSibling);
+                RbRotateLeft(ppRoot, pSibling);
+                pSibling = pParent->left;
+            }
+
+            RB_COLOR_SET(pSibling, RB_COLOR(pParent));
+            RB_BLACK_SET(pParent);
+            RB_BLACK_SET(pSibling->left);
+            RbRotateRight(ppRoot, pParent);
+        }
+
+        pNode = *ppRoot;
+    }
+
+    if(NULL != pNode)
+    {
+        RB_BLACK_SET(pNode);
+    }
+}
+
+//****************************************************************************************
+//! \brief  Erase a node that is in red-black tree.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated when root changed.
+//! \param  [in] pNode is the node that want to erase, it MUST be in the tree.
+//!
+//! \retval \ref ERR_SUCCESS if erase successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!
+//! \note
+//!         -# Links of erased node are cleared and its data is kept, see
+//!            \ref Tree_RbErase.
+//!         -# Caller find the node by itself, so nothing is compared.
+//!         -# MUST keep <USE_PARENT_POINTER> macro in order to use this function.
+//****************************************************************************************
+TreeErrorCode_t Tree_RbNodeErase(TreeNode_t** ppRoot, TreeNode_t* pNode)
+{
+    TreeNode_t* pRemove = NULL;   //!< Node that really removed from its position.
+    TreeNode_t* pChild  = NULL;   //!< Child that take the place of pRemove.
+    TreeNode_t* pParent = NULL;   //!< Parent of pChild.
+    uintptr_t   Color   = RB_RED;
+
+    //! Check input parameters
+    if(NULL == ppRoot || NULL == pNode)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! A node with two children is replaced by its successor.
+    pRemove = pNode;
+    if(NULL != pNode->left && NULL != pNode->right)
+    {
+        pRemove = pNode->right;
+        while(NULL != pRemove->left)
+        {
+            pRemove = pRemove->left;
+        }
+    }
+
+    //! Splice pRemove out, it has one child at most.
+    pChild  = (NULL != pRemove->left) ? pRemove->left : pRemove->right;
+    pParent = TREE_PARENT(pRemove);
+    Color   = RB_COLOR(pRemove);
+    if(NULL != pChild)
+    {
+        TREE_PARENT_SET(pChild, pParent);
+    }
+    RbChildReplace(ppRoot, pParent, pRemove, pChild);
+
+    //! Successor take the place and colour of node.
+    if(pRemove != pNode)
+    {
+        if(pParent == pNode)
+        {
+            pParent = pRemove;
+        }
+
+        pRemove->left  = pNode->left;
+        pRemove->right = pNode->right;
+        pRemove->parent = pNode->parent;
+        if(NULL != pRemove->left)
+        {
+            TREE_PARENT_SET(pRemove->left, pRemove);
+        }
+        if(NULL != pRemove->right)
+        {
+            TREE_PARENT_SET(pRemove->right, pRemove);
+        }
+        RbChildReplace(ppRoot, TREE_PARENT(pNode), pNode, pRemove);
+    }
+
+    BST_AUGMENT_UPDATE(pParent);
+
+    if(RB_BLACK == Color)
+    {
+        RbEraseFixup(ppRoot, pChild, pParent);
+    }
+
+    //! Clear links of erased node, data is kept for caller.
+    pNode->left   = NULL;
+    pNode->right  = NULL;
+    pNode->parent = NULL;
+#ifdef USE_NODE_AUGMENT
+    pNode->height = 1;
+    pNode->size   = 1;
+#endif
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Erase node from red-black tree.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated when root changed.
+//! \param  [in] Key is the key that want to erase, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the erased node, or NULL if not found. Its links are cleared and its data
+//!         is kept, caller can release it by \ref Tree_NodeDestory, \ref Tree_PoolFree
+//!         or reuse it.
+//!
+//! \note   MUST keep <USE_PARENT_POINTER> macro in order to use this function.
+//****************************************************************************************
+TreeNode_t* Tree_RbErase(TreeNode_t** ppRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx)
+{
+    TreeNode_t* pNode = NULL;   //!< Node that want to erase.
+
+    //! Check input parameters
+    if(NULL == ppRoot)
+    {
+        return (NULL);
+    }
+
+    pNode = Tree_BstFind(*ppRoot, Key, pCmp, Ctx);
+    if(NULL == pNode)
+    {
+        return (NULL);
+    }
+
+    Tree_RbNodeErase(ppRoot, pNode);
+
+    return (pNode);
+}
+#endif // USE_PARENT_POINTER
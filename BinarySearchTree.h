@@ -0,0 +1,340 @@
+//****************************************************************************************
+//!
+//! \file    BinarySearchTree.h
+//! \brief   Binary Search Tree Interface.
+//!          Ordered insert/find/erase API built on \ref TreeNode_t, the order of
+//!          nodes is defined by user's compare function.
+//!          Red-black tree API keep the tree balanced, the height of a tree with n
+//!          nodes is O(log n).
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#ifndef __BINARYSEARCHTREE_H__
+#define __BINARYSEARCHTREE_H__
+
+#include "BinaryTree.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//****************************************************************************************
+//!                           CONFIGURE MACRO
+//****************************************************************************************
+
+//! Key type of \ref TreeEytz_t, it MUST be an integer or floating type.
+//!
+//! \note Default: long.
+#ifndef TREE_KEY_TYPE
+#define TREE_KEY_TYPE          long
+#endif
+
+//! Number of descents in flight of \ref Tree_BstFindBatch.
+//! Every descent waits for its next node while the others are stepped, so up to
+//! <TREE_BST_BATCH_WIDTH> cache misses are overlapped. Lanes are located in the stack of
+//! calling thread.
+//!
+//! \note Default: 16 descents, about the number of outstanding misses of a core.
+#ifndef TREE_BST_BATCH_WIDTH
+#define TREE_BST_BATCH_WIDTH   16
+#endif
+
+//****************************************************************************************
+//!                           PUBLIC DATA INTERFACE
+//****************************************************************************************
+
+//! Key of \ref TreeEytz_t.
+typedef TREE_KEY_TYPE TreeKey_t;
+
+//****************************************************************************************
+//! \brief Key function of \ref Tree_EytzBuild.
+//!
+//! \param  [in] Context is the user's context.
+//! \param  [in] Data is the data of node, same as \ref TreeCallBackFun_t.
+//! \retval the key of data, keys MUST be ascending in in-order sequence of tree.
+//****************************************************************************************
+typedef TreeKey_t (*TreeKeyFun_t)(void* Context, void* Data);
+
+//****************************************************************************************
+//! \brief Implicit search index in Eytzinger order.
+//! Keys are stored in an array as a complete tree without links, the children of
+//! entry k are entry 2k and 2k+1, entry 0 is not used. Search descends without branch,
+//! and the entries 4 levels below are in one cache line, so they are prefetched when
+//! <USE_PREFETCH> is selected.
+//****************************************************************************************
+typedef struct TreeEytz
+{
+    TreeKey_t*   pKey;      //!< Keys, Size + 1 entries.
+    TreeNode_t** ppNode;    //!< Node of every key, Size + 1 entries.
+    int          Size;      //!< Number of keys.
+}TreeEytz_t;
+
+//****************************************************************************************
+//!                           PUBLIC API
+//****************************************************************************************
+
+//****************************************************************************************
+//! \brief  Insert node into binary search tree.
+//! The data of new node is used as its key, the new node is appended as a leaf node
+//! by \ref Tree_NodeAppend.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated if tree is empty.
+//! \param  [in] pNewNode is the node that want to insert, it must not be in a tree.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_NODE_EXIST if a node
+//!         with the same key is existing.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_BstInsert(TreeNode_t** ppRoot, TreeNode_t* pNewNode, TreeCompareFun_t pCmp, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Find node in binary search tree.
+//!
+//! \param  [in] pRoot is the root of tree.
+//! \param  [in] Key is the key that want to find, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the node whose data is equal to Key, or NULL if not found.
+//!
+//! \note   O(height), no recursion.
+//****************************************************************************************
+extern TreeNode_t* Tree_BstFind(TreeNode_t* pRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Find the first node which is not less than Key.
+//!
+//! \param  [in] pRoot is the root of tree.
+//! \param  [in] Key is the key that want to find, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the smallest node whose data is greater than or equal to Key, or NULL if
+//!         all nodes are less than Key.
+//!
+//! \note   O(height), no recursion.
+//****************************************************************************************
+extern TreeNode_t* Tree_BstLowerBound(TreeNode_t* pRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Find a batch of keys in binary search tree.
+//! Descents of several keys are stepped in round-robin, one node each time, and the
+//! next node of every descent is prefetched before the other descents are stepped, so
+//! cache misses of independent keys are overlapped instead of waited one by one.
+//!
+//! \param  [in]  pRoot is the root of tree.
+//! \param  [in]  ppKey is the array of keys, every key is passed to pCmp.
+//! \param  [out] ppNode is the array of results, ppNode[i] is the node whose data is
+//!               equal to ppKey[i], or NULL if not found.
+//! \param  [in]  Count is the number of keys.
+//! \param  [in]  pCmp is the user's compare function.
+//! \param  [in]  Ctx is context environment, just for compare function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Count is
+//!         negative.
+//!
+//! \note
+//!         -# Results are the same as \ref Tree_BstFind of every key, but pCmp is
+//!            called in interleaved order of keys.
+//!         -# <TREE_BST_BATCH_WIDTH> descents are in flight, no memory is allocated.
+//!         -# Prefetch needs <USE_PREFETCH> macro. Without <USE_INLINE_DATA>, user
+//!            data of the next node is prefetched in one more step.
+//!         -# It pays off for trees much bigger than cache, a small tree is found
+//!            faster by \ref Tree_BstFind.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_BstFindBatch(TreeNode_t* pRoot, void** ppKey, TreeNode_t** ppNode, int Count,
+                                         TreeCompareFun_t pCmp, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Erase node from binary search tree by the link to it.
+//! A node with two children is replaced by its in-order successor.
+//!
+//! \param  [in] ppLink is the address of link to the node, it is the root pointer or
+//!              the left/right field of pParent.
+//! \param  [in] pParent is the owner of link, NULL if ppLink is the root pointer.
+//!
+//! \retval the erased node, or NULL if link is empty. Its links are cleared and its
+//!         data is kept, caller can release it by \ref Tree_NodeDestory,
+//!         \ref Tree_PoolFree or reuse it.
+//!
+//! \note   Caller find the link by itself, so nothing is compared, see
+//!         \ref Tree_BstErase.
+//****************************************************************************************
+extern TreeNode_t* Tree_BstLinkErase(TreeNode_t** ppLink, TreeNode_t* pParent);
+
+//****************************************************************************************
+//! \brief  Erase node from binary search tree.
+//! The node is found by pCmp, then it is erased by \ref Tree_BstLinkErase.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated if root is erased.
+//! \param  [in] Key is the key that want to erase, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the erased node, or NULL if not found. Its links are cleared and its data
+//!         is kept, caller can release it by \ref Tree_NodeDestory, \ref Tree_PoolFree
+//!         or reuse it.
+//!
+//! \note   O(height), no recursion, parent pointer is not required.
+//****************************************************************************************
+extern TreeNode_t* Tree_BstErase(TreeNode_t** ppRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Build Eytzinger index from binary search tree.
+//! Nodes are read by in-order iterator, and their keys are written to the Eytzinger
+//! position of the same rank, so the index of n keys is built in O(n).
+//!
+//! \param  [in] pIdx is the index.
+//! \param  [in] pKeyBuf is the key buffer, it has Size + 1 entries.
+//! \param  [in] ppNodeBuf is the node buffer, it has Size + 1 entries.
+//! \param  [in] Size is the max number of keys.
+//! \param  [in] pRoot is the root of tree, frozen tree is the typical one.
+//! \param  [in] pKey is the user's key function.
+//! \param  [in] Ctx is context environment, just for key function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if input
+//!         parameters contain invalid pointer, \ref ERR_MEM if tree has more than Size
+//!         nodes or the depth of tree is more than <TREE_ITER_DEPTH> (without parent
+//!         pointer only).
+//!
+//! \note   The index does not follow later change of tree, build it again.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_EytzBuild(TreeEytz_t* pIdx, TreeKey_t* pKeyBuf, TreeNode_t** ppNodeBuf, int Size,
+                                      TreeNode_t* pRoot, TreeKeyFun_t pKey, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Find the first key which is not less than Key.
+//!
+//! \param  [in] pIdx is the index.
+//! \param  [in] Key is the key that want to find.
+//!
+//! \retval the position of the smallest key greater than or equal to Key, 0 if all
+//!         keys are less than Key. pIdx->pKey[Pos] and pIdx->ppNode[Pos] are the key
+//!         and the node.
+//!
+//! \note   O(log n), the compare result is not a branch, the only branches are the loop
+//!         condition and the bound of prefetch, both are well predicted.
+//****************************************************************************************
+extern int Tree_EytzLowerBound(TreeEytz_t* pIdx, TreeKey_t Key);
+
+//****************************************************************************************
+//! \brief  Find node by key in Eytzinger index.
+//!
+//! \param  [in] pIdx is the index.
+//! \param  [in] Key is the key that want to find.
+//!
+//! \retval the first node whose key is equal to Key, or NULL if not found.
+//!
+//! \note   O(log n), see \ref Tree_EytzLowerBound.
+//****************************************************************************************
+extern TreeNode_t* Tree_EytzFind(TreeEytz_t* pIdx, TreeKey_t Key);
+
+#ifdef USE_PARENT_POINTER
+//****************************************************************************************
+//! \brief  Rebalance red-black tree after a new node is linked as a leaf.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated when root changed.
+//! \param  [in] pNode is the new leaf node, it is linked by \ref Tree_NodeAppend or
+//!              it is the only node of tree, so its colour is red.
+//!
+//! \retval \ref ERR_SUCCESS if rebalance successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!
+//! \note
+//!         -# Caller find the leaf position by itself, so nothing is compared, see
+//!            \ref Tree_RbInsert.
+//!         -# MUST keep <USE_PARENT_POINTER> macro in order to use this function.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_RbInsertFixup(TreeNode_t** ppRoot, TreeNode_t* pNode);
+
+//****************************************************************************************
+//! \brief  Insert node into red-black tree.
+//! The node is inserted like \ref Tree_BstInsert, then the tree is rebalanced by
+//! \ref Tree_RbInsertFixup, so the height of tree is never greater than 2*log2(n+1).
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated when root changed.
+//! \param  [in] pNewNode is the node that want to insert, it must not be in a tree.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_NODE_EXIST if a node
+//!         with the same key is existing.
+//!
+//! \note
+//!         -# Node colour is stored in parent pointer, see \ref TREE_PARENT.
+//!         -# \ref Tree_BstFind and \ref Tree_BstLowerBound can be used on red-black
+//!            tree, but \ref Tree_BstInsert and \ref Tree_BstErase can not.
+//!         -# MUST keep <USE_PARENT_POINTER> macro in order to use this function.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_RbInsert(TreeNode_t** ppRoot, TreeNode_t* pNewNode, TreeCompareFun_t pCmp, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Erase a node that is in red-black tree.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated when root changed.
+//! \param  [in] pNode is the node that want to erase, it MUST be in the tree.
+//!
+//! \retval \ref ERR_SUCCESS if erase successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!
+//! \note
+//!         -# Links of erased node are cleared and its data is kept, see
+//!            \ref Tree_RbErase.
+//!         -# Caller find the node by itself, so nothing is compared.
+//!         -# MUST keep <USE_PARENT_POINTER> macro in order to use this function.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_RbNodeErase(TreeNode_t** ppRoot, TreeNode_t* pNode);
+
+//****************************************************************************************
+//! \brief  Erase node from red-black tree.
+//!
+//! \param  [in] ppRoot is the address of root pointer, it is updated when root changed.
+//! \param  [in] Key is the key that want to erase, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the erased node, or NULL if not found. Its links are cleared and its data
+//!         is kept, caller can release it by \ref Tree_NodeDestory, \ref Tree_PoolFree
+//!         or reuse it.
+//!
+//! \note   MUST keep <USE_PARENT_POINTER> macro in order to use this function.
+//****************************************************************************************
+extern TreeNode_t* Tree_RbErase(TreeNode_t** ppRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx);
+#endif // USE_PARENT_POINTER
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BINARYSEARCHTREE_H__
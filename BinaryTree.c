@@ -8,13 +8,13 @@
 //! \author  cedar
 //! \date    2013-11-26
 //! \email   xuesong5825718@gmail.com
-//! \note    Only recursive algorithm is supported in current version.
+//! \note    Both recursive and stack algorithm are supported, see
+//!          <USE_RECURSIVE_ALGORITHM> and <USE_STACK_ALGORITHM>.
 //! 
 //! \bug    
 //!          -# Destory/Delete API can not set node pointer to NULL.
 //! 
 //! \todo
-//!          -# Implement Stack Algorithm.
 //!          -# Add Usage Example
 //!
 //! \license
@@ -42,16 +42,43 @@
 //******************************************************************************
 
 #include "BinaryTree.h"
+#include <stddef.h>
 
 #ifdef   USE_DYNAMIC_MEMORY
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#endif
+
+#ifdef   USE_NODE_CACHE
+#include "BinaryTreeMT.h"
+#endif
+
+#if defined(USE_INLINE_DATA) && !defined(USE_DYNAMIC_MEMORY)
+#include <string.h>
+#endif
+
+#ifdef   USE_TREE_STATS
+#include "BinaryTreeStats.h"
 #endif
 
 //! \internal
 //! \brief The mask of append mode parameters.
 #define INSERT_MODE_MASK         (INSERT_POS_LEFT  | INSERT_POS_RIGHT)
 
+#ifdef USE_DYNAMIC_MEMORY
+//! \internal
+//! \brief Allocate/free one node of dynamic API.
+#ifdef USE_NODE_CACHE
+#define NODE_ALLOC()             Tree_NodeCacheAlloc()
+#define NODE_FREE(pNode)         Tree_NodeCacheFree(pNode)
+#else
+#define NODE_ALLOC()             ((TreeNode_t *)malloc(sizeof(TreeNode_t)))
+#define NODE_FREE(pNode)         free(pNode)
+#endif
+#endif // USE_DYNAMIC_MEMORY
+
 //**************************************************************************************
 //!                     ASSERT MACRO
 //**************************************************************************************
@@ -65,455 +92,3977 @@
 
 #endif  // ASSERT
 
+#ifdef USE_NODE_AUGMENT
+//! \internal
+//! \brief Get cached height/size of subtree, NULL subtree is empty.
+#define NODE_HEIGHT(pNode)     ((NULL != (pNode)) ? (pNode)->height : 0)
+#define NODE_SIZE(pNode)       ((NULL != (pNode)) ? (pNode)->size   : 0)
+#endif // USE_NODE_AUGMENT
+
+//**************************************************************************************
+//!                     STATISTICS MACRO
+//**************************************************************************************
+
+#ifdef USE_TREE_STATS
+//! \internal
+//! \brief Add Value to a counter of the block bound to calling thread.
+#define STATS_ADD(Field, Value)                                                       \
+    do                                                                                \
+    {                                                                                 \
+        TreeStats_t* pStats_ = g_pTreeStats;                                          \
+        if(NULL != pStats_)                                                           \
+        {                                                                             \
+            TREE_STATS_STORE(pStats_->Field, pStats_->Field + (Value));               \
+        }                                                                             \
+    } while(0)
+
+//! \internal
+//! \brief Declare start time of a timed call, it is 0 if no block is bound.
+#define STATS_TIMER(Start)     uint64_t Start = (NULL != g_pTreeStats) ? Tree_StatsClock() : 0
+
+//! \internal
+//! \brief Record latency of a timed call into histogram Hist of the bound block.
+#define STATS_END(Hist, Start)                                                        \
+    do                                                                                \
+    {                                                                                 \
+        if(0 != (Start) && NULL != g_pTreeStats)                                      \
+        {                                                                             \
+            Tree_StatsLatency(&g_pTreeStats->Hist, Start);                            \
+        }                                                                             \
+    } while(0)
+
+//! \internal
+//! \brief Account the work depth reached by a traverse call, see \ref Tree_StatsTravese.
+#define STATS_DEPTH(Depth)     Tree_StatsTravese(Depth)
+
+//! \internal
+//! \brief Count levels of recursion in a walk context with Depth and DepthMax fields.
+#define STATS_DEPTH_INIT(pWalk)  ((pWalk)->Depth = 0, (pWalk)->DepthMax = 0)
+#define STATS_DEPTH_ENTER(pWalk)                                                      \
+    do                                                                                \
+    {                                                                                 \
+        if(++(pWalk)->Depth > (pWalk)->DepthMax)                                      \
+        {                                                                             \
+            (pWalk)->DepthMax = (pWalk)->Depth;                                       \
+        }                                                                             \
+    } while(0)
+#define STATS_DEPTH_LEAVE(pWalk) ((pWalk)->Depth--)
+#else
+#define STATS_ADD(Field, Value)  ((void)0)
+#define STATS_TIMER(Start)
+#define STATS_END(Hist, Start)   ((void)0)
+#define STATS_DEPTH(Depth)       ((void)0)
+#define STATS_DEPTH_INIT(pWalk)  ((void)0)
+#define STATS_DEPTH_ENTER(pWalk) ((void)0)
+#define STATS_DEPTH_LEAVE(pWalk) ((void)0)
+#endif // USE_TREE_STATS
+
+//**************************************************************************************
+//!                     PREFETCH MACRO
+//**************************************************************************************
+
+//! \internal
+//! \brief Prefetch node, NULL is skipped because prefetch of an unmapped address may
+//!        cost a page walk.
+#define NODE_PREFETCH(pNode)                                                          \
+    do                                                                                \
+    {                                                                                 \
+        if(NULL != (pNode))                                                           \
+        {                                                                             \
+            TREE_PREFETCH(pNode);                                                     \
+        }                                                                             \
+    } while(0)
+
+//! \internal
+//! \brief Prefetch user data of node, inline data is in the node itself.
+#ifdef USE_INLINE_DATA
+#define DATA_PREFETCH(pNode)   ((void)0)
+#else
+#define DATA_PREFETCH(pNode)   NODE_PREFETCH((pNode)->data)
+#endif
+
+#ifdef USE_STACK_ALGORITHM
+//**************************************************************************************
+//!                     WORK STACK MACRO
+//**************************************************************************************
+
+//! \internal
+//! \brief Push node into work stack, return \ref ERR_MEM from caller if stack is full
+//!        and can not grow.
+#define STACK_PUSH(pStack, pNode)                                                     \
+    do                                                                                \
+    {                                                                                 \
+        if((pStack)->Top >= (pStack)->Size && ERR_SUCCESS != STACK_GROW(pStack))      \
+        {                                                                             \
+            return (ERR_MEM);                                                         \
+        }                                                                             \
+        (pStack)->pBase[(pStack)->Top++] = (pNode);                                   \
+        STACK_PEAK(pStack);                                                           \
+    } while(0)
+
+//! \internal
+//! \brief Empty work stack before a traverse, the peak is counted from here.
+#ifdef USE_TREE_STATS
+#define STACK_CLEAR(pStack)    ((pStack)->Top = 0, (pStack)->Peak = 0)
+#define STACK_PEAK(pStack)                                                            \
+    do                                                                                \
+    {                                                                                 \
+        if((pStack)->Top > (pStack)->Peak)                                            \
+        {                                                                             \
+            (pStack)->Peak = (pStack)->Top;                                           \
+        }                                                                             \
+    } while(0)
+#else
+#define STACK_CLEAR(pStack)    ((pStack)->Top = 0)
+#define STACK_PEAK(pStack)     ((void)0)
+#endif // USE_TREE_STATS
+
 #ifdef USE_DYNAMIC_MEMORY
+//! \internal
+//! \brief Grow state of work stack, see Grow field of \ref TreeStack_t.
+#define STACK_GROW_NONE        0    //!< User's buffer, never grow.
+#define STACK_GROW_AUTO        1    //!< Default buffer on call stack, it may grow.
+#define STACK_GROW_HEAP        2    //!< Buffer on heap, it is owned by the stack.
+
+#define STACK_GROW(pStack)     StackGrow(pStack)
+
 //****************************************************************************************
 //
-//! \brief  Create tree node in dynamic method.
-//! \retval the address of new node or NULL if memory allocate failure.
+//! \internal
+//! \brief  Double the buffer of default work stack on heap.
 //!
-//! \note   
-//!         -# Please check the valid of return address.
-//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
-//!         -# Dynamic API can not be used mix with static API.
+//! \param  [in] pStack is the work stack, it is full.
+//! \retval \ref ERR_SUCCESS if stack is grown, \ref ERR_MEM if it's user's stack or
+//!         memory allocate failure.
 //
 //****************************************************************************************
-TreeNode_t* Tree_NodeCreate(void)
+static TreeErrorCode_t StackGrow(TreeStack_t* pStack)
 {
-    //! Allocate memory for tree node.
-    TreeNode_t* pNode = (TreeNode_t *)malloc(sizeof(TreeNode_t));
-    if(NULL == pNode)
+    TreeNode_t** pBuf = NULL;
+    int          Size = 0;
+
+    if(STACK_GROW_NONE == pStack->Grow || pStack->Size > INT_MAX / 2)
     {
-        return (NULL);
+        return (ERR_MEM);
     }
 
-    //! Initialize the node field.
-    Tree_NodeInit(pNode);
+    Size = (0 != pStack->Size) ? 2 * pStack->Size : TREE_STACK_DEPTH;
+    if(STACK_GROW_HEAP == pStack->Grow)
+    {
+        pBuf = (TreeNode_t**)realloc(pStack->pBase, (size_t)Size * sizeof(TreeNode_t*));
+    }
+    else
+    {
+        pBuf = (TreeNode_t**)malloc((size_t)Size * sizeof(TreeNode_t*));
+        if(NULL != pBuf)
+        {
+            memcpy(pBuf, pStack->pBase, (size_t)pStack->Top * sizeof(TreeNode_t*));
+        }
+    }
 
-    return (pNode);
+    if(NULL == pBuf)
+    {
+        return (ERR_MEM);
+    }
+
+    pStack->pBase = pBuf;
+    pStack->Size  = Size;
+    pStack->Grow  = STACK_GROW_HEAP;
+
+    return (ERR_SUCCESS);
+}
+
+//! \internal
+//! \brief Init default work stack, it starts with pBuf of <TREE_STACK_DEPTH> entries.
+static void StackDefaultInit(TreeStack_t* pStack, TreeNode_t** pBuf)
+{
+    Tree_StackInit(pStack, pBuf, TREE_STACK_DEPTH);
+    pStack->Grow = STACK_GROW_AUTO;
+}
+
+//! \internal
+//! \brief Release heap buffer of default work stack.
+static void StackDefaultRelease(TreeStack_t* pStack)
+{
+    if(STACK_GROW_HEAP == pStack->Grow)
+    {
+        free(pStack->pBase);
+    }
 }
+#else
+#define STACK_GROW(pStack)     (ERR_MEM)
+
+#define StackDefaultInit(pStack, pBuf)    Tree_StackInit(pStack, pBuf, TREE_STACK_DEPTH)
+#define StackDefaultRelease(pStack)       ((void)(pStack))
+#endif // USE_DYNAMIC_MEMORY
+
+//! \internal
+//! \brief Functions without work stack parameter follow parent pointer instead, when the
+//!        default stack can not grow.
+#if !defined(USE_DYNAMIC_MEMORY) && defined(USE_PARENT_POINTER) && !defined(USE_PERSISTENT_NODE)
+#define STACK_PARENT_WALK
+#endif
+
+//! \internal
+//! \brief Pop node from work stack, stack MUST not be empty.
+#define STACK_POP(pStack)      ((pStack)->pBase[--(pStack)->Top])
+
+//! \internal
+//! \brief Get top node of work stack, stack MUST not be empty.
+#define STACK_PEEK(pStack)     ((pStack)->pBase[(pStack)->Top - 1])
+#endif // USE_STACK_ALGORITHM
+
+//**************************************************************************************
+//!                     WORK QUEUE MACRO
+//**************************************************************************************
+
+//! \internal
+//! \brief Put node at the tail of work queue, return \ref ERR_MEM from caller if queue
+//!        is full and can not grow.
+#define QUEUE_PUT(pQueue, pNode)                                                      \
+    do                                                                                \
+    {                                                                                 \
+        int Tail_;                                                                    \
+        if((pQueue)->Count >= (pQueue)->Size && ERR_SUCCESS != QUEUE_GROW(pQueue))    \
+        {                                                                             \
+            return (ERR_MEM);                                                         \
+        }                                                                             \
+        Tail_ = (pQueue)->Head + (pQueue)->Count++;                                   \
+        if(Tail_ >= (pQueue)->Size)                                                   \
+        {                                                                             \
+            Tail_ -= (pQueue)->Size;                                                  \
+        }                                                                             \
+        (pQueue)->pBase[Tail_] = (pNode);                                             \
+    } while(0)
+
+//! \internal
+//! \brief Get node from the head of work queue, queue MUST not be empty.
+#define QUEUE_GET(pQueue, pNode)                                                      \
+    do                                                                                \
+    {                                                                                 \
+        (pNode) = (pQueue)->pBase[(pQueue)->Head++];                                  \
+        if((pQueue)->Head >= (pQueue)->Size)                                          \
+        {                                                                             \
+            (pQueue)->Head = 0;                                                       \
+        }                                                                             \
+        (pQueue)->Count--;                                                            \
+    } while(0)
+
+#ifdef USE_DYNAMIC_MEMORY
+//! \internal
+//! \brief Grow state of work queue, see Grow field of \ref TreeQueue_t.
+#define QUEUE_GROW_NONE        0    //!< User's buffer, never grow.
+#define QUEUE_GROW_AUTO        1    //!< Default buffer on call stack, it may grow.
+#define QUEUE_GROW_HEAP        2    //!< Buffer on heap, it is owned by the queue.
+
+#define QUEUE_GROW(pQueue)     QueueGrow(pQueue)
 
 //****************************************************************************************
 //
-//! \brief  Destory tree node in dynamic method.
-//!
-//! \param  [in] ppNode is the address of tree node pointer.
-//! \retval \ref ERR_FAILURE if successed, otherwise return \ref ERR_SUCCESS.
+//! \internal
+//! \brief  Double the buffer of default work queue on heap.
+//! Entries are copied in queue order, so the ring starts at index 0 of new buffer.
 //!
-//! \note   
-//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
-//!         -# Dynamic API can not be used mix with static API.
+//! \param  [in] pQueue is the work queue, it is full.
+//! \retval \ref ERR_SUCCESS if queue is grown, \ref ERR_MEM if it's user's queue or
+//!         memory allocate failure.
 //
 //****************************************************************************************
-TreeErrorCode_t Tree_NodeDestory(TreeNode_t **ppNode)
+static TreeErrorCode_t QueueGrow(TreeQueue_t* pQueue)
 {
-    TreeNode_t* pNode       = NULL;           //!< Pointer of Node
-    TreeErrorCode_t ErrCode = ERR_FAILURE;    //!< Error Code
+    TreeNode_t** pBuf  = NULL;
+    int          Size  = 0;
+    int          First = 0;
 
-    //! Check mode parameter.
-    ASSERT(NULL != ppNode);
+    if(QUEUE_GROW_NONE == pQueue->Grow || pQueue->Size > INT_MAX / 2)
+    {
+        return (ERR_MEM);
+    }
 
-    pNode   = *ppNode;
+    Size = (0 != pQueue->Size) ? 2 * pQueue->Size : TREE_QUEUE_SIZE;
+    pBuf = (TreeNode_t**)malloc((size_t)Size * sizeof(TreeNode_t*));
+    if(NULL == pBuf)
+    {
+        return (ERR_MEM);
+    }
 
-    //! Delete Tree Node
-    ErrCode = Tree_NodeDelete(pNode);
-    if(ERR_SUCCESS != ErrCode)
+    //! Entries from head to the end of buffer, then the wrapped ones.
+    First = pQueue->Size - pQueue->Head;
+    if(First > pQueue->Count)
     {
-        return (ErrCode);
+        First = pQueue->Count;
     }
+    memcpy(pBuf, pQueue->pBase + pQueue->Head, (size_t)First * sizeof(TreeNode_t*));
+    memcpy(pBuf + First, pQueue->pBase, (size_t)(pQueue->Count - First) * sizeof(TreeNode_t*));
 
-    //! Release Node From Tree Successfully, Now release node resource.
-    free(pNode);
-    *ppNode = NULL;
+    if(QUEUE_GROW_HEAP == pQueue->Grow)
+    {
+        free(pQueue->pBase);
+    }
+
+    pQueue->pBase = pBuf;
+    pQueue->Size  = Size;
+    pQueue->Head  = 0;
+    pQueue->Grow  = QUEUE_GROW_HEAP;
 
     return (ERR_SUCCESS);
 }
+#else
+#define QUEUE_GROW(pQueue)     (ERR_MEM)
 
 //****************************************************************************************
 //
-//! \brief  Destory subtree in dynamic method.
-//!
-//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
-//! \retval \ref ERR_FAILURE if successed, otherwise return \ref ERR_SUCCESS.
+//! \internal
+//! \brief  Check that work queue is big enough for level-order traversal of tree.
+//! The tree is walked once in level-order without callback.
 //!
-//! \note   
-//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
-//!         -# Dynamic API can not be used mix with static API.
+//! \param  [in] pNode is the root of tree, it MUST not be NULL.
+//! \param  [in] pQueue is the work queue, it is empty when returned.
+//! \retval \ref ERR_SUCCESS if queue is big enough, otherwise \ref ERR_MEM.
 //
-//****************************************************************************************  
-TreeErrorCode_t Tree_SubTreeDelete_Dynamic(TreeNode_t** ppNode)
+//****************************************************************************************
+static TreeErrorCode_t QueueFit(TreeNode_t* pNode, TreeQueue_t* pQueue)
 {
-    TreeNode_t * pNode = NULL;
+    pQueue->Head  = 0;
+    pQueue->Count = 0;
+    QUEUE_PUT(pQueue, pNode);
+    while(0 != pQueue->Count)
+    {
+        QUEUE_GET(pQueue, pNode);
 
-    //! Check input parameter
-    ASSERT(NULL != ppNode);
-    pNode = *ppNode;
+        if(NULL != pNode->left)
+        {
+            QUEUE_PUT(pQueue, pNode->left);
+        }
 
-    //! Check input parameter.
-    if(NULL == pNode)
-    {
-        return  ERR_FAILURE;
+        if(NULL != pNode->right)
+        {
+            QUEUE_PUT(pQueue, pNode->right);
+        }
     }
 
-    Tree_SubTreeDelete_Dynamic(&pNode->left);
-    Tree_SubTreeDelete_Dynamic(&pNode->right);
+    return (ERR_SUCCESS);
+}
+#endif // USE_DYNAMIC_MEMORY
 
-    //! \bug Can not set node value to NULL
-    Tree_NodeDestory(ppNode);
+#ifdef USE_PREFETCH
+//! \internal
+//! \brief Index of the entry which is Offset entries after the first one, Offset MUST
+//!        be less than the number of entries in use.
+static int QueueAhead(const TreeQueue_t* pQueue, int Offset)
+{
+    int Index = pQueue->Head + Offset;
 
-    return (ERR_SUCCESS);
+    return ((Index >= pQueue->Size) ? (Index - pQueue->Size) : Index);
 }
+#endif
 
-#endif // USE_DYNAMIC_MEMORY
+//****************************************************************************************
+//!                     SUBTREE RELEASE
+//****************************************************************************************
+
+//! \internal
+//! \brief Node release callback of \ref SubTreeRelease.
+typedef void (*NodeReleaseFun_t)(void* Context, TreeNode_t* pNode);
 
 //****************************************************************************************
 //
-//! \brief  Init existing tree node.
-//!
-//! \param  [in] pNode is the address of tree node.
-//! \retval the address of new node or NULL if memory allocate failure.
+//! \internal
+//! \brief  Release subtree without recursion and without work stack.
+//! The left child of current node is rotated up until current node has no left child,
+//! then current node is released and its right child becomes current node. Every
+//! rotation moves one node into the right spine, so the loop is O(n).
 //!
-//! \note   
-//!         -# You must create an tree node by hand before call this function.
-//!         -# Dynamic API can not be used mix with static API.
+//! \param  [in] pNode is the root of subtree, it MUST be unlinked from its parent.
+//! \param  [in] pRelease is called once for every node of subtree, it may overwrite
+//!              any field of the node.
+//! \param  [in] Ctx is the context of pRelease.
 //
 //****************************************************************************************
-void Tree_NodeInit(TreeNode_t* pNode)
+static void SubTreeRelease(TreeNode_t* pNode, NodeReleaseFun_t pRelease, void* Ctx)
 {
-    //! Check input parameter
-    ASSERT(NULL != pNode);
+    TreeNode_t* pChild = NULL;
 
-    pNode->parent = NULL;   //!< Init parent pointer field.
-    pNode->left   = NULL;   //!< Init left child pointer field.
-    pNode->right  = NULL;   //!< Init right child pointer field.
-    pNode->data   = NULL;   //!< Init data pointer field.
+    while(NULL != pNode)
+    {
+        if(NULL != pNode->left)
+        {
+            //! Rotate right.
+            pChild        = pNode->left;
+            pNode->left   = pChild->right;
+            pChild->right = pNode;
+            pNode         = pChild;
+        }
+        else
+        {
+            pChild = pNode->right;
+            pRelease(Ctx, pNode);
+            pNode  = pChild;
+        }
+    }
 }
 
 //****************************************************************************************
 //
-//! \brief  Destory tree node in static method.
+//! \internal
+//! \brief  Break the link between node and its parent.
 //!
 //! \param  [in] pNode is the address of tree node.
-//! \retval \ref ERR_FAILURE if successed, otherwise return \ref ERR_SUCCESS.
+//
+//****************************************************************************************
+#ifdef USE_PARENT_POINTER
+static void NodeUnlink(TreeNode_t* pNode)
+{
+    TreeNode_t * pParent = TREE_PARENT(pNode);
+
+    if(NULL != pParent)
+    {
+        //! Update parent's child pointer.
+        if(pParent->left == pNode)
+        {
+            pParent->left = NULL;
+        }
+
+        if(pParent->right == pNode)
+        {
+            pParent->right = NULL;
+        }
+
+        //! Node becomes the root of a detached subtree.
+        pNode->parent = NULL;
+#ifdef USE_NODE_AUGMENT
+        Tree_NodeAugmentUpdate(pParent);
+#endif
+    }
+}
+#else
+//! Without parent pointer, the link is cleared by caller through the address of it.
+#define NodeUnlink(pNode)
+#endif // USE_PARENT_POINTER
+
+#ifdef USE_PARENT_POINTER
+//****************************************************************************************
+//!                     PARENT POINTER WALKER
+//****************************************************************************************
+
+//! \internal
+//! \brief Get the first node of subtree in pre-order.
+#define PreOrderFirst(pRoot)   (pRoot)
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the next node in pre-order.
 //!
-//! \note   
-//!         -# Dynamic API can not be used mix with static API.
+//! \param  [in] pNode is current node.
+//! \param  [in] pRoot is the root of subtree, walker never go above it.
+//! \retval next node, or NULL if pNode is the last one.
 //
-//**************************************************************************************** 
-TreeErrorCode_t Tree_NodeDelete(TreeNode_t* pNode)
+//****************************************************************************************
+static TreeNode_t* PreOrderNext(TreeNode_t* pNode, TreeNode_t* pRoot)
 {
-    //! Check input parameter
-    ASSERT(NULL != pNode);
+    TreeNode_t* pParent = NULL;
 
-    //! Check left/right child node, This function only delete leaf node.
-    if(NULL != pNode->left || NULL != pNode->right)
+    if(NULL != pNode->left)
     {
-        return (ERR_FAILURE);
+        return (pNode->left);
+    }
+
+    if(NULL != pNode->right)
+    {
+        return (pNode->right);
+    }
+
+    //! Go back until we come from a left child which has right sibling.
+    while(pNode != pRoot)
+    {
+        pParent = TREE_PARENT(pNode);
+        if(pParent->left == pNode && NULL != pParent->right)
+        {
+            return (pParent->right);
+        }
+        pNode = pParent;
     }
 
-    //! If node has parent node, then break the link between them.
-    if(NULL != pNode->parent)
-    {
-        TreeNode_t * pParent = pNode->parent;
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the first node of subtree in in-order.
+//!
+//! \param  [in] pRoot is the root of subtree.
+//! \retval the most left node of subtree.
+//
+//****************************************************************************************
+static TreeNode_t* InOrderFirst(TreeNode_t* pRoot)
+{
+    while(NULL != pRoot->left)
+    {
+        pRoot = pRoot->left;
+    }
+
+    return (pRoot);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the next node in in-order.
+//!
+//! \param  [in] pNode is current node.
+//! \param  [in] pRoot is the root of subtree, walker never go above it.
+//! \retval next node, or NULL if pNode is the last one.
+//
+//****************************************************************************************
+static TreeNode_t* InOrderNext(TreeNode_t* pNode, TreeNode_t* pRoot)
+{
+    TreeNode_t* pParent = NULL;
+
+    if(NULL != pNode->right)
+    {
+        return InOrderFirst(pNode->right);
+    }
+
+    //! Go back until we come from a left child.
+    while(pNode != pRoot)
+    {
+        pParent = TREE_PARENT(pNode);
+        if(pParent->left == pNode)
+        {
+            return (pParent);
+        }
+        pNode = pParent;
+    }
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the first node of subtree in post-order.
+//!
+//! \param  [in] pRoot is the root of subtree.
+//! \retval the first leaf reached by going left whenever possible.
+//
+//****************************************************************************************
+static TreeNode_t* PostOrderFirst(TreeNode_t* pRoot)
+{
+    for(;;)
+    {
+        if(NULL != pRoot->left)
+        {
+            pRoot = pRoot->left;
+        }
+        else if(NULL != pRoot->right)
+        {
+            pRoot = pRoot->right;
+        }
+        else
+        {
+            return (pRoot);
+        }
+    }
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the next node in post-order.
+//!
+//! \param  [in] pNode is current node.
+//! \param  [in] pRoot is the root of subtree, walker never go above it.
+//! \retval next node, or NULL if pNode is the last one.
+//
+//****************************************************************************************
+static TreeNode_t* PostOrderNext(TreeNode_t* pNode, TreeNode_t* pRoot)
+{
+    TreeNode_t* pParent = NULL;
+
+    if(pNode == pRoot)
+    {
+        return (NULL);
+    }
+
+    //! Right sibling subtree is visited before parent.
+    pParent = TREE_PARENT(pNode);
+    if(pParent->left == pNode && NULL != pParent->right)
+    {
+        return PostOrderFirst(pParent->right);
+    }
+
+    return (pParent);
+}
+#endif // USE_PARENT_POINTER
+
+#ifndef USE_NODE_AUGMENT
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Count nodes and levels of subtree, without recursion and work stack.
+//! With parent pointer, it walks in pre-order and follows parent pointer to go back.
+//! Otherwise it walks in in-order by Morris threading: the empty right link of the
+//! in-order predecessor is pointed to current node before going left, and it is
+//! restored when the walk comes back through it, so the tree is unchanged at last.
+//!
+//! \param  [in]  pNode is the root of subtree, it can be NULL.
+//! \param  [out] pHeight is the number of levels of subtree.
+//! \retval the number of nodes of subtree.
+//
+//****************************************************************************************
+#if defined(USE_PARENT_POINTER) && !defined(USE_PERSISTENT_NODE)
+static int SubTreeMeasure(TreeNode_t* pNode, int* pHeight)
+{
+    TreeNode_t* pRoot   = pNode;
+    TreeNode_t* pParent = NULL;
+    int         Size    = 0;
+    int         Depth   = 1;
+    int         Height  = 0;
+
+    while(NULL != pNode)
+    {
+        Size++;
+        if(Depth > Height)
+        {
+            Height = Depth;
+        }
+
+        if(NULL != pNode->left || NULL != pNode->right)
+        {
+            pNode = (NULL != pNode->left) ? pNode->left : pNode->right;
+            Depth++;
+            continue;
+        }
+
+        //! Go back until we come from a left child which has right sibling.
+        for(;;)
+        {
+            if(pNode == pRoot)
+            {
+                pNode = NULL;
+                break;
+            }
+
+            pParent = TREE_PARENT(pNode);
+            if(pParent->left == pNode && NULL != pParent->right)
+            {
+                pNode = pParent->right;
+                break;
+            }
+            pNode = pParent;
+            Depth--;
+        }
+    }
+
+    *pHeight = Height;
+    return (Size);
+}
+#else
+static int SubTreeMeasure(TreeNode_t* pNode, int* pHeight)
+{
+    TreeNode_t* pPred  = NULL;
+    int         Size   = 0;
+    int         Depth  = 1;
+    int         Height = 0;
+    int         Steps  = 0;
+
+    while(NULL != pNode)
+    {
+        if(NULL == pNode->left)
+        {
+            //! Reached by a real link, a thread always points to a node which has left.
+            Size++;
+            if(Depth > Height)
+            {
+                Height = Depth;
+            }
+            pNode = pNode->right;
+            Depth++;
+            continue;
+        }
+
+        //! In-order predecessor is the most right node of left subtree.
+        pPred = pNode->left;
+        Steps = 0;
+        while(NULL != pPred->right && pNode != pPred->right)
+        {
+            pPred = pPred->right;
+            Steps++;
+        }
+
+        if(NULL == pPred->right)
+        {
+            //! First visit, make thread and go left.
+            if(Depth > Height)
+            {
+                Height = Depth;
+            }
+            pPred->right = pNode;
+            pNode        = pNode->left;
+            Depth++;
+        }
+        else
+        {
+            //! Come back by thread from pPred, which is (Steps + 1) levels below.
+            pPred->right = NULL;
+            Depth       -= Steps + 2;
+            Size++;
+            pNode        = pNode->right;
+            Depth++;
+        }
+    }
+
+    *pHeight = Height;
+    return (Size);
+}
+#endif
+#endif // USE_NODE_AUGMENT
+
+#ifdef USE_DYNAMIC_MEMORY
+//****************************************************************************************
+//
+//! \brief  Create tree node in dynamic method.
+//! \retval the address of new node or NULL if memory allocate failure.
+//!
+//! \note   
+//!         -# Please check the valid of return address.
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//!         -# Dynamic API can not be used mix with static API.
+//
+//****************************************************************************************
+TreeNode_t* Tree_NodeCreate(void)
+{
+    //! Allocate memory for tree node.
+    TreeNode_t* pNode = NODE_ALLOC();
+    if(NULL == pNode)
+    {
+        return (NULL);
+    }
+    STATS_ADD(Allocs, 1);
+
+    //! Initialize the node field.
+    Tree_NodeInit(pNode);
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//
+//! \brief  Destory tree node in dynamic method.
+//!
+//! \param  [in] ppNode is the address of tree node pointer.
+//! \retval \ref ERR_FAILURE if successed, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//!         -# Dynamic API can not be used mix with static API.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_NodeDestory(TreeNode_t **ppNode)
+{
+    TreeNode_t* pNode       = NULL;           //!< Pointer of Node
+    TreeErrorCode_t ErrCode = ERR_FAILURE;    //!< Error Code
+
+    //! Check mode parameter.
+    ASSERT(NULL != ppNode);
+
+    pNode   = *ppNode;
+
+    //! Remove Tree Node
+    ErrCode = Tree_NodeRemove(ppNode);
+    if(ERR_SUCCESS != ErrCode)
+    {
+        return (ErrCode);
+    }
+
+    //! Release Node From Tree Successfully, Now release node resource.
+    NODE_FREE(pNode);
+    STATS_ADD(Frees, 1);
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Destory subtree in dynamic method.
+//!
+//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
+//! \retval \ref ERR_FAILURE if successed, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//!         -# Dynamic API can not be used mix with static API.
+//
+//****************************************************************************************  
+#ifdef USE_RECURSIVE_ALGORITHM
+//! \internal
+//! \brief Release all node of a detached subtree, children first.
+static void SubTreeFree(TreeNode_t* pNode)
+{
+    if(NULL == pNode)
+    {
+        return;
+    }
+
+    SubTreeFree(pNode->left);
+    SubTreeFree(pNode->right);
+
+    //! \bug Can not set node value to NULL
+    NODE_FREE(pNode);
+    STATS_ADD(Frees, 1);
+}
+
+TreeErrorCode_t Tree_SubTreeDelete_Dynamic(TreeNode_t** ppNode)
+{
+    TreeNode_t * pNode = NULL;
+    STATS_TIMER(Start);
+
+    //! Check input parameter
+    ASSERT(NULL != ppNode);
+    pNode = *ppNode;
+
+    //! Check input parameter.
+    if(NULL == pNode)
+    {
+        return  ERR_FAILURE;
+    }
+
+    //! Detach subtree first, so the tree above is updated only once.
+    NodeUnlink(pNode);
+    *ppNode = NULL;
+
+    SubTreeFree(pNode);
+
+    STATS_END(Delete, Start);
+    return (ERR_SUCCESS);
+}
+#endif // USE_RECURSIVE_ALGORITHM
+
+#ifdef USE_STACK_ALGORITHM
+//! \internal
+//! \brief Release callback of \ref Tree_SubTreeDelete_Dynamic.
+static void NodeFree(void* Ctx, TreeNode_t* pNode)
+{
+    (void)Ctx;
+    NODE_FREE(pNode);
+    STATS_ADD(Frees, 1);
+}
+
+TreeErrorCode_t Tree_SubTreeDelete_Dynamic(TreeNode_t** ppNode)
+{
+    TreeNode_t * pNode = NULL;
+    STATS_TIMER(Start);
+
+    //! Check input parameter
+    ASSERT(NULL != ppNode);
+    pNode = *ppNode;
+
+    //! Check input parameter.
+    if(NULL == pNode)
+    {
+        return  ERR_FAILURE;
+    }
+
+    //! Detach subtree from tree, then release all node of it.
+    NodeUnlink(pNode);
+    SubTreeRelease(pNode, NodeFree, NULL);
+    *ppNode = NULL;
+
+    STATS_END(Delete, Start);
+    return (ERR_SUCCESS);
+}
+#endif // USE_STACK_ALGORITHM
+
+//****************************************************************************************
+//
+//! \brief  Create node arena in dynamic method.
+//! Arena control block and node buffer are allocated by one malloc call.
+//!
+//! \param  [in] Size is the number of nodes.
+//! \retval the address of new arena or NULL if memory allocate failure.
+//!
+//! \note   
+//!         -# Please check the valid of return address.
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//
+//****************************************************************************************
+TreeArena_t* Tree_ArenaCreate(int Size)
+{
+    TreeArena_t* pArena = NULL;
+
+    //! Check input parameter.
+    if(Size < 0)
+    {
+        return (NULL);
+    }
+
+    //! Allocate memory for arena and its nodes.
+    pArena = (TreeArena_t *)malloc(sizeof(TreeArena_t) + (size_t)Size * sizeof(TreeNode_t));
+    if(NULL == pArena)
+    {
+        return (NULL);
+    }
+
+    Tree_ArenaInit(pArena, (TreeNode_t *)(pArena + 1), Size);
+
+    return (pArena);
+}
+
+//****************************************************************************************
+//
+//! \brief  Destory node arena in dynamic method.
+//!
+//! \param  [in] ppArena is the address of arena pointer.
+//! \retval \ref ERR_FAILURE if *ppArena is NULL, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_ArenaDestory(TreeArena_t** ppArena)
+{
+    //! Check input parameter
+    ASSERT(NULL != ppArena);
+
+    if(NULL == *ppArena)
+    {
+        return (ERR_FAILURE);
+    }
+
+    free(*ppArena);
+    *ppArena = NULL;
+
+    return (ERR_SUCCESS);
+}
+
+#endif // USE_DYNAMIC_MEMORY
+
+//****************************************************************************************
+//
+//! \brief  Init existing tree node.
+//!
+//! \param  [in] pNode is the address of tree node.
+//! \retval the address of new node or NULL if memory allocate failure.
+//!
+//! \note   
+//!         -# You must create an tree node by hand before call this function.
+//!         -# Dynamic API can not be used mix with static API.
+//
+//****************************************************************************************
+void Tree_NodeInit(TreeNode_t* pNode)
+{
+    //! Check input parameter
+    ASSERT(NULL != pNode);
+
+#ifdef USE_PARENT_POINTER
+    pNode->parent = NULL;   //!< Init parent pointer field.
+#endif
+    pNode->left   = NULL;   //!< Init left child pointer field.
+    pNode->right  = NULL;   //!< Init right child pointer field.
+#ifdef USE_NODE_AUGMENT
+    pNode->height = 1;      //!< Init subtree height field.
+    pNode->size   = 1;      //!< Init subtree size field.
+#endif
+#ifdef USE_PERSISTENT_NODE
+    pNode->refs   = 1;      //!< Init reference count field, one for parent or root.
+#endif
+#ifdef USE_INLINE_DATA
+    memset(pNode->data, 0, TREE_DATA_SIZE);   //!< Init data field.
+#else
+    pNode->data   = NULL;   //!< Init data pointer field.
+#endif
+}
+
+//****************************************************************************************
+//
+//! \brief  Destory tree node in static method.
+//!
+//! \param  [in] pNode is the address of tree node.
+//! \retval \ref ERR_FAILURE if successed, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   
+//!         -# Dynamic API can not be used mix with static API.
+//
+//**************************************************************************************** 
+#ifdef USE_PARENT_POINTER
+TreeErrorCode_t Tree_NodeDelete(TreeNode_t* pNode)
+{
+    //! Check input parameter
+    ASSERT(NULL != pNode);
+
+    //! Check left/right child node, This function only delete leaf node.
+    if(NULL != pNode->left || NULL != pNode->right)
+    {
+        return (ERR_FAILURE);
+    }
+
+    //! If node has parent node, then break the link between them.
+    NodeUnlink(pNode);
+
+    //! Reset Node Field.
+    Tree_NodeInit(pNode);
+
+    return (ERR_SUCCESS);
+}
+#endif // USE_PARENT_POINTER
+
+//****************************************************************************************
+//
+//! \brief  Remove tree node by the address of its link.
+//!
+//! \param  [in] ppLink is the address of the link to the node, typical it's the address
+//!              of parent's left/right field, or of the root pointer.
+//! \retval \ref ERR_FAILURE if node is not a leaf node, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   
+//!         -# *ppLink is set to NULL, so this function works without parent pointer.
+//!         -# Dynamic API can not be used mix with static API.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_NodeRemove(TreeNode_t** ppLink)
+{
+    TreeNode_t* pNode = NULL;
+
+    //! Check input parameter
+    ASSERT(NULL != ppLink);
+    pNode = *ppLink;
+    ASSERT(NULL != pNode);
+
+    //! Check left/right child node, This function only delete leaf node.
+    if(NULL != pNode->left || NULL != pNode->right)
+    {
+        return (ERR_FAILURE);
+    }
+
+    //! Break the link between node and its parent.
+    NodeUnlink(pNode);
+    *ppLink = NULL;
+
+    //! Reset Node Field.
+    Tree_NodeInit(pNode);
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Destory subtree in static method.
+//!
+//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
+//! \retval \ref ERR_FAILURE if successed, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   
+//!         -# Dynamic API can not be used mix with static API.
+//
+//****************************************************************************************
+#ifdef USE_RECURSIVE_ALGORITHM
+//! \internal
+//! \brief Reset all node of a detached subtree, children first.
+static void SubTreeReset(TreeNode_t* pNode)
+{
+    if(NULL == pNode)
+    {
+        return;
+    }
+
+    SubTreeReset(pNode->left);
+    SubTreeReset(pNode->right);
+
+    Tree_NodeInit(pNode);
+}
+
+TreeErrorCode_t Tree_SubTreeDelete_Static(TreeNode_t** ppNode)
+{
+    TreeNode_t * pNode = NULL;
+    STATS_TIMER(Start);
+
+    //! Check input parameter
+    ASSERT(NULL != ppNode);
+    pNode = *ppNode;
+
+    //! Check input parameter.
+    if(NULL == pNode)
+    {
+        return  ERR_FAILURE;
+    }
+
+    //! Detach subtree first, so the tree above is updated only once.
+    NodeUnlink(pNode);
+    *ppNode = NULL;
+
+    SubTreeReset(pNode);
+
+    STATS_END(Delete, Start);
+    return (ERR_SUCCESS);
+}
+#endif // USE_RECURSIVE_ALGORITHM
+
+#ifdef USE_STACK_ALGORITHM
+//! \internal
+//! \brief Release callback of \ref Tree_SubTreeDelete_Static.
+static void NodeReset(void* Ctx, TreeNode_t* pNode)
+{
+    (void)Ctx;
+    Tree_NodeInit(pNode);
+}
+
+TreeErrorCode_t Tree_SubTreeDelete_Static(TreeNode_t** ppNode)
+{
+    TreeNode_t * pNode = NULL;
+    STATS_TIMER(Start);
+
+    //! Check input parameter
+    ASSERT(NULL != ppNode);
+    pNode = *ppNode;
+
+    //! Check input parameter.
+    if(NULL == pNode)
+    {
+        return  ERR_FAILURE;
+    }
+
+    //! Detach subtree from tree, then reset all node of it.
+    NodeUnlink(pNode);
+    SubTreeRelease(pNode, NodeReset, NULL);
+    *ppNode = NULL;
+
+    STATS_END(Delete, Start);
+    return (ERR_SUCCESS);
+}
+#endif // USE_STACK_ALGORITHM
+
+
+//****************************************************************************************
+//
+//! \brief  Init node pool.
+//! All nodes of pBuf are linked into the free list of pool.
+//!
+//! \param  [in] pPool is the node pool.
+//! \param  [in] pBuf is the node buffer, it must be valid while the pool is in use.
+//! \param  [in] Size is the number of nodes of pBuf.
+//!
+//! \note   
+//!         -# Pool API can be used with or without <USE_DYNAMIC_MEMORY>.
+//!         -# Pool node can not be released by \ref Tree_NodeDestory or
+//!            \ref Tree_SubTreeDelete_Dynamic.
+//
+//****************************************************************************************
+void Tree_PoolInit(TreePool_t* pPool, TreeNode_t* pBuf, int Size)
+{
+    int i = 0;
+
+    //! Check input parameter
+    ASSERT(NULL != pPool);
+    ASSERT(NULL != pBuf || 0 == Size);
+
+    //! Link all node into free list.
+    pPool->pFree = NULL;
+    for(i = Size - 1; i >= 0; i--)
+    {
+        pBuf[i].right = pPool->pFree;
+        pPool->pFree  = &pBuf[i];
+    }
+
+    pPool->Size = Size;
+    pPool->Used = 0;
+}
+
+//****************************************************************************************
+//
+//! \brief  Allocate tree node from pool.
+//!
+//! \param  [in] pPool is the node pool.
+//! \retval the address of new node or NULL if pool is empty.
+//!
+//! \note   O(1), the node is initialized by \ref Tree_NodeInit.
+//
+//****************************************************************************************
+TreeNode_t* Tree_PoolAlloc(TreePool_t* pPool)
+{
+    TreeNode_t* pNode = NULL;
+
+    //! Check input parameter
+    ASSERT(NULL != pPool);
+
+    pNode = pPool->pFree;
+    if(NULL == pNode)
+    {
+        return (NULL);
+    }
+
+    pPool->pFree = pNode->right;
+    pPool->Used++;
+    STATS_ADD(Allocs, 1);
+
+    //! Initialize the node field.
+    Tree_NodeInit(pNode);
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//
+//! \brief  Release tree node to pool.
+//!
+//! \param  [in] pPool is the node pool.
+//! \param  [in] ppNode is the address of tree node pointer.
+//! \retval \ref ERR_FAILURE if node is not a leaf node, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   O(1), the node is unlinked from its parent like \ref Tree_NodeRemove.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_PoolFree(TreePool_t* pPool, TreeNode_t** ppNode)
+{
+    TreeNode_t* pNode       = NULL;           //!< Pointer of Node
+    TreeErrorCode_t ErrCode = ERR_FAILURE;    //!< Error Code
+
+    //! Check input parameter
+    ASSERT(NULL != pPool);
+    ASSERT(NULL != ppNode);
+
+    pNode   = *ppNode;
+
+    //! Remove Tree Node
+    ErrCode = Tree_NodeRemove(ppNode);
+    if(ERR_SUCCESS != ErrCode)
+    {
+        return (ErrCode);
+    }
+
+    //! Release Node From Tree Successfully, Now put it into free list.
+    pNode->right = pPool->pFree;
+    pPool->pFree = pNode;
+    pPool->Used--;
+    STATS_ADD(Frees, 1);
+
+    return (ERR_SUCCESS);
+}
+
+//! \internal
+//! \brief Release callback of \ref Tree_SubTreeDelete_Pool.
+static void NodePoolPut(void* Ctx, TreeNode_t* pNode)
+{
+    TreePool_t* pPool = (TreePool_t*)Ctx;
+
+    pNode->right = pPool->pFree;
+    pPool->pFree = pNode;
+    pPool->Used--;
+    STATS_ADD(Frees, 1);
+}
+
+//****************************************************************************************
+//
+//! \brief  Release subtree to pool.
+//! All nodes of subtree are returned to the pool in one pass, no recursion and no
+//! work stack is used.
+//!
+//! \param  [in] pPool is the node pool.
+//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
+//! \retval \ref ERR_FAILURE if *ppNode is NULL, otherwise return \ref ERR_SUCCESS.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_SubTreeDelete_Pool(TreePool_t* pPool, TreeNode_t** ppNode)
+{
+    TreeNode_t * pNode = NULL;
+    STATS_TIMER(Start);
+
+    //! Check input parameter
+    ASSERT(NULL != pPool);
+    ASSERT(NULL != ppNode);
+    pNode = *ppNode;
+
+    //! Check input parameter.
+    if(NULL == pNode)
+    {
+        return  ERR_FAILURE;
+    }
+
+    //! Detach subtree from tree, then put all node of it into free list.
+    NodeUnlink(pNode);
+    SubTreeRelease(pNode, NodePoolPut, pPool);
+    *ppNode = NULL;
+
+    STATS_END(Delete, Start);
+    return (ERR_SUCCESS);
+}
+
+
+//****************************************************************************************
+//
+//! \brief  Init node arena.
+//!
+//! \param  [in] pArena is the node arena.
+//! \param  [in] pBuf is the node buffer, it must be valid while the arena is in use.
+//! \param  [in] Size is the number of nodes of pBuf.
+//!
+//! \note   
+//!         -# Arena API can be used with or without <USE_DYNAMIC_MEMORY>.
+//!         -# Arena node can not be released one by one, all nodes are released
+//!            together by \ref Tree_ArenaReset.
+//
+//****************************************************************************************
+void Tree_ArenaInit(TreeArena_t* pArena, TreeNode_t* pBuf, int Size)
+{
+    //! Check input parameter
+    ASSERT(NULL != pArena);
+    ASSERT(NULL != pBuf || 0 == Size);
+
+    pArena->pBase = pBuf;
+    pArena->Size  = Size;
+    pArena->Used  = 0;
+}
+
+//****************************************************************************************
+//
+//! \brief  Allocate tree node from arena.
+//!
+//! \param  [in] pArena is the node arena.
+//! \retval the address of new node or NULL if arena is full.
+//!
+//! \note   O(1), nodes are allocated in address order, so a tree built from one
+//!         arena has good locality. The node is initialized by \ref Tree_NodeInit.
+//
+//****************************************************************************************
+TreeNode_t* Tree_ArenaAlloc(TreeArena_t* pArena)
+{
+    TreeNode_t* pNode = NULL;
+
+    //! Check input parameter
+    ASSERT(NULL != pArena);
+
+    if(pArena->Used >= pArena->Size)
+    {
+        return (NULL);
+    }
+
+    pNode = &pArena->pBase[pArena->Used++];
+
+    //! Initialize the node field.
+    Tree_NodeInit(pNode);
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//
+//! \brief  Release all nodes of arena.
+//! The trees built from arena are dropped at once, no node is visited, so the cost
+//! is O(1) no matter how many nodes are allocated.
+//!
+//! \param  [in] pArena is the node arena.
+//!
+//! \note   Trees built from arena MUST not be used after reset, and nodes of other
+//!         trees MUST not be linked to arena nodes.
+//
+//****************************************************************************************
+void Tree_ArenaReset(TreeArena_t* pArena)
+{
+    //! Check input parameter
+    ASSERT(NULL != pArena);
+
+    pArena->Used = 0;
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Build balanced subtree of ppData[Low, High) into pBase[Low, High).
+//! Recursion depth is the depth of new tree, it's about log2(Count).
+//
+//****************************************************************************************
+static TreeNode_t* SubTreeBuild(TreeNode_t* pBase, void** ppData, int Low, int High,
+                                TreeNode_t* pParent)
+{
+    TreeNode_t* pNode = NULL;
+    int         Mid   = 0;
+
+    if(Low >= High)
+    {
+        return (NULL);
+    }
+
+    Mid   = Low + (High - Low) / 2;
+    pNode = &pBase[Mid];
+    Tree_NodeValueSet(pNode, ppData[Mid]);
+
+#ifdef USE_PARENT_POINTER
+    pNode->parent = pParent;
+#else
+    (void)pParent;
+#endif
+    pNode->left   = SubTreeBuild(pBase, ppData, Low, Mid, pNode);
+    pNode->right  = SubTreeBuild(pBase, ppData, Mid + 1, High, pNode);
+
+#ifdef USE_NODE_AUGMENT
+    //! Left subtree is never lower than right subtree.
+    pNode->height = NODE_HEIGHT(pNode->left) + 1;
+    pNode->size   = High - Low;
+#endif
+#ifdef USE_PERSISTENT_NODE
+    //! Referenced by its parent, or by the caller for root.
+    pNode->refs   = 1;
+#endif
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//
+//! \brief  Build a balanced tree from sorted data in one pass.
+//! Count nodes are taken from arena at once, node i holds ppData[i], and the middle
+//! node of every range becomes the root of the range, so the in-order sequence of
+//! tree is ppData[0] ... ppData[Count - 1] and the depth is floor(log2(Count)) + 1.
+//!
+//! \param  [in] pArena is the node arena, the nodes are contiguous in it.
+//! \param  [in] ppData is the array of data, every entry is handled like the Value of
+//!              \ref Tree_NodeValueSet.
+//! \param  [in] Count is the number of data.
+//! \retval the root of new tree, or NULL if Count <= 0, ppData is NULL or arena has
+//!         less than Count free nodes.
+//!
+//! \note
+//!         -# O(n), \ref Tree_NodeAppend is not called, parent pointer, cached
+//!            height/size and reference count are filled while building.
+//!         -# Nodes are in in-order address order, so in-order traverse and
+//!            search of the tree read memory sequentially.
+//!         -# With <USE_DYNAMIC_MEMORY>, use \ref Tree_ArenaCreate to get all nodes
+//!            by one malloc call.
+//!         -# The tree is NOT coloured, it can be used by \ref Tree_BstInsert but not
+//!            by \ref Tree_RbInsert.
+//
+//****************************************************************************************
+TreeNode_t* Tree_SubTreeBuild(TreeArena_t* pArena, void** ppData, int Count)
+{
+    TreeNode_t* pBase = NULL;
+
+    //! Check input parameter
+    ASSERT(NULL != pArena);
+
+    if(NULL == ppData || Count <= 0 || pArena->Size - pArena->Used < Count)
+    {
+        return (NULL);
+    }
+
+    //! Take all nodes at once.
+    pBase         = &pArena->pBase[pArena->Used];
+    pArena->Used += Count;
+
+    return (SubTreeBuild(pBase, ppData, 0, Count, NULL));
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Copy node to the next free node of arena, and link the copy to its parent.
+//! Children of copy still point to the original nodes until they are placed.
+//
+//****************************************************************************************
+static TreeNode_t* FreezePlace(TreeArena_t* pArena, TreeNode_t* pNode, TreeNode_t* pParent)
+{
+    TreeNode_t* pCopy = &pArena->pBase[pArena->Used++];
+
+    *pCopy = *pNode;
+#ifdef USE_PARENT_POINTER
+    //! Tag bits of original node are kept.
+    pCopy->parent = (TreeNode_t*)(((uintptr_t)pNode->parent & TREE_PARENT_TAG_MASK)
+                                  | (uintptr_t)pParent);
+#else
+    (void)pParent;
+#endif
+#ifdef USE_PERSISTENT_NODE
+    //! Copy is a new tree, it's not shared by any version.
+    pCopy->refs   = 1;
+#endif
+
+    return (pCopy);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Copy subtree into arena level by level, the copies are the work queue.
+//!
+//! \param  [in] pArena is the node arena.
+//! \param  [in] pNode is the root of subtree.
+//! \retval the root of copy, or NULL if arena is full, then arena is not changed.
+//
+//****************************************************************************************
+static TreeNode_t* SubTreeCopyBfs(TreeArena_t* pArena, TreeNode_t* pNode)
+{
+    TreeNode_t* pRoot = NULL;
+    TreeNode_t* pCopy = NULL;
+    int         Start = pArena->Used;
+    int         Head  = pArena->Used;
+
+    if(pArena->Used >= pArena->Size)
+    {
+        return (NULL);
+    }
+
+    pRoot = FreezePlace(pArena, pNode, NULL);
+    while(Head < pArena->Used)
+    {
+        pCopy = &pArena->pBase[Head++];
+        if(pArena->Size - pArena->Used < (NULL != pCopy->left) + (NULL != pCopy->right))
+        {
+            pArena->Used = Start;
+            return (NULL);
+        }
+
+        if(NULL != pCopy->left)
+        {
+            pCopy->left  = FreezePlace(pArena, pCopy->left, pCopy);
+        }
+        if(NULL != pCopy->right)
+        {
+            pCopy->right = FreezePlace(pArena, pCopy->right, pCopy);
+        }
+    }
+
+    return (pRoot);
+}
+
+static void FreezeVebBottom(TreeArena_t* pArena, TreeNode_t* pCopy, int Depth, int Height);
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Place the top Height levels of subtree in van Emde Boas order.
+//!
+//! \param  [in] pNode is the original root of subtree.
+//! \param  [in] Height is the number of levels to place.
+//! \param  [in] pParent is the copy of parent.
+//! \param  [in] ppLink is the link that point to the copy of subtree.
+//
+//****************************************************************************************
+static void FreezeVeb(TreeArena_t* pArena, TreeNode_t* pNode, int Height, TreeNode_t* pParent,
+                      TreeNode_t** ppLink)
+{
+    int Top = Height / 2;
+
+    if(NULL == pNode)
+    {
+        return;
+    }
+
+    if(1 == Height)
+    {
+        *ppLink = FreezePlace(pArena, pNode, pParent);
+        return;
+    }
+
+    //! Top half first, then every bottom subtree below it from left to right.
+    FreezeVeb(pArena, pNode, Top, pParent, ppLink);
+    FreezeVebBottom(pArena, *ppLink, Top, Height - Top);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Place the bottom subtrees below the Depth levels of top subtree copy.
+//! The top subtree is placed already, so its links are copies, the children of its
+//! last level are the original roots of bottom subtrees.
+//
+//****************************************************************************************
+static void FreezeVebBottom(TreeArena_t* pArena, TreeNode_t* pCopy, int Depth, int Height)
+{
+    if(NULL == pCopy)
+    {
+        return;
+    }
+
+    if(1 == Depth)
+    {
+        FreezeVeb(pArena, pCopy->left,  Height, pCopy, &pCopy->left);
+        FreezeVeb(pArena, pCopy->right, Height, pCopy, &pCopy->right);
+        return;
+    }
+
+    FreezeVebBottom(pArena, pCopy->left,  Depth - 1, Height);
+    FreezeVebBottom(pArena, pCopy->right, Depth - 1, Height);
+}
+
+//****************************************************************************************
+//
+//! \brief  Copy a tree into arena in cache friendly order.
+//! The nodes of tree are copied into contiguous nodes of arena, and the links of copies
+//! are rewritten, so every function works on the frozen copy as on the original tree.
+//! - \ref TREE_FREEZE_BFS_ORDER: level by level, a node and its children are close,
+//!   the top levels that every search touches share a few cache lines.
+//! - \ref TREE_FREEZE_VEB_ORDER: the tree is cut at half height, the top subtree is
+//!   placed first, then every bottom subtree, and each part is placed in the same way,
+//!   so a search reads O(log n / log B) cache lines for any line size B.
+//!
+//! \param  [in] pArena is the node arena, it MUST have \ref Tree_SizeGet free nodes.
+//! \param  [in] pNode is the root of tree that want to freeze.
+//! \param  [in] Order is \ref TREE_FREEZE_BFS_ORDER or \ref TREE_FREEZE_VEB_ORDER.
+//! \retval the root of frozen copy, or NULL if pNode is NULL, Order is wrong or arena has
+//!         not enough free nodes.
+//!
+//! \note
+//!         -# The original tree is not changed, release it after freeze if it's
+//!            not used any more. User's data pointed by nodes is shared, not copied.
+//!         -# Parent pointer tag bits and cached height/size are kept.
+//!         -# O(n) for BFS order, O(n log log n) for vEB order, recursion depth of vEB
+//!            order is the depth of tree.
+//!         -# A frozen tree is meant to be read, linking nodes that are not from
+//!            arena into it loses the locality.
+//
+//****************************************************************************************
+TreeNode_t* Tree_SubTreeFreeze(TreeArena_t* pArena, TreeNode_t* pNode, int Order)
+{
+    TreeNode_t* pRoot  = NULL;
+    int         Size   = 0;
+    int         Height = 0;
+
+    //! Check input parameter
+    ASSERT(NULL != pArena);
+
+    if(NULL == pNode || (TREE_FREEZE_BFS_ORDER != Order && TREE_FREEZE_VEB_ORDER != Order))
+    {
+        return (NULL);
+    }
+
+    Size = Tree_SizeGet(pNode);
+    if(pArena->Size - pArena->Used < Size)
+    {
+        return (NULL);
+    }
+
+    if(TREE_FREEZE_VEB_ORDER == Order)
+    {
+        Height = Tree_DepthGet(pNode);
+        FreezeVeb(pArena, pNode, Height, NULL, &pRoot);
+        return (pRoot);
+    }
+
+    //! BFS order, the copies in arena are the queue.
+    return (SubTreeCopyBfs(pArena, pNode));
+}
+
+//****************************************************************************************
+//
+//! \brief  Copy a subtree into arena.
+//! Nodes are copied level by level in one pass, the copies in arena are the work queue
+//! of the pass, so no stack and no queue is used. It's the same layout as
+//! \ref TREE_FREEZE_BFS_ORDER, without counting the nodes first.
+//!
+//! \param  [in] pArena is the node arena.
+//! \param  [in] pNode is the root of subtree that want to clone.
+//! \retval the root of copy, or NULL if pNode is NULL or arena has not enough free
+//!         nodes, then nothing is allocated from arena.
+//!
+//! \note
+//!         -# O(n). User's data pointed by nodes is shared, not copied.
+//!         -# Parent pointer tag bits and cached height/size are kept.
+//!         -# See \ref Tree_SubTreeClone_Parallel for large subtree.
+//
+//****************************************************************************************
+TreeNode_t* Tree_SubTreeClone(TreeArena_t* pArena, TreeNode_t* pNode)
+{
+    //! Check input parameter
+    ASSERT(NULL != pArena);
+
+    if(NULL == pNode)
+    {
+        return (NULL);
+    }
+
+    return (SubTreeCopyBfs(pArena, pNode));
+}
+
+//****************************************************************************************
+//
+//! \brief  Compare two subtrees.
+//! Subtrees are equal when they have the same shape and the data of every pair of
+//! nodes at the same position are equal. Both subtrees are visited in pre-order side by
+//! side, and compare stops at the first difference.
+//!
+//! \param  [in] pNodeA is the root of one subtree, NULL for empty subtree.
+//! \param  [in] pNodeB is the root of another subtree, NULL for empty subtree.
+//! \param  [in] pCmp is the user's compare function, called as pCmp(Ctx, A data,
+//!              B data), 0 means equal. NULL to compare the data pointers, or the
+//!              TREE_DATA_SIZE bytes of inline data.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval 1 if subtrees are equal, 0 if not, -1 if a subtree is deeper than
+//!         <TREE_ITER_DEPTH> without parent pointer (see \ref TREE_ITER_OVERFLOW).
+//!
+//! \note   O(n) with no stack, and O(1) for a shared subtree (pNodeA == pNodeB). With
+//!         <USE_NODE_AUGMENT>, subtrees of different size or height differ at once.
+//
+//****************************************************************************************
+int Tree_SubTreeEqual(TreeNode_t* pNodeA, TreeNode_t* pNodeB, TreeCompareFun_t pCmp, void* Ctx)
+{
+    TreeIter_t  IterA;
+    TreeIter_t  IterB;
+    TreeNode_t* pA = NULL;
+    TreeNode_t* pB = NULL;
+
+    if(pNodeA == pNodeB)
+    {
+        return (1);
+    }
+
+#ifdef USE_NODE_AUGMENT
+    if(NODE_SIZE(pNodeA) != NODE_SIZE(pNodeB) || NODE_HEIGHT(pNodeA) != NODE_HEIGHT(pNodeB))
+    {
+        return (0);
+    }
+#endif
+
+    //! Same children of every node in pre-order means same shape.
+    pA = Tree_IterFirst(&IterA, pNodeA, TREE_ITER_PRE_ORDER);
+    pB = Tree_IterFirst(&IterB, pNodeB, TREE_ITER_PRE_ORDER);
+    while(NULL != pA && NULL != pB)
+    {
+        if((NULL == pA->left) != (NULL == pB->left) || (NULL == pA->right) != (NULL == pB->right))
+        {
+            return (0);
+        }
+
+        if(NULL != pCmp)
+        {
+            if(0 != pCmp(Ctx, pA->data, pB->data))
+            {
+                return (0);
+            }
+        }
+#ifdef USE_INLINE_DATA
+        else if(0 != memcmp(pA->data, pB->data, TREE_DATA_SIZE))
+#else
+        else if(pA->data != pB->data)
+#endif
+        {
+            return (0);
+        }
+
+        pA = Tree_IterNext(&IterA);
+        pB = Tree_IterNext(&IterB);
+    }
+
+    if(TREE_ITER_OVERFLOW(&IterA) || TREE_ITER_OVERFLOW(&IterB))
+    {
+        return (-1);
+    }
+
+    return (pA == pB);
+}
+
+#ifdef USE_PERSISTENT_NODE
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Check the path of version.
+//!
+//! \param  [in] ppPath is the path from root.
+//! \param  [in] Depth is the number of nodes of path.
+//! \retval \ref ERR_SUCCESS if every node is a child of the one before it, otherwise
+//!         return \ref ERR_WRONG_PARAM.
+//
+//****************************************************************************************
+static TreeErrorCode_t PersistPathCheck(TreeNode_t** ppPath, int Depth)
+{
+    int i = 0;
+
+    for(i = 0; i < Depth; i++)
+    {
+        if(NULL == ppPath[i])
+        {
+            return (ERR_WRONG_PARAM);
+        }
+
+        if(i > 0 && ppPath[i - 1]->left != ppPath[i] && ppPath[i - 1]->right != ppPath[i])
+        {
+            return (ERR_WRONG_PARAM);
+        }
+    }
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Copy the first nodes of path.
+//! Children out of path gain one reference from the copy, the path child is replaced
+//! by its copy.
+//!
+//! \param  [in] pPool is the node pool, it MUST have Count free nodes.
+//! \param  [in] ppPath is the path from root.
+//! \param  [in] Count is the number of nodes to copy, 1 <= Count <= Depth.
+//! \param  [in] Depth is the number of nodes of path.
+//! \param  [out] ppRoot is the copy of ppPath[0].
+//! \retval the copy of ppPath[Count - 1].
+//
+//****************************************************************************************
+static TreeNode_t* PersistPathCopy(TreePool_t* pPool, TreeNode_t** ppPath, int Count, int Depth,
+                                   TreeNode_t** ppRoot)
+{
+    TreeNode_t* pUp   = NULL;
+    TreeNode_t* pCopy = NULL;
+    TreeNode_t* pNext = NULL;
+    int         i     = 0;
+
+    for(i = 0; i < Count; i++)
+    {
+        pNext = (i + 1 < Depth) ? ppPath[i + 1] : NULL;
+
+        pCopy       = Tree_PoolAlloc(pPool);
+        *pCopy      = *ppPath[i];
+        pCopy->refs = 1;
+        if(NULL != pCopy->left && pNext != pCopy->left)
+        {
+            pCopy->left->refs++;
+        }
+        if(NULL != pCopy->right && pNext != pCopy->right)
+        {
+            pCopy->right->refs++;
+        }
+
+        if(NULL == pUp)
+        {
+            *ppRoot = pCopy;
+        }
+        else if(pUp->left == ppPath[i])
+        {
+            pUp->left  = pCopy;
+        }
+        else
+        {
+            pUp->right = pCopy;
+        }
+#ifdef USE_PARENT_POINTER
+        TREE_PARENT_SET(pCopy, pUp);
+#endif
+        pUp = pCopy;
+    }
+
+    return (pCopy);
+}
+
+//! \internal
+//! \brief Drop one reference of node, return it if it's the last one.
+static TreeNode_t* PersistUnref(TreeNode_t* pNode)
+{
+    if(NULL != pNode && 0 == --pNode->refs)
+    {
+        return (pNode);
+    }
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \brief  Append node in a new version of tree.
+//! The nodes of path are copied, the children out of path are shared, then pNewNode is
+//! appended to the copy of the last node. The version of ppPath[0] is not changed.
+//!
+//! \param  [in] pPool is the node pool, it MUST have Depth free nodes.
+//! \param  [out] ppRoot is the root of new version.
+//! \param  [in] ppPath is the path from root, ppPath[i + 1] is a child of ppPath[i], and
+//!              pNewNode is appended to ppPath[Depth - 1].
+//! \param  [in] Depth is the number of nodes of path, 0 to make pNewNode a new version.
+//! \param  [in] pNewNode is a new node, it's owned by the new version.
+//! \param  [in] Mode is \ref INSERT_POS_LEFT or \ref INSERT_POS_RIGHT.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Mode or
+//!         path is wrong, \ref ERR_NODE_EXIST if the child node is not empty,
+//!         \ref ERR_MEM if pool has not enough free nodes.
+//!
+//! \note   O(Depth). The path is what a search from root visit, for example the stack
+//!         of a BST descent.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_PersistAppend(TreePool_t* pPool, TreeNode_t** ppRoot, TreeNode_t** ppPath,
+                                   int Depth, TreeNode_t* pNewNode, int Mode)
+{
+    TreeNode_t* pNode = NULL;
+    TreeNode_t* pCopy = NULL;
+
+    //! Check input parameters
+    if(NULL == pPool || NULL == ppRoot || NULL == pNewNode || (Depth > 0 && NULL == ppPath))
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(Depth < 0 || (INSERT_POS_LEFT != Mode && INSERT_POS_RIGHT != Mode)
+       || ERR_SUCCESS != PersistPathCheck(ppPath, Depth))
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    if(0 == Depth)
+    {
+        *ppRoot = pNewNode;
+        return (ERR_SUCCESS);
+    }
+
+    pNode = ppPath[Depth - 1];
+    if(NULL != ((INSERT_POS_LEFT == Mode) ? pNode->left : pNode->right))
+    {
+        return (ERR_NODE_EXIST);
+    }
+
+    if(pPool->Size - pPool->Used < Depth)
+    {
+        return (ERR_MEM);
+    }
+
+    pCopy = PersistPathCopy(pPool, ppPath, Depth, Depth, ppRoot);
+    if(INSERT_POS_LEFT == Mode)
+    {
+        pCopy->left  = pNewNode;
+    }
+    else
+    {
+        pCopy->right = pNewNode;
+    }
+#ifdef USE_PARENT_POINTER
+    TREE_PARENT_SET(pNewNode, pCopy);
+#endif
+#ifdef USE_NODE_AUGMENT
+    Tree_NodeAugmentUpdate(pCopy);
+#endif
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Delete subtree in a new version of tree.
+//! The nodes of path except the last one are copied, the children out of path are
+//! shared, and the link of ppPath[Depth - 1] is cleared in the copy.
+//!
+//! \param  [in] pPool is the node pool, it MUST have Depth - 1 free nodes.
+//! \param  [out] ppRoot is the root of new version, NULL if Depth is 1.
+//! \param  [in] ppPath is the path from root to the root of subtree to delete.
+//! \param  [in] Depth is the number of nodes of path.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if path is
+//!         wrong, \ref ERR_MEM if pool has not enough free nodes.
+//!
+//! \note   O(Depth). The subtree is still used by old versions, it's freed by
+//!         \ref Tree_PersistRelease of the last one.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_PersistDelete(TreePool_t* pPool, TreeNode_t** ppRoot, TreeNode_t** ppPath,
+                                   int Depth)
+{
+    TreeNode_t* pCopy = NULL;
+
+    //! Check input parameters
+    if(NULL == pPool || NULL == ppRoot || NULL == ppPath)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(Depth <= 0 || ERR_SUCCESS != PersistPathCheck(ppPath, Depth))
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    if(pPool->Size - pPool->Used < Depth - 1)
+    {
+        return (ERR_MEM);
+    }
+
+    if(1 == Depth)
+    {
+        *ppRoot = NULL;
+        return (ERR_SUCCESS);
+    }
+
+    pCopy = PersistPathCopy(pPool, ppPath, Depth - 1, Depth, ppRoot);
+    if(pCopy->left == ppPath[Depth - 1])
+    {
+        pCopy->left  = NULL;
+    }
+    else
+    {
+        pCopy->right = NULL;
+    }
+#ifdef USE_NODE_AUGMENT
+    Tree_NodeAugmentUpdate(pCopy);
+#endif
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Take one more reference of version.
+//! Every Tree_PersistRetain MUST be paired with one \ref Tree_PersistRelease.
+//!
+//! \param  [in] pRoot is the root of version, NULL for empty version.
+//
+//****************************************************************************************
+void Tree_PersistRetain(TreeNode_t* pRoot)
+{
+    if(NULL != pRoot)
+    {
+        pRoot->refs++;
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Release one reference of version.
+//! The nodes that are used by no more parent and no more version are returned to pool.
+//! A tree built by \ref Tree_NodeAppend is a version with one reference, because every
+//! node is initialized with one reference.
+//!
+//! \param  [in] pPool is the node pool of the nodes.
+//! \param  [in] ppRoot is the root of version, it's set to NULL.
+//! \retval \ref ERR_FAILURE if *ppRoot is NULL, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   O(freed nodes), no recursion and no work stack is used. Nodes are not
+//!         protected from concurrent readers, with \ref TreeEpoch_t publish the new
+//!         root by \ref TREE_RCU_ASSIGN and release the old one after
+//!         \ref Tree_EpochSynchronize.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_PersistRelease(TreePool_t* pPool, TreeNode_t** ppRoot)
+{
+    TreeNode_t* pNode  = NULL;
+    TreeNode_t* pHold  = NULL;    //!< Nodes holding a pending right child.
+    TreeNode_t* pLeft  = NULL;
+    TreeNode_t* pRight = NULL;
+
+    //! Check input parameter
+    ASSERT(NULL != pPool);
+    ASSERT(NULL != ppRoot);
+
+    pNode = *ppRoot;
+    if(NULL == pNode)
+    {
+        return (ERR_FAILURE);
+    }
+
+    *ppRoot = NULL;
+    if(0 != --pNode->refs)
+    {
+        return (ERR_SUCCESS);
+    }
+
+    //! Free nodes without reference. When both children lose their last reference,
+    //! the node is kept as holder of the right one: left field link holders, right
+    //! field is the pending child.
+    while(NULL != pNode)
+    {
+        pLeft  = PersistUnref(pNode->left);
+        pRight = PersistUnref(pNode->right);
+        if(NULL != pLeft && NULL != pRight)
+        {
+            pNode->left  = pHold;
+            pNode->right = pRight;
+            pHold        = pNode;
+            pNode        = pLeft;
+            continue;
+        }
+
+        NodePoolPut(pPool, pNode);
+        pNode = (NULL != pLeft) ? pLeft : pRight;
+        if(NULL == pNode && NULL != pHold)
+        {
+            pNode  = pHold->right;
+            pRight = pHold->left;
+            NodePoolPut(pPool, pHold);
+            pHold  = pRight;
+        }
+    }
+
+    return (ERR_SUCCESS);
+}
+#endif // USE_PERSISTENT_NODE
+
+
+//****************************************************************************************
+//! \brief  Get the depth of tree.
+//!
+//! \param  [in] pNode is the root of tree.
+//! \retval the depth of tree checked, it should >= 1, return zero indicates pNode is
+//!         an invalid node.
+//!
+//! \note   O(1) when <USE_NODE_AUGMENT> is selected, otherwise O(n) without recursion
+//!         and work stack: parent pointer is followed to go back, or right links of
+//!         in-order predecessors are borrowed and restored without parent pointer, so
+//!         the subtree must not be used by another thread at the same time then.
+//****************************************************************************************
+#ifdef USE_NODE_AUGMENT
+int Tree_DepthGet(TreeNode_t* pNode)
+{
+    return (NODE_HEIGHT(pNode));
+}
+#else
+int Tree_DepthGet(TreeNode_t* pNode)
+{
+    int Height = 0;
+
+    SubTreeMeasure(pNode, &Height);
+
+    return (Height);
+}
+#endif // USE_NODE_AUGMENT
+
+//****************************************************************************************
+//! \brief  Get the number of nodes of tree.
+//!
+//! \param  [in] pNode is the root of tree.
+//! \retval the number of nodes, return zero indicates pNode is an invalid node.
+//!
+//! \note   O(1) when <USE_NODE_AUGMENT> is selected, otherwise O(n) without recursion
+//!         and work stack, see \ref Tree_DepthGet.
+//****************************************************************************************
+int Tree_SizeGet(TreeNode_t* pNode)
+{
+#ifdef USE_NODE_AUGMENT
+    return (NODE_SIZE(pNode));
+#else
+    int Height = 0;
+
+    return (SubTreeMeasure(pNode, &Height));
+#endif
+}
+
+#ifdef USE_NODE_AUGMENT
+//****************************************************************************************
+//! \brief  Update cached height and size of node and all its ancestors.
+//!
+//! \param  [in] pNode is the lowest node whose children are changed, NULL is ignored.
+//!
+//! \note
+//!         -# Library functions call it internally, user only need it after changing
+//!            left/right/parent field by hand, for example rotating nodes.
+//!         -# O(depth), the children of pNode must be up to date.
+//!         -# MUST uncomment <USE_NODE_AUGMENT> macro in order to use this function.
+//****************************************************************************************
+void Tree_NodeAugmentUpdate(TreeNode_t* pNode)
+{
+    int LHeight = 0;
+    int RHeight = 0;
+
+    while(NULL != pNode)
+    {
+        LHeight       = NODE_HEIGHT(pNode->left);
+        RHeight       = NODE_HEIGHT(pNode->right);
+        pNode->height = ((LHeight >= RHeight) ? LHeight : RHeight) + 1;
+        pNode->size   = NODE_SIZE(pNode->left) + NODE_SIZE(pNode->right) + 1;
+
+        pNode = TREE_PARENT(pNode);
+    }
+}
+
+//****************************************************************************************
+//! \brief  Get the node at position Index of in-order sequence.
+//!
+//! \param  [in] pNode is the root of tree.
+//! \param  [in] Index is the zero based position, 0 is the most left node.
+//! \retval the node found, or NULL if Index is out of range.
+//!
+//! \note   O(depth), MUST uncomment <USE_NODE_AUGMENT> macro in order to use this
+//!         function.
+//****************************************************************************************
+TreeNode_t* Tree_NodeSelect(TreeNode_t* pNode, int Index)
+{
+    int LSize = 0;
+
+    while(NULL != pNode)
+    {
+        LSize = NODE_SIZE(pNode->left);
+        if(Index < LSize)
+        {
+            pNode = pNode->left;
+        }
+        else if(Index == LSize)
+        {
+            return (pNode);
+        }
+        else
+        {
+            Index -= LSize + 1;
+            pNode  = pNode->right;
+        }
+    }
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//! \brief  Get the position of node in in-order sequence of its tree.
+//! It is the reverse of \ref Tree_NodeSelect, the number of nodes which are before
+//! pNode in the whole tree containing it.
+//!
+//! \param  [in] pNode is the tree node.
+//! \retval the zero based position of pNode, or -1 if pNode is NULL.
+//!
+//! \note   O(depth), MUST uncomment <USE_NODE_AUGMENT> macro in order to use this
+//!         function.
+//****************************************************************************************
+int Tree_NodeRank(TreeNode_t* pNode)
+{
+    TreeNode_t* pParent = NULL;
+    int         Rank    = 0;
+
+    //! Check input parameter
+    if(NULL == pNode)
+    {
+        return (-1);
+    }
+
+    //! Nodes of left subtree, plus every ancestor and its left subtree on the left side.
+    Rank = NODE_SIZE(pNode->left);
+    while(NULL != (pParent = TREE_PARENT(pNode)))
+    {
+        if(pParent->right == pNode)
+        {
+            Rank += NODE_SIZE(pParent->left) + 1;
+        }
+        pNode = pParent;
+    }
+
+    return (Rank);
+}
+#endif // USE_NODE_AUGMENT
+
+//****************************************************************************************
+//! \brief  Set Node value.
+//!
+//! \param  [in] pNode is the target tree node.
+//! \param  [in] Value is the address of data.
+//! \retval \ref ERR_SUCCESS if set node value successfully, \ref ERR_INVALID_POINTER
+//!         if input parameters contain invalid pointer.
+//!
+//! \note   The tree node just store the pointer of data, so, we can use this tree
+//!         to store any type of data. <General Programming Method>, Here is a code
+//!         snippet for you. With <USE_INLINE_DATA>, TREE_DATA_SIZE bytes at Value are
+//!         copied into node instead, and NULL Value clear the node data.
+//! \code
+//!
+//! typedef struct STUDENT
+//! {
+//!     char*   name;
+//!     uint8_t age;
+//!     uint8_t sex;
+//!     uint8_t class;
+//! }STUDENT;
+//!
+//! STUDENT Class_1[20];
+//! ...
+//!
+//! Tree_NodeValueSet(Node[0], (void*)&Class_1[0]);
+//!
+//! \endcode
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_NodeValueSet(TreeNode_t* pNode, void* Value)
+{
+    //! Check input parameters.
+    if(NULL == pNode)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! Fill Node value
+#ifdef USE_INLINE_DATA
+    if(NULL == Value)
+    {
+        memset(pNode->data, 0, TREE_DATA_SIZE);
+    }
+    else
+    {
+        memcpy(pNode->data, Value, TREE_DATA_SIZE);
+    }
+#else
+    pNode->data = Value;
+#endif
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Get Node value.
+//!
+//! \param  [in] pNode is the target tree node.
+//! \retval the address of data that stored in tree node.
+//!
+//! \note   The tree node just store the pointer of data, so, we can use this tree
+//!         to store any type of data. <General Programming Method>, Here is a code
+//!         snippet for you. With <USE_INLINE_DATA>, the address of data stored in
+//!         node is returned, copy TREE_DATA_SIZE bytes from it to get the value.
+//! \code
+//!
+//! typedef struct STUDENT
+//! {
+//!     char*   name;
+//!     uint8_t age;
+//!     uint8_t sex;
+//!     uint8_t class;
+//! }STUDENT;
+//!
+//! STUDENT Class_1[20];
+//! STUDENT* pStudent = NULL;
+//! ...
+//!
+//! pStudent = (STUDENT*) Tree_NodeValueGet(Node[0]);
+//!
+//! \endcode
+//****************************************************************************************
+void* Tree_NodeValueGet(TreeNode_t* pNode)
+{
+    //! Check input parameters.
+    if(NULL == pNode)
+    {
+        return (NULL);
+    }
+
+    //! Return data field.
+    return (pNode->data);
+}
+
+//****************************************************************************************
+//! \brief  Append an node.
+//! This function append an new node to an existing node.
+//!
+//! \param  [in] pNode is the address of exising node, new node will be
+//!         inserted behind it.
+//! \param  [in] pNewNode is the address of node that want to insert.
+//! \param  [in] Mode control insert point of node.
+//!              the parameter can be one of the following value:
+//!              - \ref INSERT_POS_LEFT  New node will be appended to left child.
+//!              - \ref INSERT_POS_RIGHT New node will be appended to right child.
+//!              .
+//! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_NODE_EXIST if the
+//!         child node is not empty, \ref ERR_WRONG_PARAM if Mode parameter is
+//!         wrong.
+//! \note   This function is designed for tree end node.
+//****************************************************************************************
+TreeErrorCode_t Tree_NodeAppend(TreeNode_t* pNode, TreeNode_t* pNewNode, int Mode)
+{
+
+    //! Check input parameters
+    if(NULL == pNode || NULL == pNewNode)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! Check mode parameter.
+    if(0 != (Mode & (~INSERT_MODE_MASK)))
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    //! Append Left Node
+    if((Mode & INSERT_MODE_MASK) == INSERT_POS_LEFT)
+    {
+        if(NULL == pNode->left)
+        {
+            pNode->left      = pNewNode;
+#ifdef USE_PARENT_POINTER
+            pNewNode->parent = pNode;
+#endif
+#ifdef USE_NODE_AUGMENT
+            Tree_NodeAugmentUpdate(pNode);
+#endif
+            STATS_ADD(Appends, 1);
+            return (ERR_SUCCESS);
+        }
+        else
+        {
+            STATS_ADD(AppendFails, 1);
+            return (ERR_NODE_EXIST);
+        }
+    }
+
+    //! Append Right Node
+    if((Mode & INSERT_MODE_MASK) == INSERT_POS_RIGHT)
+    {
+        if(NULL == pNode->right)
+        {
+            pNode->right     = pNewNode;
+#ifdef USE_PARENT_POINTER
+            pNewNode->parent = pNode;
+#endif
+#ifdef USE_NODE_AUGMENT
+            Tree_NodeAugmentUpdate(pNode);
+#endif
+            STATS_ADD(Appends, 1);
+            return (ERR_SUCCESS);
+        }
+        else
+        {
+            STATS_ADD(AppendFails, 1);
+            return (ERR_NODE_EXIST);
+        }
+    }
+
+    //! Note:In normal conditions, program can not run to here.
+    return (ERR_WRONG_PARAM);
+
+}
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in pre-order algorithm.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the default work
+//!         stack can not hold this tree (stack algorithm only, see <TREE_STACK_DEPTH>).
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+#ifdef USE_RECURSIVE_ALGORITHM
+//! \internal
+//! \brief Context of recursive visit.
+typedef struct TreeVisit
+{
+    TreeCallBackFun_t pFun    ;  //!< User's callback.
+    void*             Ctx     ;  //!< Context of callback.
+#ifdef USE_TREE_STATS
+    int               Depth   ;  //!< Levels of recursion now.
+    int               DepthMax;  //!< The most levels of recursion.
+#endif
+}TreeVisit_t;
+
+//! \internal
+//! \brief Pre-order visit of subtree, return the first non-zero value of pFun.
+static int PreOrderVisit(TreeNode_t* pNode, TreeVisit_t* pVisit)
+{
+    int Ret = 0;
+
+    if(NULL == pNode)
+    {
+        return (0);
+    }
+
+    STATS_DEPTH_ENTER(pVisit);
+    STATS_ADD(Callbacks, 1);
+    Ret = pVisit->pFun(pVisit->Ctx, pNode->data);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    Ret = PreOrderVisit(pNode->left, pVisit);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    Ret = PreOrderVisit(pNode->right, pVisit);
+    STATS_DEPTH_LEAVE(pVisit);
+
+    return (Ret);
+}
+
+TreeErrorCode_t Tree_TravesePreOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeVisit_t Visit;
+    int         Ret = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    Visit.pFun = pFun;
+    Visit.Ctx  = Ctx;
+    STATS_DEPTH_INIT(&Visit);
+    Ret = PreOrderVisit(pNode, &Visit);
+
+    STATS_DEPTH(Visit.DepthMax);
+    STATS_END(Travese, Start);
+    return ((TreeErrorCode_t)Ret);
+}
+#endif // USE_RECURSIVE_ALGORITHM
+
+#ifdef USE_STACK_ALGORITHM
+TreeErrorCode_t Tree_TravesePreOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+#ifdef STACK_PARENT_WALK
+    return Tree_TravesePreOrder_Parent(pNode, pFun, Ctx);
+#else
+    TreeNode_t*     Buf[TREE_STACK_DEPTH];
+    TreeStack_t     Stack;
+    TreeErrorCode_t ErrCode = ERR_SUCCESS;
+
+    StackDefaultInit(&Stack, Buf);
+    ErrCode = Tree_TravesePreOrderEx(pNode, pFun, Ctx, &Stack);
+    StackDefaultRelease(&Stack);
+
+    return (ErrCode);
+#endif
+}
+#endif // USE_STACK_ALGORITHM
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in in-order algorithm.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the default work
+//!         stack can not hold this tree (stack algorithm only, see <TREE_STACK_DEPTH>).
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+#ifdef USE_RECURSIVE_ALGORITHM
+//! \internal
+//! \brief In-order visit of subtree, return the first non-zero value of pFun.
+static int InOrderVisit(TreeNode_t* pNode, TreeVisit_t* pVisit)
+{
+    int Ret = 0;
+
+    if(NULL == pNode)
+    {
+        return (0);
+    }
+
+    STATS_DEPTH_ENTER(pVisit);
+    Ret = InOrderVisit(pNode->left, pVisit);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    STATS_ADD(Callbacks, 1);
+    Ret = pVisit->pFun(pVisit->Ctx, pNode->data);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    Ret = InOrderVisit(pNode->right, pVisit);
+    STATS_DEPTH_LEAVE(pVisit);
+
+    return (Ret);
+}
+
+TreeErrorCode_t Tree_TraveseInOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeVisit_t Visit;
+    int         Ret = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    Visit.pFun = pFun;
+    Visit.Ctx  = Ctx;
+    STATS_DEPTH_INIT(&Visit);
+    Ret = InOrderVisit(pNode, &Visit);
+
+    STATS_DEPTH(Visit.DepthMax);
+    STATS_END(Travese, Start);
+    return ((TreeErrorCode_t)Ret);
+}
+#endif // USE_RECURSIVE_ALGORITHM
+
+#ifdef USE_STACK_ALGORITHM
+TreeErrorCode_t Tree_TraveseInOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+#ifdef STACK_PARENT_WALK
+    return Tree_TraveseInOrder_Parent(pNode, pFun, Ctx);
+#else
+    TreeNode_t*     Buf[TREE_STACK_DEPTH];
+    TreeStack_t     Stack;
+    TreeErrorCode_t ErrCode = ERR_SUCCESS;
+
+    StackDefaultInit(&Stack, Buf);
+    ErrCode = Tree_TraveseInOrderEx(pNode, pFun, Ctx, &Stack);
+    StackDefaultRelease(&Stack);
+
+    return (ErrCode);
+#endif
+}
+#endif // USE_STACK_ALGORITHM
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in post-order algorithm.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the default work
+//!         stack can not hold this tree (stack algorithm only, see <TREE_STACK_DEPTH>).
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+#ifdef USE_RECURSIVE_ALGORITHM
+//! \internal
+//! \brief Post-order visit of subtree, return the first non-zero value of pFun.
+static int PostOrderVisit(TreeNode_t* pNode, TreeVisit_t* pVisit)
+{
+    int Ret = 0;
+
+    if(NULL == pNode)
+    {
+        return (0);
+    }
+
+    STATS_DEPTH_ENTER(pVisit);
+    Ret = PostOrderVisit(pNode->left, pVisit);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    Ret = PostOrderVisit(pNode->right, pVisit);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    STATS_DEPTH_LEAVE(pVisit);
+    STATS_ADD(Callbacks, 1);
+    return pVisit->pFun(pVisit->Ctx, pNode->data);
+}
+
+TreeErrorCode_t Tree_TravesePostOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeVisit_t Visit;
+    int         Ret = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    Visit.pFun = pFun;
+    Visit.Ctx  = Ctx;
+    STATS_DEPTH_INIT(&Visit);
+    Ret = PostOrderVisit(pNode, &Visit);
+
+    STATS_DEPTH(Visit.DepthMax);
+    STATS_END(Travese, Start);
+    return ((TreeErrorCode_t)Ret);
+}
+#endif // USE_RECURSIVE_ALGORITHM
+
+#ifdef USE_STACK_ALGORITHM
+TreeErrorCode_t Tree_TravesePostOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+#ifdef STACK_PARENT_WALK
+    return Tree_TravesePostOrder_Parent(pNode, pFun, Ctx);
+#else
+    TreeNode_t*     Buf[TREE_STACK_DEPTH];
+    TreeStack_t     Stack;
+    TreeErrorCode_t ErrCode = ERR_SUCCESS;
+
+    StackDefaultInit(&Stack, Buf);
+    ErrCode = Tree_TravesePostOrderEx(pNode, pFun, Ctx, &Stack);
+    StackDefaultRelease(&Stack);
+
+    return (ErrCode);
+#endif
+}
+#endif // USE_STACK_ALGORITHM
+
+#ifdef USE_PARENT_POINTER
+//****************************************************************************************
+//! \brief  Foreach Tree Node by parent pointer.
+//! This function visit all tree node in pre-order algorithm, it follows parent pointer
+//! to go back, so no stack memory is used no matter how deep the tree is.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   The parent pointer of every node must be maintained by \ref Tree_NodeAppend.
+//****************************************************************************************
+TreeErrorCode_t Tree_TravesePreOrder_Parent(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeNode_t* pRoot = pNode;
+    int         Ret   = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    for(pNode = PreOrderFirst(pRoot); NULL != pNode; pNode = PreOrderNext(pNode, pRoot))
+    {
+        STATS_ADD(Callbacks, 1);
+        Ret = pFun(Ctx, pNode->data);
+        if(0 != Ret)
+        {
+            STATS_END(Travese, Start);
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+
+    STATS_END(Travese, Start);
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node by parent pointer.
+//! This function visit all tree node in in-order algorithm, it follows parent pointer
+//! to go back, so no stack memory is used no matter how deep the tree is.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   The parent pointer of every node must be maintained by \ref Tree_NodeAppend.
+//****************************************************************************************
+TreeErrorCode_t Tree_TraveseInOrder_Parent(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeNode_t* pRoot = pNode;
+    int         Ret   = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    for(pNode = InOrderFirst(pRoot); NULL != pNode; pNode = InOrderNext(pNode, pRoot))
+    {
+        STATS_ADD(Callbacks, 1);
+        Ret = pFun(Ctx, pNode->data);
+        if(0 != Ret)
+        {
+            STATS_END(Travese, Start);
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+
+    STATS_END(Travese, Start);
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node by parent pointer.
+//! This function visit all tree node in post-order algorithm, it follows parent pointer
+//! to go back, so no stack memory is used no matter how deep the tree is.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   The parent pointer of every node must be maintained by \ref Tree_NodeAppend.
+//****************************************************************************************
+TreeErrorCode_t Tree_TravesePostOrder_Parent(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeNode_t* pRoot = pNode;
+    int         Ret   = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    for(pNode = PostOrderFirst(pRoot); NULL != pNode; pNode = PostOrderNext(pNode, pRoot))
+    {
+        STATS_ADD(Callbacks, 1);
+        Ret = pFun(Ctx, pNode->data);
+        if(0 != Ret)
+        {
+            STATS_END(Travese, Start);
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+
+    STATS_END(Travese, Start);
+    return (ERR_SUCCESS);
+}
+#endif // USE_PARENT_POINTER
+
+//****************************************************************************************
+//! \brief  Init work queue.
+//!
+//! \param  [in] pQueue is the work queue.
+//! \param  [in] pBuf is the queue buffer, it must be valid while the queue is in use.
+//! \param  [in] Size is the number of entries of pBuf.
+//****************************************************************************************
+void Tree_QueueInit(TreeQueue_t* pQueue, TreeNode_t** pBuf, int Size)
+{
+    //! Check input parameter
+    ASSERT(NULL != pQueue);
+    ASSERT(NULL != pBuf || 0 == Size);
+
+    pQueue->pBase = pBuf;
+    pQueue->Size  = Size;
+    pQueue->Head  = 0;
+    pQueue->Count = 0;
+#ifdef USE_DYNAMIC_MEMORY
+    pQueue->Grow  = QUEUE_GROW_NONE;
+#endif
+}
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in level-order (breadth-first) algorithm, nodes
+//! of the same level are visited from left to right.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the default work
+//!         queue can not hold a level of this tree, see <TREE_QUEUE_SIZE>.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+TreeErrorCode_t Tree_TraveseLevelOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeNode_t*     Buf[TREE_QUEUE_SIZE];
+    TreeQueue_t     Queue;
+    TreeErrorCode_t Ret = ERR_SUCCESS;
+
+    Tree_QueueInit(&Queue, Buf, TREE_QUEUE_SIZE);
+
+#ifdef USE_DYNAMIC_MEMORY
+    //! Queue is moved to heap when a level need more entries.
+    Queue.Grow = QUEUE_GROW_AUTO;
+    Ret = Tree_TraveseLevelOrderEx(pNode, pFun, Ctx, &Queue);
+    if(QUEUE_GROW_HEAP == Queue.Grow)
+    {
+        free(Queue.pBase);
+    }
+#else
+    //! Queue can not grow, fail before the first callback instead of in the middle.
+    if(NULL != pNode && NULL != pFun && ERR_SUCCESS != QueueFit(pNode, &Queue))
+    {
+        return (ERR_MEM);
+    }
+    Ret = Tree_TraveseLevelOrderEx(pNode, pFun, Ctx, &Queue);
+#endif
+
+    return (Ret);
+}
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node with user's work queue.
+//! This function visit all tree node in level-order (breadth-first) algorithm, nodes
+//! of the same level are visited from left to right.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] pQueue is the work queue, it need (width of tree + 1) entries at most.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if pQueue is too
+//!         small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+TreeErrorCode_t Tree_TraveseLevelOrderEx(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                                        TreeQueue_t* pQueue)
+{
+    int Ret   = 0;
+#ifdef USE_PREFETCH
+    int Ahead = 0;
+#endif
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun || NULL == pQueue)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pQueue->Head  = 0;
+    pQueue->Count = 0;
+    QUEUE_PUT(pQueue, pNode);
+    while(0 != pQueue->Count)
+    {
+        QUEUE_GET(pQueue, pNode);
+
+        //! A node is visited a whole level after it is put, so prefetch at put time is
+        //! long evicted in a wide level. Prefetch from the queue instead: the node
+        //! 2 * <TREE_PREFETCH_DISTANCE> entries ahead, and the data of the node
+        //! <TREE_PREFETCH_DISTANCE> entries ahead, whose node is in cache already.
+#ifdef USE_PREFETCH
+        if(pQueue->Count >= 2 * TREE_PREFETCH_DISTANCE)
+        {
+            Ahead = QueueAhead(pQueue, 2 * TREE_PREFETCH_DISTANCE - 1);
+            TREE_PREFETCH(pQueue->pBase[Ahead]);
+        }
+        if(pQueue->Count >= TREE_PREFETCH_DISTANCE)
+        {
+            Ahead = QueueAhead(pQueue, TREE_PREFETCH_DISTANCE - 1);
+            DATA_PREFETCH(pQueue->pBase[Ahead]);
+        }
+#endif
+
+        STATS_ADD(Callbacks, 1);
+        Ret = pFun(Ctx, pNode->data);
+        if(0 != Ret)
+        {
+            STATS_END(Travese, Start);
+            return ((TreeErrorCode_t)Ret);
+        }
+
+        if(NULL != pNode->left)
+        {
+            QUEUE_PUT(pQueue, pNode->left);
+        }
+
+        if(NULL != pNode->right)
+        {
+            QUEUE_PUT(pQueue, pNode->right);
+        }
+    }
+
+    STATS_END(Travese, Start);
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//!                     ITERATOR
+//****************************************************************************************
+
+#ifndef USE_PARENT_POINTER
+//! \internal
+//! \brief Path stack operation of iterator, PATH_PUSH return NULL from caller and mark
+//!        the iterator overflow if path is full.
+#define PATH_PUSH(pIter, pNode)                                                       \
+    do                                                                                \
+    {                                                                                 \
+        if((pIter)->Top >= TREE_ITER_DEPTH)                                           \
+        {                                                                             \
+            (pIter)->Top = -1;                                                        \
+            return (NULL);                                                            \
+        }                                                                             \
+        (pIter)->Path[(pIter)->Top++] = (pNode);                                      \
+    } while(0)
+
+#define PATH_POP(pIter)        ((pIter)->Path[--(pIter)->Top])
+#define PATH_PEEK(pIter)       ((0 != (pIter)->Top) ? (pIter)->Path[(pIter)->Top - 1] : NULL)
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Go down to the first node of post-order, every node passed is in path.
+//!
+//! \param  [in] pIter is the iterator, current node is on the top of path.
+//! \retval the first node of post-order of current node, or NULL if path overflow.
+//
+//****************************************************************************************
+static TreeNode_t* IterPostOrderDown(TreeIter_t* pIter)
+{
+    TreeNode_t* pNode = PATH_PEEK(pIter);
+
+    while(NULL != pNode->left || NULL != pNode->right)
+    {
+        pNode = (NULL != pNode->left) ? pNode->left : pNode->right;
+        PATH_PUSH(pIter, pNode);
+    }
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the next node of iterator by path stack.
+//!
+//! \param  [in] pIter is the iterator, current node is on the top of path.
+//! \retval next node, or NULL if current node is the last one or path overflow.
+//
+//****************************************************************************************
+static TreeNode_t* IterPathNext(TreeIter_t* pIter)
+{
+    TreeNode_t* pNode   = PATH_PEEK(pIter);
+    TreeNode_t* pParent = NULL;
+
+    switch(pIter->Order)
+    {
+        case TREE_ITER_PRE_ORDER:
+        {
+            if(NULL != pNode->left || NULL != pNode->right)
+            {
+                pNode = (NULL != pNode->left) ? pNode->left : pNode->right;
+                PATH_PUSH(pIter, pNode);
+                return (pNode);
+            }
+
+            //! Go back until we come from a left child which has right sibling.
+            pNode = PATH_POP(pIter);
+            while(NULL != (pParent = PATH_PEEK(pIter)))
+            {
+                if(pParent->left == pNode && NULL != pParent->right)
+                {
+                    PATH_PUSH(pIter, pParent->right);
+                    return (pParent->right);
+                }
+                pNode = PATH_POP(pIter);
+            }
+            return (NULL);
+        }
+
+        case TREE_ITER_IN_ORDER:
+        {
+            if(NULL != pNode->right)
+            {
+                //! The most left node of right subtree.
+                for(pNode = pNode->right; NULL != pNode; pNode = pNode->left)
+                {
+                    PATH_PUSH(pIter, pNode);
+                }
+                return (PATH_PEEK(pIter));
+            }
+
+            //! Go back until we come from a left child.
+            pNode = PATH_POP(pIter);
+            while(NULL != (pParent = PATH_PEEK(pIter)))
+            {
+                if(pParent->left == pNode)
+                {
+                    return (pParent);
+                }
+                pNode = PATH_POP(pIter);
+            }
+            return (NULL);
+        }
+
+        case TREE_ITER_POST_ORDER:
+        {
+            pNode   = PATH_POP(pIter);
+            pParent = PATH_PEEK(pIter);
+            if(NULL == pParent || pParent->right == pNode || NULL == pParent->right)
+            {
+                return (pParent);
+            }
+
+            //! Left subtree is finished, go to the first node of right subtree.
+            PATH_PUSH(pIter, pParent->right);
+            return (IterPostOrderDown(pIter));
+        }
+
+        default:
+        {
+            return (NULL);
+        }
+    }
+}
+#endif // USE_PARENT_POINTER
+
+//****************************************************************************************
+//! \brief  Start iterating a tree.
+//! Typical usage:
+//! \code
+//!     TreeIter_t  Iter;
+//!     TreeNode_t* pNode;
+//!     for(pNode = Tree_IterFirst(&Iter, pRoot, TREE_ITER_IN_ORDER); NULL != pNode;
+//!         pNode = Tree_IterNext(&Iter))
+//!     {
+//!         ...
+//!     }
+//! \endcode
+//!
+//! \param  [in] pIter is the iterator.
+//! \param  [in] pRoot is the root of tree that want to iterate, nodes above it are
+//!              never visited.
+//! \param  [in] Order is the iterate order, it can be one of the following value:
+//!              - \ref TREE_ITER_PRE_ORDER
+//!              - \ref TREE_ITER_IN_ORDER
+//!              - \ref TREE_ITER_POST_ORDER
+//!              .
+//! \retval the first node, or NULL if tree is empty or parameters are wrong.
+//!
+//! \note
+//!         -# The tree must not be changed while iterating, except the data of nodes.
+//!         -# Without parent pointer, check \ref TREE_ITER_OVERFLOW when NULL is
+//!            returned.
+//****************************************************************************************
+TreeNode_t* Tree_IterFirst(TreeIter_t* pIter, TreeNode_t* pRoot, int Order)
+{
+    TreeNode_t* pNode = NULL;
+
+    //! Check input parameters
+    ASSERT(NULL != pIter);
+
+    pIter->pRoot = pRoot;
+    pIter->pNode = NULL;
+    pIter->Order = Order;
+#ifndef USE_PARENT_POINTER
+    pIter->Top   = 0;
+#endif
+
+    if(NULL == pRoot)
+    {
+        return (NULL);
+    }
+
+#ifdef USE_PARENT_POINTER
+    switch(Order)
+    {
+        case TREE_ITER_PRE_ORDER:  pNode = PreOrderFirst(pRoot);  break;
+        case TREE_ITER_IN_ORDER:   pNode = InOrderFirst(pRoot);   break;
+        case TREE_ITER_POST_ORDER: pNode = PostOrderFirst(pRoot); break;
+        default:                   pNode = NULL;                  break;
+    }
+#else
+    PATH_PUSH(pIter, pRoot);
+    switch(Order)
+    {
+        case TREE_ITER_PRE_ORDER:
+        {
+            pNode = pRoot;
+            break;
+        }
+        case TREE_ITER_IN_ORDER:
+        {
+            for(pNode = pRoot->left; NULL != pNode; pNode = pNode->left)
+            {
+                PATH_PUSH(pIter, pNode);
+            }
+            pNode = PATH_PEEK(pIter);
+            break;
+        }
+        case TREE_ITER_POST_ORDER:
+        {
+            pNode = IterPostOrderDown(pIter);
+            break;
+        }
+        default:
+        {
+            pNode = NULL;
+            break;
+        }
+    }
+#endif // USE_PARENT_POINTER
+
+    pIter->pNode = pNode;
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//! \brief  Get the next node of iterator.
+//!
+//! \param  [in] pIter is the iterator started by \ref Tree_IterFirst.
+//! \retval the next node, or NULL if all nodes have been visited.
+//!
+//! \note   O(1) amortised, every edge of tree is passed twice at most.
+//****************************************************************************************
+TreeNode_t* Tree_IterNext(TreeIter_t* pIter)
+{
+    TreeNode_t* pNode = NULL;
+
+    //! Check input parameters
+    ASSERT(NULL != pIter);
+
+    if(NULL == pIter->pNode)
+    {
+        return (NULL);
+    }
+
+#ifdef USE_PARENT_POINTER
+    switch(pIter->Order)
+    {
+        case TREE_ITER_PRE_ORDER:  pNode = PreOrderNext(pIter->pNode, pIter->pRoot);  break;
+        case TREE_ITER_IN_ORDER:   pNode = InOrderNext(pIter->pNode, pIter->pRoot);   break;
+        case TREE_ITER_POST_ORDER: pNode = PostOrderNext(pIter->pNode, pIter->pRoot); break;
+        default:                   pNode = NULL;                                      break;
+    }
+#else
+    pNode = IterPathNext(pIter);
+#endif // USE_PARENT_POINTER
+
+    pIter->pNode = pNode;
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//!                     BATCH TRAVERSE
+//****************************************************************************************
+
+//! \internal
+//! \brief  Batch of \ref Tree_TraveseBatch, data of nodes are collected in user's buffer.
+typedef struct TreeBatch
+{
+    TreeBatchFun_t pFun ;  //!< User's batch callback.
+    void*          Ctx  ;  //!< Context of callback.
+    void**         ppBuf;  //!< Batch buffer.
+    int            Size ;  //!< Capacity of batch buffer, in entries.
+    int            Count;  //!< Number of entries in use.
+#ifdef USE_TREE_STATS
+    int            Depth   ;  //!< Levels of recursion now, recursive algorithm only.
+    int            DepthMax;  //!< The most levels of recursion, or entries of work stack.
+#endif
+}TreeBatch_t;
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Pass the collected data to user's callback, then empty the batch.
+//! \retval the value of callback.
+//
+//****************************************************************************************
+static int BatchFlush(TreeBatch_t* pBatch)
+{
+    int Count = pBatch->Count;
+
+    pBatch->Count = 0;
+    STATS_ADD(Callbacks, 1);
+
+    return pBatch->pFun(pBatch->Ctx, pBatch->ppBuf, Count);
+}
+
+//! \internal
+//! \brief Put data of node into batch, the batch is passed to callback when it is full,
+//!        and a non-zero value of callback is returned from caller.
+#define BATCH_PUT(pBatch, pNode)                                                      \
+    do                                                                                \
+    {                                                                                 \
+        (pBatch)->ppBuf[(pBatch)->Count++] = (pNode)->data;                           \
+        if((pBatch)->Count == (pBatch)->Size)                                         \
+        {                                                                             \
+            int Ret_ = BatchFlush(pBatch);                                            \
+            if(0 != Ret_)                                                             \
+            {                                                                         \
+                return (Ret_);                                                        \
+            }                                                                         \
+        }                                                                             \
+    } while(0)
+
+#ifdef USE_RECURSIVE_ALGORITHM
+//! \internal
+//! \brief Pre-order batch visit of subtree, return the first non-zero value of callback.
+static int BatchPreOrderVisit(TreeNode_t* pNode, TreeBatch_t* pBatch)
+{
+    int Ret = 0;
+
+    if(NULL == pNode)
+    {
+        return (0);
+    }
+
+    STATS_DEPTH_ENTER(pBatch);
+    BATCH_PUT(pBatch, pNode);
+
+    Ret = BatchPreOrderVisit(pNode->left, pBatch);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    Ret = BatchPreOrderVisit(pNode->right, pBatch);
+    STATS_DEPTH_LEAVE(pBatch);
+
+    return (Ret);
+}
+
+//! \internal
+//! \brief In-order batch visit of subtree, return the first non-zero value of callback.
+static int BatchInOrderVisit(TreeNode_t* pNode, TreeBatch_t* pBatch)
+{
+    int Ret = 0;
+
+    if(NULL == pNode)
+    {
+        return (0);
+    }
+
+    STATS_DEPTH_ENTER(pBatch);
+    Ret = BatchInOrderVisit(pNode->left, pBatch);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    BATCH_PUT(pBatch, pNode);
+
+    Ret = BatchInOrderVisit(pNode->right, pBatch);
+    STATS_DEPTH_LEAVE(pBatch);
+
+    return (Ret);
+}
+
+//! \internal
+//! \brief Post-order batch visit of subtree, return the first non-zero value of callback.
+static int BatchPostOrderVisit(TreeNode_t* pNode, TreeBatch_t* pBatch)
+{
+    int Ret = 0;
+
+    if(NULL == pNode)
+    {
+        return (0);
+    }
+
+    STATS_DEPTH_ENTER(pBatch);
+    Ret = BatchPostOrderVisit(pNode->left, pBatch);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    Ret = BatchPostOrderVisit(pNode->right, pBatch);
+    if(0 != Ret)
+    {
+        return (Ret);
+    }
+
+    STATS_DEPTH_LEAVE(pBatch);
+    BATCH_PUT(pBatch, pNode);
+
+    return (0);
+}
+
+//! \internal
+//! \brief Batch visit of tree in Order.
+static int BatchWalk(TreeNode_t* pNode, int Order, TreeBatch_t* pBatch)
+{
+    switch(Order)
+    {
+        case TREE_ITER_PRE_ORDER:  return BatchPreOrderVisit(pNode, pBatch);
+        case TREE_ITER_IN_ORDER:   return BatchInOrderVisit(pNode, pBatch);
+        default:                   return BatchPostOrderVisit(pNode, pBatch);
+    }
+}
+#endif // USE_RECURSIVE_ALGORITHM
+
+#ifdef USE_STACK_ALGORITHM
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Pre-order batch visit of tree, the loop of \ref Tree_TravesePreOrderEx.
+//! \retval 0 if all nodes are visited, \ref ERR_MEM if pStack is full, or the first
+//!         non-zero value of callback.
+//
+//****************************************************************************************
+static int BatchPreOrderWalk(TreeNode_t* pNode, TreeBatch_t* pBatch, TreeStack_t* pStack)
+{
+    STACK_CLEAR(pStack);
+    while(NULL != pNode)
+    {
+        NODE_PREFETCH(pNode->left);
+        NODE_PREFETCH(pNode->right);
+        BATCH_PUT(pBatch, pNode);
+
+        if(NULL != pNode->left)
+        {
+            if(NULL != pNode->right)
+            {
+                STACK_PUSH(pStack, pNode->right);
+            }
+            pNode = pNode->left;
+        }
+        else if(NULL != pNode->right)
+        {
+            pNode = pNode->right;
+        }
+        else
+        {
+            pNode = (0 != pStack->Top) ? STACK_POP(pStack) : NULL;
+        }
+    }
+
+    return (0);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  In-order batch visit of tree, the loop of \ref Tree_TraveseInOrderEx.
+//! \retval 0 if all nodes are visited, \ref ERR_MEM if pStack is full, or the first
+//!         non-zero value of callback.
+//
+//****************************************************************************************
+static int BatchInOrderWalk(TreeNode_t* pNode, TreeBatch_t* pBatch, TreeStack_t* pStack)
+{
+    STACK_CLEAR(pStack);
+    while(NULL != pNode || 0 != pStack->Top)
+    {
+        if(NULL == pNode)
+        {
+            pNode = STACK_POP(pStack);
+        }
+        else if(NULL != pNode->left)
+        {
+            DATA_PREFETCH(pNode);
+            STACK_PUSH(pStack, pNode);
+            pNode = pNode->left;
+            continue;
+        }
+
+        NODE_PREFETCH(pNode->right);
+        BATCH_PUT(pBatch, pNode);
+        pNode = pNode->right;
+    }
+
+    return (0);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Post-order batch visit of tree, the loop of \ref Tree_TravesePostOrderEx.
+//! \retval 0 if all nodes are visited, \ref ERR_MEM if pStack is full, or the first
+//!         non-zero value of callback.
+//
+//****************************************************************************************
+static int BatchPostOrderWalk(TreeNode_t* pNode, TreeBatch_t* pBatch, TreeStack_t* pStack)
+{
+    TreeNode_t* pLast = NULL;
+    TreeNode_t* pTop  = NULL;
+
+    STACK_CLEAR(pStack);
+    while(NULL != pNode || 0 != pStack->Top)
+    {
+        if(NULL != pNode)
+        {
+            NODE_PREFETCH(pNode->right);
+            DATA_PREFETCH(pNode);
+            STACK_PUSH(pStack, pNode);
+            pNode = pNode->left;
+        }
+        else
+        {
+            pTop = STACK_PEEK(pStack);
+            if(NULL != pTop->right && pLast != pTop->right)
+            {
+                pNode = pTop->right;
+            }
+            else
+            {
+                BATCH_PUT(pBatch, pTop);
+                pLast = STACK_POP(pStack);
+            }
+        }
+    }
+
+    return (0);
+}
+
+//! \internal
+//! \brief Batch visit of tree in Order with work stack.
+static int BatchStackWalk(TreeNode_t* pNode, int Order, TreeBatch_t* pBatch, TreeStack_t* pStack)
+{
+    int Ret = 0;
+
+    switch(Order)
+    {
+        case TREE_ITER_PRE_ORDER: Ret = BatchPreOrderWalk(pNode, pBatch, pStack); break;
+        case TREE_ITER_IN_ORDER:  Ret = BatchInOrderWalk(pNode, pBatch, pStack);  break;
+        default:                  Ret = BatchPostOrderWalk(pNode, pBatch, pStack); break;
+    }
+
+#ifdef USE_TREE_STATS
+    pBatch->DepthMax = pStack->Peak;
+#endif
+    return (Ret);
+}
+
+#ifdef STACK_PARENT_WALK
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Batch visit of tree in Order by parent pointer, no stack is used.
+//! \retval 0 if all nodes are visited, or the first non-zero value of callback.
+//
+//****************************************************************************************
+static int BatchWalk(TreeNode_t* pRoot, int Order, TreeBatch_t* pBatch)
+{
+    TreeNode_t* pNode = NULL;
 
-        //! Update parent's child pointer.
-        if(pParent->left == pNode)
+    switch(Order)
+    {
+        case TREE_ITER_PRE_ORDER:
         {
-            pParent->left = NULL;
+            for(pNode = PreOrderFirst(pRoot); NULL != pNode; pNode = PreOrderNext(pNode, pRoot))
+            {
+                NODE_PREFETCH(pNode->left);
+                NODE_PREFETCH(pNode->right);
+                BATCH_PUT(pBatch, pNode);
+            }
+            break;
         }
-
-        if(pParent->right == pNode)
+        case TREE_ITER_IN_ORDER:
         {
-            pParent->right = NULL;
+            for(pNode = InOrderFirst(pRoot); NULL != pNode; pNode = InOrderNext(pNode, pRoot))
+            {
+                NODE_PREFETCH(pNode->right);
+                BATCH_PUT(pBatch, pNode);
+            }
+            break;
+        }
+        default:
+        {
+            for(pNode = PostOrderFirst(pRoot); NULL != pNode; pNode = PostOrderNext(pNode, pRoot))
+            {
+                BATCH_PUT(pBatch, pNode);
+            }
+            break;
         }
     }
 
-    //! Reset Node Field.
-    Tree_NodeInit(pNode);
+    return (0);
+}
+#else
+//! \internal
+//! \brief Batch visit of tree in Order with default work stack, see <TREE_STACK_DEPTH>.
+static int BatchWalk(TreeNode_t* pNode, int Order, TreeBatch_t* pBatch)
+{
+    TreeNode_t* Buf[TREE_STACK_DEPTH];
+    TreeStack_t Stack;
+    int         Ret = 0;
 
-    return (ERR_SUCCESS);
+    StackDefaultInit(&Stack, Buf);
+    Ret = BatchStackWalk(pNode, Order, pBatch, &Stack);
+    StackDefaultRelease(&Stack);
+
+    return (Ret);
 }
+#endif // STACK_PARENT_WALK
+#endif // USE_STACK_ALGORITHM
 
 //****************************************************************************************
-//
-//! \brief  Destory subtree in static method.
+//! \brief  Foreach Tree Node in batch.
+//! This function collect the data pointers of up to Size nodes into ppBuf, then call
+//! pFun once for them, so one indirect call is paid for every Size nodes and pFun can
+//! work on an array (unroll, vectorize or prefetch the following payloads).
 //!
-//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
-//! \retval \ref ERR_FAILURE if successed, otherwise return \ref ERR_SUCCESS.
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] Order is the visit order, the same as Order parameter of
+//!              \ref Tree_IterFirst.
+//! \param  [in] pFun is the user's batch callback.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] ppBuf is the batch buffer supplied by user.
+//! \param  [in] Size is the number of entries of ppBuf, it should be > 0.
 //!
-//! \note   
-//!         -# Dynamic API can not be used mix with static API.
-//
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Order
+//!         or Size is wrong, \ref ERR_MEM if the default work stack can not hold this
+//!         tree (stack algorithm only, see <TREE_STACK_DEPTH>).
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   Nodes are walked by the same loops as \ref Tree_TravesePreOrder,
+//!         \ref Tree_TraveseInOrder and \ref Tree_TravesePostOrder, and data are put
+//!         into ppBuf in the loop, so the depth of tree is limited the same way.
 //****************************************************************************************
-TreeErrorCode_t Tree_SubTreeDelete_Static(TreeNode_t** ppNode)
+TreeErrorCode_t Tree_TraveseBatch(TreeNode_t* pNode, int Order, TreeBatchFun_t pFun, void* Ctx,
+                                  void** ppBuf, int Size)
 {
-    TreeNode_t * pNode = NULL;
-
-    //! Check input parameter
-    ASSERT(NULL != ppNode);
-    pNode = *ppNode;
+    TreeBatch_t Batch;
+    int         Ret = 0;
+    STATS_TIMER(Start);
 
-    //! Check input parameter.
-    if(NULL == pNode)
+    //! Check input parameters
+    if(NULL == pNode || NULL == pFun || NULL == ppBuf)
     {
-        return  ERR_FAILURE;
+        return (ERR_INVALID_POINTER);
     }
 
-    Tree_SubTreeDelete_Static(&pNode->left);
-    Tree_SubTreeDelete_Static(&pNode->right);
-
-    Tree_NodeDelete(pNode);
+    if(Size <= 0 || Order < TREE_ITER_PRE_ORDER || Order > TREE_ITER_POST_ORDER)
+    {
+        return (ERR_WRONG_PARAM);
+    }
 
-    //! \bug Can not set node value to NULL
-    *ppNode = NULL;
+    Batch.pFun  = pFun;
+    Batch.Ctx   = Ctx;
+    Batch.ppBuf = ppBuf;
+    Batch.Size  = Size;
+    Batch.Count = 0;
+    STATS_DEPTH_INIT(&Batch);
 
-    return (ERR_SUCCESS);
-}
+    Ret = BatchWalk(pNode, Order, &Batch);
+    if(ERR_MEM == Ret)
+    {
+        return (ERR_MEM);
+    }
 
+#ifndef STACK_PARENT_WALK
+    STATS_DEPTH(Batch.DepthMax);
+#endif
 
-//****************************************************************************************
-//! \brief  Get the depth of tree.
-//!
-//! \param  [in] pNode is the root of tree.
-//! \retval the depth of tree checked, it should >= 1, return zero indicates pNode is
-//!         an invalid node.
-//****************************************************************************************
-int Tree_DepthGet(TreeNode_t* pNode)
-{
-    int Deep = 0;
-    if(NULL != pNode)
+    //! The last batch which is not full.
+    if(0 == Ret && 0 != Batch.Count)
     {
-        int LChildDeep = Tree_DepthGet(pNode->left);
-        int RChildDeep = Tree_DepthGet(pNode->right);
-        Deep = (LChildDeep >= RChildDeep)?(LChildDeep+1):(RChildDeep+1);
+        Ret = BatchFlush(&Batch);
     }
 
-    return Deep;
+    STATS_END(Travese, Start);
+    return ((TreeErrorCode_t)Ret);
 }
 
+#ifdef USE_STACK_ALGORITHM
 //****************************************************************************************
-//! \brief  Set Node value.
-//!
-//! \param  [in] pNode is the target tree node.
-//! \param  [in] Value is the address of data.
-//! \retval \ref ERR_SUCCESS if set node value successfully, \ref ERR_INVALID_POINTER
-//!         if input parameters contain invalid pointer.
-//!
-//! \note   The tree node just store the pointer of data, so, we can use this tree
-//!         to store any type of data. <General Programming Method>, Here is a code
-//!         snippet for you.
-//! \code
-//!
-//! typedef struct STUDENT
-//! {
-//!     char*   name;
-//!     uint8_t age;
-//!     uint8_t sex;
-//!     uint8_t class;
-//! }STUDENT;
-//!
-//! STUDENT Class_1[20];
-//! ...
+//! \brief  Init work stack.
 //!
-//! Tree_NodeValueSet(Node[0], (void*)&Class_1[0]);
+//! \param  [in] pStack is the work stack.
+//! \param  [in] pBuf is the stack buffer, it must be valid while the stack is in use.
+//! \param  [in] Size is the number of entries of pBuf.
 //!
-//! \endcode
-//
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
 //****************************************************************************************
-TreeErrorCode_t Tree_NodeValueSet(TreeNode_t* pNode, void* Value)
+void Tree_StackInit(TreeStack_t* pStack, TreeNode_t** pBuf, int Size)
 {
-    //! Check input parameters.
-    if(NULL == pNode)
-    {
-        return (ERR_INVALID_POINTER);
-    }
-
-    //! Fill Node value
-    pNode->data = Value;
+    //! Check input parameter
+    ASSERT(NULL != pStack);
+    ASSERT(NULL != pBuf || 0 == Size);
 
-    return (ERR_SUCCESS);
+    pStack->pBase = pBuf;
+    pStack->Size  = Size;
+    pStack->Top   = 0;
+#ifdef USE_DYNAMIC_MEMORY
+    pStack->Grow  = STACK_GROW_NONE;
+#endif
+#ifdef USE_TREE_STATS
+    pStack->Peak  = 0;
+#endif
 }
 
 //****************************************************************************************
-//! \brief  Get Node value.
-//!
-//! \param  [in] pNode is the target tree node.
-//! \retval the address of data that stored in tree node.
-//!
-//! \note   The tree node just store the pointer of data, so, we can use this tree
-//!         to store any type of data. <General Programming Method>, Here is a code
-//!         snippet for you.
-//! \code
-//!
-//! typedef struct STUDENT
-//! {
-//!     char*   name;
-//!     uint8_t age;
-//!     uint8_t sex;
-//!     uint8_t class;
-//! }STUDENT;
-//!
-//! STUDENT Class_1[20];
-//! STUDENT* pStudent = NULL;
-//! ...
+//! \brief  Get the depth of tree with user's work stack.
 //!
-//! pStudent = (STUDENT*) Tree_NodeValueGet(Node[0]);
+//! \param  [in] pNode is the root of tree.
+//! \param  [in] pStack is the work stack, it need (depth of tree) entries.
+//! \retval the depth of tree checked, it should >= 1, return zero indicates pNode is
+//!         an invalid node, return -1 if pStack is too small for this tree.
 //!
-//! \endcode
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
 //****************************************************************************************
-void* Tree_NodeValueGet(TreeNode_t* pNode)
+int Tree_DepthGetEx(TreeNode_t* pNode, TreeStack_t* pStack)
 {
-    //! Check input parameters.
-    if(NULL == pNode)
+    TreeNode_t* pLast = NULL;
+    TreeNode_t* pTop  = NULL;
+    int         Deep  = 0;
+
+    //! Check input parameter
+    ASSERT(NULL != pStack);
+
+    //! Post-order walk, the stack always hold the path from root to current node.
+    pStack->Top = 0;
+    while(NULL != pNode || 0 != pStack->Top)
     {
-        return (NULL);
+        if(NULL != pNode)
+        {
+            if(pStack->Top >= pStack->Size && ERR_SUCCESS != STACK_GROW(pStack))
+            {
+                return (-1);
+            }
+            pStack->pBase[pStack->Top++] = pNode;
+
+            if(pStack->Top > Deep)
+            {
+                Deep = pStack->Top;
+            }
+            pNode = pNode->left;
+        }
+        else
+        {
+            pTop = STACK_PEEK(pStack);
+            if(NULL != pTop->right && pLast != pTop->right)
+            {
+                pNode = pTop->right;
+            }
+            else
+            {
+                pLast = STACK_POP(pStack);
+            }
+        }
     }
 
-    //! Return data field.
-    return (pNode->data);
+    return Deep;
 }
 
 //****************************************************************************************
-//! \brief  Append an node.
-//! This function append an new node to an existing node.
+//! \brief  Foreach Tree Node with user's work stack.
+//! This function visit all tree node in pre-order algorithm.
 //!
-//! \param  [in] pNode is the address of exising node, new node will be
-//!         inserted behind it.
-//! \param  [in] pNewNode is the address of node that want to insert.
-//! \param  [in] Mode control insert point of node.
-//!              the parameter can be one of the following value:
-//!              - \ref INSERT_POS_LEFT  New node will be appended to left child.
-//!              - \ref INSERT_POS_RIGHT New node will be appended to right child.
-//!              .
-//! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
-//!         input parameters contain invalid pointer, \ref ERR_NODE_EXIST if the
-//!         child node is not empty, \ref ERR_WRONG_PARAM if Mode parameter is
-//!         wrong.
-//! \note   This function is designed for tree end node.
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] pStack is the work stack, one entry is used for every node on current
+//!              path which has both left and right child.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if pStack is too
+//!         small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
 //****************************************************************************************
-TreeErrorCode_t Tree_NodeAppend(TreeNode_t* pNode, TreeNode_t* pNewNode, int Mode)
+TreeErrorCode_t Tree_TravesePreOrderEx(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                                       TreeStack_t* pStack)
 {
+    int Ret = 0;
+    STATS_TIMER(Start);
 
-    //! Check input parameters
-    if(NULL == pNode || NULL == pNewNode)
+    if(NULL == pNode || NULL == pFun || NULL == pStack)
     {
         return (ERR_INVALID_POINTER);
     }
 
-    //! Check mode parameter.
-    if(0 != (Mode & (~INSERT_MODE_MASK)))
+    STACK_CLEAR(pStack);
+    while(NULL != pNode)
     {
-        return (ERR_WRONG_PARAM);
-    }
+        //! Children are loaded while callback is running.
+        NODE_PREFETCH(pNode->left);
+        NODE_PREFETCH(pNode->right);
 
-    //! Append Left Node
-    if((Mode & INSERT_MODE_MASK) == INSERT_POS_LEFT)
-    {
-        if(NULL == pNode->left)
+        STATS_ADD(Callbacks, 1);
+        Ret = pFun(Ctx, pNode->data);
+        if(0 != Ret)
         {
-            pNode->left      = pNewNode;
-            pNewNode->parent = pNode;
-            return (ERR_SUCCESS);
+            STATS_DEPTH(pStack->Peak);
+            STATS_END(Travese, Start);
+            return ((TreeErrorCode_t)Ret);
         }
-        else
+
+        if(NULL != pNode->left)
         {
-            return (ERR_NODE_EXIST);
+            //! Right child is visited after the whole left subtree.
+            if(NULL != pNode->right)
+            {
+                STACK_PUSH(pStack, pNode->right);
+            }
+            pNode = pNode->left;
         }
-    }
-
-    //! Append Right Node
-    if((Mode & INSERT_MODE_MASK) == INSERT_POS_RIGHT)
-    {
-        if(NULL == pNode->right)
+        else if(NULL != pNode->right)
         {
-            pNode->right     = pNewNode;
-            pNewNode->parent = pNode;
-            return (ERR_SUCCESS);
+            pNode = pNode->right;
         }
         else
         {
-            return (ERR_NODE_EXIST);
+            pNode = (0 != pStack->Top) ? STACK_POP(pStack) : NULL;
         }
     }
 
-    //! Note:In normal conditions, program can not run to here.
-    return (ERR_WRONG_PARAM);
-
+    STATS_DEPTH(pStack->Peak);
+    STATS_END(Travese, Start);
+    return (ERR_SUCCESS);
 }
 
 //****************************************************************************************
-//! \brief  Foreach Tree Node.
-//! This function visit all tree node in pre-order algorithm.
+//! \brief  Foreach Tree Node with user's work stack.
+//! This function visit all tree node in in-order algorithm.
 //!
 //! \param  [in] pNode is the root of tree that want to traver.
 //! \param  [in] pFun is the user's callback which can do something with every node data
 //!              of the tree.
 //! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] pStack is the work stack, one entry is used for every node on current
+//!              path which has left child.
 //!
 //! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
-//!         input parameters contain invalid pointer.
+//!         input parameters contain invalid pointer, \ref ERR_MEM if pStack is too
+//!         small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
 //****************************************************************************************
-TreeErrorCode_t Tree_TravesePreOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+TreeErrorCode_t Tree_TraveseInOrderEx(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                                      TreeStack_t* pStack)
 {
-    if(NULL == pNode || NULL == pFun)
+    int Ret = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun || NULL == pStack)
     {
         return (ERR_INVALID_POINTER);
     }
 
-    pFun(Ctx, pNode->data);
-    Tree_TravesePreOrder(pNode->left, pFun, Ctx);
-    Tree_TravesePreOrder(pNode->right, pFun, Ctx);
+    STACK_CLEAR(pStack);
+    while(NULL != pNode || 0 != pStack->Top)
+    {
+        if(NULL == pNode)
+        {
+            //! Left subtree is finished, visit its parent.
+            pNode = STACK_POP(pStack);
+        }
+        else if(NULL != pNode->left)
+        {
+            //! Node is visited after its left subtree.
+            DATA_PREFETCH(pNode);
+            STACK_PUSH(pStack, pNode);
+            pNode = pNode->left;
+            continue;
+        }
+
+        NODE_PREFETCH(pNode->right);
+        STATS_ADD(Callbacks, 1);
+        Ret = pFun(Ctx, pNode->data);
+        if(0 != Ret)
+        {
+            STATS_DEPTH(pStack->Peak);
+            STATS_END(Travese, Start);
+            return ((TreeErrorCode_t)Ret);
+        }
+        pNode = pNode->right;
+    }
 
+    STATS_DEPTH(pStack->Peak);
+    STATS_END(Travese, Start);
     return (ERR_SUCCESS);
 }
 
 //****************************************************************************************
-//! \brief  Foreach Tree Node.
-//! This function visit all tree node in in-order algorithm.
+//! \brief  Foreach Tree Node with user's work stack.
+//! This function visit all tree node in post-order algorithm.
 //!
 //! \param  [in] pNode is the root of tree that want to traver.
 //! \param  [in] pFun is the user's callback which can do something with every node data
 //!              of the tree.
 //! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] pStack is the work stack, it need (depth of tree) entries.
 //!
 //! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
-//!         input parameters contain invalid pointer.
+//!         input parameters contain invalid pointer, \ref ERR_MEM if pStack is too
+//!         small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
 //****************************************************************************************
-TreeErrorCode_t Tree_TraveseInOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+TreeErrorCode_t Tree_TravesePostOrderEx(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                                        TreeStack_t* pStack)
 {
-    if(NULL == pNode || NULL == pFun)
+    TreeNode_t* pLast = NULL;
+    TreeNode_t* pTop  = NULL;
+    int         Ret   = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun || NULL == pStack)
     {
         return (ERR_INVALID_POINTER);
     }
 
-    Tree_TraveseInOrder(pNode->left, pFun, Ctx);
-    pFun(Ctx, pNode->data);
-    Tree_TraveseInOrder(pNode->right, pFun, Ctx);
+    //! The stack always hold the path from root to current node.
+    STACK_CLEAR(pStack);
+    while(NULL != pNode || 0 != pStack->Top)
+    {
+        if(NULL != pNode)
+        {
+            //! Right subtree and node itself are visited after left subtree.
+            NODE_PREFETCH(pNode->right);
+            DATA_PREFETCH(pNode);
+            STACK_PUSH(pStack, pNode);
+            pNode = pNode->left;
+        }
+        else
+        {
+            pTop = STACK_PEEK(pStack);
+            if(NULL != pTop->right && pLast != pTop->right)
+            {
+                pNode = pTop->right;
+            }
+            else
+            {
+                STATS_ADD(Callbacks, 1);
+                Ret = pFun(Ctx, pTop->data);
+                if(0 != Ret)
+                {
+                    STATS_DEPTH(pStack->Peak);
+                    STATS_END(Travese, Start);
+                    return ((TreeErrorCode_t)Ret);
+                }
+                pLast = STACK_POP(pStack);
+            }
+        }
+    }
 
+    STATS_DEPTH(pStack->Peak);
+    STATS_END(Travese, Start);
     return (ERR_SUCCESS);
 }
-
 //****************************************************************************************
-//! \brief  Foreach Tree Node.
-//! This function visit all tree node in post-order algorithm.
+//! \brief  Foreach Tree Node in batch with user's work stack.
+//! The same as \ref Tree_TraveseBatch, nodes are walked by the loops of
+//! \ref Tree_TravesePreOrderEx, \ref Tree_TraveseInOrderEx and
+//! \ref Tree_TravesePostOrderEx, and data are put into ppBuf in the loop.
 //!
 //! \param  [in] pNode is the root of tree that want to traver.
-//! \param  [in] pFun is the user's callback which can do something with every node data
-//!              of the tree.
+//! \param  [in] Order is the visit order, the same as Order parameter of
+//!              \ref Tree_IterFirst.
+//! \param  [in] pFun is the user's batch callback.
 //! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] ppBuf is the batch buffer supplied by user.
+//! \param  [in] Size is the number of entries of ppBuf, it should be > 0.
+//! \param  [in] pStack is the work stack, it need the entries of the _Ex function of
+//!              the same order.
 //!
 //! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
-//!         input parameters contain invalid pointer.
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Order
+//!         or Size is wrong, \ref ERR_MEM if pStack is too small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
 //****************************************************************************************
-TreeErrorCode_t Tree_TravesePostOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+TreeErrorCode_t Tree_TraveseBatchEx(TreeNode_t* pNode, int Order, TreeBatchFun_t pFun, void* Ctx,
+                                    void** ppBuf, int Size, TreeStack_t* pStack)
 {
-    if(NULL == pNode || NULL == pFun)
+    TreeBatch_t Batch;
+    int         Ret = 0;
+    STATS_TIMER(Start);
+
+    //! Check input parameters
+    if(NULL == pNode || NULL == pFun || NULL == ppBuf || NULL == pStack)
     {
         return (ERR_INVALID_POINTER);
     }
 
-    Tree_TravesePostOrder(pNode->left, pFun, Ctx);
-    Tree_TravesePostOrder(pNode->right, pFun, Ctx);
-    pFun(Ctx, pNode->data);
+    if(Size <= 0 || Order < TREE_ITER_PRE_ORDER || Order > TREE_ITER_POST_ORDER)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    Batch.pFun  = pFun;
+    Batch.Ctx   = Ctx;
+    Batch.ppBuf = ppBuf;
+    Batch.Size  = Size;
+    Batch.Count = 0;
+    STATS_DEPTH_INIT(&Batch);
 
-    return (ERR_SUCCESS);
+    Ret = BatchStackWalk(pNode, Order, &Batch, pStack);
+    if(ERR_MEM == Ret)
+    {
+        return (ERR_MEM);
+    }
+
+    STATS_DEPTH(Batch.DepthMax);
+
+    //! The last batch which is not full.
+    if(0 == Ret && 0 != Batch.Count)
+    {
+        Ret = BatchFlush(&Batch);
+    }
+
+    STATS_END(Travese, Start);
+    return ((TreeErrorCode_t)Ret);
 }
+
+#endif // USE_STACK_ALGORITHM
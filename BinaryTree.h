@@ -9,13 +9,13 @@
 //! \date    2013-11-26
 //! \email   xuesong5825718@gmail.com
 //!
-//! \note    Only recursive algorithm is supported in current version.
+//! \note    Both recursive and stack algorithm are supported, see
+//!          <USE_RECURSIVE_ALGORITHM> and <USE_STACK_ALGORITHM>.
 //! 
 //! \bug    
 //!          -# Destory/Delete API can not set node pointer to NULL.
 //! 
 //! \todo
-//!          -# Implement Stack Algorithm.
 //!          -# Add Usage Example   
 //! \license
 //!
@@ -44,6 +44,9 @@
 #ifndef __BINARYTREE_H__
 #define __BINARYTREE_H__
 
+#include <limits.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -63,17 +66,206 @@ extern "C"
 //! \note Default: Allocate function is DISABLED.
 //#define USE_DYNAMIC_MEMORY
 
+//! Use per-thread node cache for allocate function ?
+//! Uncomment <USE_NODE_CACHE> macro to let \ref Tree_NodeCreate, \ref Tree_NodeDestory
+//! and every dynamic delete function get/put node from a cache of calling thread,
+//! caches exchange nodes in batches through a shared lock free pool, so threads do not
+//! contend on the lock of malloc. The API is not changed.
+//!
+//! \note
+//!      - Default: Node cache is DISABLED.
+//!      - MUST uncomment <USE_DYNAMIC_MEMORY> macro, and link BinaryTreeMT.c with
+//!        -lpthread, see \ref Tree_NodeCacheAlloc.
+//#define USE_NODE_CACHE
+
+#if defined(USE_NODE_CACHE) && !defined(USE_DYNAMIC_MEMORY)
+#error "USE_NODE_CACHE need USE_DYNAMIC_MEMORY."
+#endif
+
+//! Collect statistics of hot paths ?
+//! Uncomment <USE_TREE_STATS> macro to count node allocs/frees, appends and failed
+//! appends, callback calls, traverse calls (mean and max work depth) and search tree
+//! descents (mean and max depth), and to record latency histograms of traverse and
+//! subtree delete functions, into the block bound to calling thread by
+//! \ref Tree_StatsBind. Export them by \ref Tree_StatsSnapshot.
+//!
+//! \note
+//!      - Default: Statistics is DISABLED, every hook is compiled out.
+//!      - MUST link BinaryTreeStats.c, see BinaryTreeStats.h.
+//!      - Latency and depth of the call that return \ref ERR_MEM for a full work
+//!        stack/queue are not recorded.
+//#define USE_TREE_STATS
+
+//! Store parent pointer in tree node ?
+//! Parent pointer let a node be unlinked by its address only, and it is followed by
+//! parent pointer walker to go back. Comment out <USE_PARENT_POINTER> macro to save
+//! one pointer of every node, then the following functions are NOT available:
+//! - \ref Tree_NodeDelete, use \ref Tree_NodeRemove instead.
+//! - \ref Tree_TravesePreOrder_Parent
+//! - \ref Tree_TraveseInOrder_Parent
+//! - \ref Tree_TravesePostOrder_Parent
+//!
+//! \note
+//!      - Default: Parent pointer is ENABLED.
+//!      - Without parent pointer, \ref Tree_NodeDestory, \ref Tree_PoolFree and every
+//!        subtree delete function clear the parent's link through their ppNode
+//!        parameter, so ppNode must be the address of parent's left/right field (or
+//!        of the root pointer).
+#define USE_PARENT_POINTER
+
+//! Cache subtree height and size in tree node ?
+//! Uncomment <USE_NODE_AUGMENT> macro to store the height and the node count of
+//! subtree in every node. They are updated from the changed node up to root by
+//! every function that link or unlink node, then
+//! - \ref Tree_DepthGet and \ref Tree_SizeGet are O(1).
+//! - \ref Tree_NodeSelect and \ref Tree_NodeRank are O(depth).
+//! Call \ref Tree_NodeAugmentUpdate after changing left/right/parent field by hand.
+//!
+//! \note
+//!      - Default: Node augment is DISABLED.
+//!      - MUST keep <USE_PARENT_POINTER> macro in order to use node augment.
+//#define USE_NODE_AUGMENT
+
+#if defined(USE_NODE_AUGMENT) && !defined(USE_PARENT_POINTER)
+#error "USE_NODE_AUGMENT need USE_PARENT_POINTER to update the cached fields of ancestors."
+#endif
+
+//! Use persistent (versioned) tree ?
+//! Uncomment <USE_PERSISTENT_NODE> macro to store a reference count in every node, then
+//! \ref Tree_PersistAppend and \ref Tree_PersistDelete update a tree by path copying:
+//! only the nodes from root to the changed node are copied, the other nodes are shared
+//! by the new version, and the old root is still a valid version. Every version is
+//! traversed by the functions without _Parent suffix, and it is freed by
+//! \ref Tree_PersistRelease, which free only the nodes no more version use.
+//!
+//! \note
+//!      - Default: Persistent node is DISABLED.
+//!      - A shared node has one parent pointer but a parent in every version using it,
+//!        so the parent pointer of shared node is not updated, and _Parent functions
+//!        can only be used on a tree that is never updated by path copying.
+//#define USE_PERSISTENT_NODE
+
+//! Store user data in tree node ?
+//! By default, tree node store the pointer of user data. Uncomment <USE_INLINE_DATA>
+//! macro to store <TREE_DATA_SIZE> bytes of user data in tree node, then
+//! - \ref Tree_NodeValueSet copy TREE_DATA_SIZE bytes from Value into node.
+//! - \ref Tree_NodeValueGet return the address of data stored in node.
+//! - Data parameter of \ref TreeCallBackFun_t is the address of data stored in node.
+//! So traverse functions touch only the node itself, not another data block.
+//!
+//! \note
+//!      - Default: Inline data is DISABLED.
+//!      - Inline data is the last field of node, so it is aligned to pointer size.
+//#define USE_INLINE_DATA
+
+//! Size of user data stored in tree node, in bytes.
+//!
+//! \note Default: 16 bytes, only valid when <USE_INLINE_DATA> is selected.
+#ifndef TREE_DATA_SIZE
+#define TREE_DATA_SIZE         16
+#endif
+
+//! Prefetch nodes in traverse loops ?
+//! Uncomment <USE_PREFETCH> macro to let traverse functions issue prefetch for nodes
+//! and user data which are visited a few steps later, so cache misses of pointer
+//! chasing are overlapped with the work of callback. It helps trees that are much
+//! bigger than cache, see Benchmark/TraverseBench.c. The following functions are
+//! affected:
+//! - \ref Tree_TravesePreOrderEx, \ref Tree_TraveseInOrderEx and
+//!   \ref Tree_TravesePostOrderEx and their default stack wrappers.
+//! - \ref Tree_TraveseLevelOrder and \ref Tree_TraveseLevelOrderEx, nodes and data are
+//!   prefetched from the queue, see <TREE_PREFETCH_DISTANCE>.
+//! - \ref Tree_TraveseBatch and \ref Tree_TraveseBatchEx, nodes and data are prefetched
+//!   in the same loops as the _Ex functions.
+//! - \ref Tree_BstFindBatch, the next node of every descent in flight is prefetched.
+//!
+//! \note
+//!      - Default: Prefetch is DISABLED.
+//!      - \ref TREE_PREFETCH is a no-op on compilers without __builtin_prefetch.
+//#define USE_PREFETCH
+
+//! Prefetch distance of level-order traversal, in queue entries.
+//! Queued nodes are prefetched when they are put, the user data of the entry
+//! <TREE_PREFETCH_DISTANCE> positions ahead is prefetched before every callback.
+//!
+//! \note Default: 16 entries, only valid when <USE_PREFETCH> is selected.
+#ifndef TREE_PREFETCH_DISTANCE
+#define TREE_PREFETCH_DISTANCE 16
+#endif
+
+#if TREE_PREFETCH_DISTANCE < 1
+#error "TREE_PREFETCH_DISTANCE MUST be at least 1."
+#endif
+
+//! \brief Prefetch the memory at address p for read, it never fault.
+//! It can be used in user's callback too, for example \ref TreeBatchFun_t.
+#if defined(USE_PREFETCH) && (defined(__GNUC__) || defined(__clang__))
+#define TREE_PREFETCH(p)       __builtin_prefetch((const void*)(p))
+#else
+#define TREE_PREFETCH(p)       ((void)0)
+#endif
+
 //! Select Tree algorithm implement type.
 //! Binary Tree algorithm can be implemented with two different method:
 //! -# Recursive
 //! -# Stack
 //!
 //! \note
-//!      - Can only select one at one time.
-//!      - Only Recursive algorithm is supported in current version.
+//!      - Can only select one at one time, Recursive algorithm is selected when
+//!        <USE_STACK_ALGORITHM> is not defined.
+//!      - Stack algorithm never call itself, traverse/depth functions use an explicit
+//!        work stack and subtree delete functions need no stack at all, so the depth
+//!        of tree is not limited by the size of call stack.
 //!
-#define USE_RECURSIVE_ALGORITHM
 //#define USE_STACK_ALGORITHM
+#ifndef USE_STACK_ALGORITHM
+#define USE_RECURSIVE_ALGORITHM
+#endif
+
+#if defined(USE_RECURSIVE_ALGORITHM) && defined(USE_STACK_ALGORITHM)
+#error "USE_RECURSIVE_ALGORITHM and USE_STACK_ALGORITHM can not be selected at one time."
+#endif
+
+//! Default work stack depth of stack algorithm.
+//! Traverse functions without an explicit \ref TreeStack_t parameter start with a work
+//! stack of <TREE_STACK_DEPTH> entries which is located on the call stack, then
+//! - With <USE_DYNAMIC_MEMORY>, the stack is moved to heap and doubled when it is full,
+//!   so the depth of tree is not limited, \ref ERR_MEM means malloc failed.
+//! - Otherwise with <USE_PARENT_POINTER>, parent pointer walkers are used instead and
+//!   no stack is needed, see \ref Tree_TravesePreOrder_Parent.
+//! - Otherwise they return \ref ERR_MEM when the tree need more entries. It's also the
+//!   case of <USE_PERSISTENT_NODE>, shared nodes have no valid parent pointer.
+//! The _Ex version of these functions use caller's stack, its size is a hard cap of
+//! memory. \ref Tree_DepthGet needs no stack at all.
+//!
+//! \note Default: 64 entries, only valid when <USE_STACK_ALGORITHM> is selected.
+#ifndef TREE_STACK_DEPTH
+#define TREE_STACK_DEPTH       64
+#endif
+
+//! Path stack depth of iterator.
+//! Without parent pointer, \ref TreeIter_t keep the path from root to current node in
+//! an array of <TREE_ITER_DEPTH> entries, iteration stops when the tree is deeper.
+//!
+//! \note Default: 64 entries, only valid when <USE_PARENT_POINTER> is not selected.
+#ifndef TREE_ITER_DEPTH
+#define TREE_ITER_DEPTH        64
+#endif
+
+//! Default work queue size of level-order traversal.
+//! \ref Tree_TraveseLevelOrder start with a ring buffer queue of <TREE_QUEUE_SIZE>
+//! entries which is located on the call stack, then
+//! - With <USE_DYNAMIC_MEMORY>, the queue is moved to heap and doubled when it is full,
+//!   so the width of tree is not limited, \ref ERR_MEM means malloc failed.
+//! - Otherwise the tree is walked once without callback to check that the queue is big
+//!   enough, and \ref ERR_MEM is returned before any callback when a level of tree need
+//!   more entries. Use \ref Tree_TraveseLevelOrderEx with a bigger queue buffer for very
+//!   wide tree.
+//!
+//! \note Default: 64 entries.
+#ifndef TREE_QUEUE_SIZE
+#define TREE_QUEUE_SIZE        64
+#endif
 
 //****************************************************************************************
 //!                           PUBLIC DATA INTERFACE
@@ -82,12 +274,41 @@ extern "C"
 //! \brief  Tree Node typedef
 typedef struct TreeNode
 {
-    struct TreeNode* parent; //!< Parent node.
+#ifdef USE_PARENT_POINTER
+    struct TreeNode* parent; //!< Parent node, read it by \ref TREE_PARENT.
+#endif
     struct TreeNode* left  ; //!< Left node.
     struct TreeNode* right ; //!< Right node.
+#ifdef USE_NODE_AUGMENT
+    int              height; //!< Height of subtree, leaf node is 1.
+    int              size  ; //!< Number of nodes of subtree, include itself.
+#endif
+#ifdef USE_PERSISTENT_NODE
+    intptr_t         refs  ; //!< Number of parents and version roots using the node.
+#endif
+#ifdef USE_INLINE_DATA
+    unsigned char    data[TREE_DATA_SIZE]; //!< User defined data, stored in node.
+#else
     void*            data  ; //!< User defined data.
+#endif
 }TreeNode_t;
 
+#ifdef USE_PARENT_POINTER
+//! \brief Tag bits of parent pointer.
+//! Node is aligned to pointer size, so the lowest bit of parent pointer is always
+//! zero, red-black tree store node colour in it (see BinarySearchTree.h).
+#define TREE_PARENT_TAG_MASK   ((uintptr_t)0x01)
+
+//! \brief Get parent node, tag bits are masked.
+#define TREE_PARENT(pNode)                                                            \
+    ((TreeNode_t*)((uintptr_t)(pNode)->parent & ~TREE_PARENT_TAG_MASK))
+
+//! \brief Set parent node, tag bits are kept.
+#define TREE_PARENT_SET(pNode, pParent)                                               \
+    ((pNode)->parent = (TreeNode_t*)(((uintptr_t)(pNode)->parent & TREE_PARENT_TAG_MASK)  \
+                                     | (uintptr_t)(pParent)))
+#endif // USE_PARENT_POINTER
+
 //! Function Return Value.
 typedef enum TreeErrorCode
 {
@@ -97,14 +318,140 @@ typedef enum TreeErrorCode
     ERR_MEM             ,   //!< Failure to alloc memory
     ERR_WRONG_PARAM     ,   //!< Input parameters are invalid
     ERR_NODE_EXIST      ,   //!< Node is existing, use for Tree_NodeAppend
+    ERR_STOP_MIN        = INT_MIN,  //!< Not an error, the smallest stop value.
+    ERR_STOP_MAX        = INT_MAX,  //!< Not an error, the biggest stop value.
 } TreeErrorCode_t;
 
+//! \brief The smallest positive stop value of user's callback functions.
+//! The stop value of a callback is returned by library function as \ref TreeErrorCode_t,
+//! so 1 ... <ERR_NODE_EXIST> are reserved, for example 3 can not be told from
+//! \ref ERR_MEM. Stop with a negative value, or with <TREE_STOP_BASE> + n, values
+//! between them are left for future error codes. <ERR_STOP_MIN> and <ERR_STOP_MAX>
+//! make \ref TreeErrorCode_t a signed type that holds every int, so a stop value is
+//! returned unchanged, and "< 0" test a negative one.
+#define TREE_STOP_BASE  ((int)0x100)
+
+#ifdef USE_STACK_ALGORITHM
+//! \brief  Work stack of stack algorithm.
+//! The buffer is supplied by user, so memory used by traverse functions is bounded
+//! by <Size> and never allocated by library. Only the internal default stack of the
+//! functions without stack parameter may grow, see <TREE_STACK_DEPTH>.
+typedef struct TreeStack
+{
+    TreeNode_t** pBase;  //!< Stack buffer.
+    int          Size ;  //!< Capacity of stack buffer, in entries.
+    int          Top  ;  //!< Number of entries in use.
+#ifdef USE_DYNAMIC_MEMORY
+    int          Grow ;  //!< Internal, non-zero if default stack may grow onto heap.
+#endif
+#ifdef USE_TREE_STATS
+    int          Peak ;  //!< Internal, the most entries in use by the last traverse.
+#endif
+}TreeStack_t;
+#endif // USE_STACK_ALGORITHM
+
+//! \brief  Work queue of level-order traversal.
+//! Queue is a ring buffer supplied by user, so the working set of breadth-first pass
+//! is one contiguous block, and no memory is allocated by library.
+typedef struct TreeQueue
+{
+    TreeNode_t** pBase;  //!< Queue buffer.
+    int          Size ;  //!< Capacity of queue buffer, in entries.
+    int          Head ;  //!< Index of the first entry.
+    int          Count;  //!< Number of entries in use.
+#ifdef USE_DYNAMIC_MEMORY
+    int          Grow ;  //!< Internal, non-zero if default queue may grow onto heap.
+#endif
+}TreeQueue_t;
+
+//! \brief  Node pool.
+//! Pool manage an user supplied node buffer, free nodes are linked by their right
+//! pointer, so alloc/free are O(1) and no memory is allocated by library.
+typedef struct TreePool
+{
+    TreeNode_t* pFree;  //!< Free node list.
+    int         Size ;  //!< Number of nodes of pool buffer.
+    int         Used ;  //!< Number of nodes allocated from pool.
+}TreePool_t;
+
+//! \brief  Node arena.
+//! Arena allocate nodes from an user supplied buffer one after another, all nodes
+//! are released together by one reset.
+typedef struct TreeArena
+{
+    TreeNode_t* pBase;  //!< Arena buffer.
+    int         Size ;  //!< Number of nodes of arena buffer.
+    int         Used ;  //!< Number of nodes allocated from arena.
+}TreeArena_t;
+
+//! \brief  Tree iterator.
+//! Iterator visit the tree one node per call, see \ref Tree_IterFirst. It follows the
+//! parent pointer to go back, or keep the path in its own array without parent
+//! pointer, so no memory is allocated.
+typedef struct TreeIter
+{
+    TreeNode_t* pRoot;                   //!< Root of the tree that is iterated.
+    TreeNode_t* pNode;                   //!< Current node, NULL when finished.
+    int         Order;                   //!< Iterate order, TREE_ITER_XXX.
+#ifndef USE_PARENT_POINTER
+    int         Top  ;                   //!< Number of nodes in path, -1 if overflow.
+    TreeNode_t* Path[TREE_ITER_DEPTH];   //!< Path from root to current node.
+#endif
+}TreeIter_t;
+
+//! \brief Iterate Order: Pre-order.
+//! \note  This macro can be used as input parameter of \ref Tree_IterFirst.
+#define TREE_ITER_PRE_ORDER    ((int)0x00)
+
+//! \brief Iterate Order: In-order.
+//! \note  This macro can be used as input parameter of \ref Tree_IterFirst.
+#define TREE_ITER_IN_ORDER     ((int)0x01)
+
+//! \brief Iterate Order: Post-order.
+//! \note  This macro can be used as input parameter of \ref Tree_IterFirst.
+#define TREE_ITER_POST_ORDER   ((int)0x02)
+
+//! \brief Check whether iteration is stopped because the path is deeper than
+//!        <TREE_ITER_DEPTH>, it's always false with parent pointer.
+#ifdef USE_PARENT_POINTER
+#define TREE_ITER_OVERFLOW(pIter)   (0)
+#else
+#define TREE_ITER_OVERFLOW(pIter)   ((pIter)->Top < 0)
+#endif
+
+//! \brief Freeze Order: Level order (BFS), it's the Eytzinger order of complete tree.
+//! \note  This macro can be used as input parameter of \ref Tree_SubTreeFreeze.
+#define TREE_FREEZE_BFS_ORDER  ((int)0x00)
+
+//! \brief Freeze Order: van Emde Boas order, cache oblivious.
+//! \note  This macro can be used as input parameter of \ref Tree_SubTreeFreeze.
+#define TREE_FREEZE_VEB_ORDER  ((int)0x01)
+
 //! \brief Use's Callback function which can be used in tree traverse algorithm.
 //! \param Context is Context of execute environment. typical, you can use it
 //!        to store the address of data, avoid to use global variable.
 //! \param Data is Tree Node data pointer.
+//! \retval 0 to continue the traversal, non-zero to stop it at once. The non-zero
+//!         value is returned by traverse function, so it MUST be negative or not less
+//!         than <TREE_STOP_BASE>, other positive values are reserved for
+//!         \ref TreeErrorCode_t.
 typedef int (*TreeCallBackFun_t)(void* Context, void* Data);
 
+//! \brief Use's Batch callback function which can be used in \ref Tree_TraveseBatch.
+//! \param Context is Context of execute environment, the same as \ref TreeCallBackFun_t.
+//! \param ppData is the array of node data pointers, in visit order.
+//! \param Count is the number of pointers in ppData, it's never zero.
+//! \retval the same as \ref TreeCallBackFun_t, non-zero value stops the traversal.
+typedef int (*TreeBatchFun_t)(void* Context, void** ppData, int Count);
+
+//! \brief User's Compare function which can be used in binary search tree algorithm.
+//! \param Context is Context of execute environment, the same as \ref TreeCallBackFun_t.
+//! \param Key is the key that want to compare, typical it's the data of another node.
+//! \param Data is Tree Node data pointer.
+//! \retval a negative value if Key is less than Data, zero if they are equal, a positive
+//!         value if Key is greater than Data.
+typedef int (*TreeCompareFun_t)(void* Context, void* Key, void* Data);
+
 //! \brief Append Position: Left child.
 //! \note  This macro can be used as input parameter of \ref Tree_NodeAppend.
 #define INSERT_POS_LEFT        ((int)0x01)
@@ -159,6 +506,33 @@ extern TreeErrorCode_t Tree_NodeDestory(TreeNode_t **ppNode);
 //****************************************************************************************  
 extern TreeErrorCode_t Tree_SubTreeDelete_Dynamic(TreeNode_t** ppNode);
 
+//****************************************************************************************
+//
+//! \brief  Create node arena in dynamic method.
+//! Arena control block and node buffer are allocated by one malloc call.
+//!
+//! \param  [in] Size is the number of nodes.
+//! \retval the address of new arena or NULL if memory allocate failure.
+//!
+//! \note   
+//!         -# Please check the valid of return address.
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//
+//****************************************************************************************
+extern TreeArena_t* Tree_ArenaCreate(int Size);
+
+//****************************************************************************************
+//
+//! \brief  Destory node arena in dynamic method.
+//!
+//! \param  [in] ppArena is the address of arena pointer.
+//! \retval \ref ERR_FAILURE if *ppArena is NULL, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_ArenaDestory(TreeArena_t** ppArena);
+
 #endif // USE_DYNAMIC_MEMORY
 
 //****************************************************************************************
@@ -186,7 +560,24 @@ extern void Tree_NodeInit(TreeNode_t* pNode);
 //!         -# Dynamic API can not be used mix with static API.
 //
 //**************************************************************************************** 
+#ifdef USE_PARENT_POINTER
 extern TreeErrorCode_t Tree_NodeDelete(TreeNode_t* pNode);
+#endif
+
+//****************************************************************************************
+//
+//! \brief  Remove tree node by the address of its link.
+//!
+//! \param  [in] ppLink is the address of the link to the node, typical it's the address
+//!              of parent's left/right field, or of the root pointer.
+//! \retval \ref ERR_FAILURE if node is not a leaf node, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   
+//!         -# *ppLink is set to NULL, so this function works without parent pointer.
+//!         -# Dynamic API can not be used mix with static API.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_NodeRemove(TreeNode_t** ppLink);
 
 //****************************************************************************************
 //
@@ -201,6 +592,282 @@ extern TreeErrorCode_t Tree_NodeDelete(TreeNode_t* pNode);
 //****************************************************************************************
 extern TreeErrorCode_t Tree_SubTreeDelete_Static(TreeNode_t** ppNode);
 
+//****************************************************************************************
+//
+//! \brief  Init node pool.
+//! All nodes of pBuf are linked into the free list of pool.
+//!
+//! \param  [in] pPool is the node pool.
+//! \param  [in] pBuf is the node buffer, it must be valid while the pool is in use.
+//! \param  [in] Size is the number of nodes of pBuf.
+//!
+//! \note   
+//!         -# Pool API can be used with or without <USE_DYNAMIC_MEMORY>.
+//!         -# Pool node can not be released by \ref Tree_NodeDestory or
+//!            \ref Tree_SubTreeDelete_Dynamic.
+//
+//****************************************************************************************
+extern void Tree_PoolInit(TreePool_t* pPool, TreeNode_t* pBuf, int Size);
+
+//****************************************************************************************
+//
+//! \brief  Allocate tree node from pool.
+//!
+//! \param  [in] pPool is the node pool.
+//! \retval the address of new node or NULL if pool is empty.
+//!
+//! \note   O(1), the node is initialized by \ref Tree_NodeInit.
+//
+//****************************************************************************************
+extern TreeNode_t* Tree_PoolAlloc(TreePool_t* pPool);
+
+//****************************************************************************************
+//
+//! \brief  Release tree node to pool.
+//!
+//! \param  [in] pPool is the node pool.
+//! \param  [in] ppNode is the address of tree node pointer.
+//! \retval \ref ERR_FAILURE if node is not a leaf node, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   O(1), the node is unlinked from its parent like \ref Tree_NodeRemove.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_PoolFree(TreePool_t* pPool, TreeNode_t** ppNode);
+
+//****************************************************************************************
+//
+//! \brief  Release subtree to pool.
+//! All nodes of subtree are returned to the pool in one pass, no recursion and no
+//! work stack is used.
+//!
+//! \param  [in] pPool is the node pool.
+//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
+//! \retval \ref ERR_FAILURE if *ppNode is NULL, otherwise return \ref ERR_SUCCESS.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_SubTreeDelete_Pool(TreePool_t* pPool, TreeNode_t** ppNode);
+
+//****************************************************************************************
+//
+//! \brief  Init node arena.
+//!
+//! \param  [in] pArena is the node arena.
+//! \param  [in] pBuf is the node buffer, it must be valid while the arena is in use.
+//! \param  [in] Size is the number of nodes of pBuf.
+//!
+//! \note   
+//!         -# Arena API can be used with or without <USE_DYNAMIC_MEMORY>.
+//!         -# Arena node can not be released one by one, all nodes are released
+//!            together by \ref Tree_ArenaReset.
+//
+//****************************************************************************************
+extern void Tree_ArenaInit(TreeArena_t* pArena, TreeNode_t* pBuf, int Size);
+
+//****************************************************************************************
+//
+//! \brief  Allocate tree node from arena.
+//!
+//! \param  [in] pArena is the node arena.
+//! \retval the address of new node or NULL if arena is full.
+//!
+//! \note   O(1), nodes are allocated in address order, so a tree built from one
+//!         arena has good locality. The node is initialized by \ref Tree_NodeInit.
+//
+//****************************************************************************************
+extern TreeNode_t* Tree_ArenaAlloc(TreeArena_t* pArena);
+
+//****************************************************************************************
+//
+//! \brief  Release all nodes of arena.
+//! The trees built from arena are dropped at once, no node is visited, so the cost
+//! is O(1) no matter how many nodes are allocated.
+//!
+//! \param  [in] pArena is the node arena.
+//!
+//! \note   Trees built from arena MUST not be used after reset, and nodes of other
+//!         trees MUST not be linked to arena nodes.
+//
+//****************************************************************************************
+extern void Tree_ArenaReset(TreeArena_t* pArena);
+
+//****************************************************************************************
+//
+//! \brief  Build a balanced tree from sorted data in one pass.
+//! Count nodes are taken from arena at once, node i holds ppData[i], and the middle
+//! node of every range becomes the root of the range, so the in-order sequence of
+//! tree is ppData[0] ... ppData[Count - 1] and the depth is floor(log2(Count)) + 1.
+//!
+//! \param  [in] pArena is the node arena, the nodes are contiguous in it.
+//! \param  [in] ppData is the array of data, every entry is handled like the Value of
+//!              \ref Tree_NodeValueSet.
+//! \param  [in] Count is the number of data.
+//! \retval the root of new tree, or NULL if Count <= 0, ppData is NULL or arena has
+//!         less than Count free nodes.
+//!
+//! \note
+//!         -# O(n), \ref Tree_NodeAppend is not called, parent pointer, cached
+//!            height/size and reference count are filled while building.
+//!         -# Nodes are in in-order address order, so in-order traverse and
+//!            search of the tree read memory sequentially.
+//!         -# With <USE_DYNAMIC_MEMORY>, use \ref Tree_ArenaCreate to get all nodes
+//!            by one malloc call.
+//!         -# The tree is NOT coloured, it can be used by \ref Tree_BstInsert but not
+//!            by \ref Tree_RbInsert.
+//
+//****************************************************************************************
+extern TreeNode_t* Tree_SubTreeBuild(TreeArena_t* pArena, void** ppData, int Count);
+
+//****************************************************************************************
+//
+//! \brief  Copy a tree into arena in cache friendly order.
+//! The nodes of tree are copied into contiguous nodes of arena, and the links of copies
+//! are rewritten, so every function works on the frozen copy as on the original tree.
+//! - \ref TREE_FREEZE_BFS_ORDER: level by level, a node and its children are close,
+//!   the top levels that every search touches share a few cache lines.
+//! - \ref TREE_FREEZE_VEB_ORDER: the tree is cut at half height, the top subtree is
+//!   placed first, then every bottom subtree, and each part is placed in the same way,
+//!   so a search reads O(log n / log B) cache lines for any line size B.
+//!
+//! \param  [in] pArena is the node arena, it MUST have \ref Tree_SizeGet free nodes.
+//! \param  [in] pNode is the root of tree that want to freeze.
+//! \param  [in] Order is \ref TREE_FREEZE_BFS_ORDER or \ref TREE_FREEZE_VEB_ORDER.
+//! \retval the root of frozen copy, or NULL if pNode is NULL, Order is wrong or arena has
+//!         not enough free nodes.
+//!
+//! \note
+//!         -# The original tree is not changed, release it after freeze if it's
+//!            not used any more. User's data pointed by nodes is shared, not copied.
+//!         -# Parent pointer tag bits and cached height/size are kept.
+//!         -# O(n) for BFS order, O(n log log n) for vEB order, recursion depth of vEB
+//!            order is the depth of tree.
+//!         -# A frozen tree is meant to be read, linking nodes that are not from
+//!            arena into it loses the locality.
+//
+//****************************************************************************************
+extern TreeNode_t* Tree_SubTreeFreeze(TreeArena_t* pArena, TreeNode_t* pNode, int Order);
+
+//****************************************************************************************
+//
+//! \brief  Copy a subtree into arena.
+//! Nodes are copied level by level in one pass, the copies in arena are the work queue
+//! of the pass, so no stack and no queue is used. It's the same layout as
+//! \ref TREE_FREEZE_BFS_ORDER, without counting the nodes first.
+//!
+//! \param  [in] pArena is the node arena.
+//! \param  [in] pNode is the root of subtree that want to clone.
+//! \retval the root of copy, or NULL if pNode is NULL or arena has not enough free
+//!         nodes, then nothing is allocated from arena.
+//!
+//! \note
+//!         -# O(n). User's data pointed by nodes is shared, not copied.
+//!         -# Parent pointer tag bits and cached height/size are kept.
+//!         -# See \ref Tree_SubTreeClone_Parallel for large subtree.
+//
+//****************************************************************************************
+extern TreeNode_t* Tree_SubTreeClone(TreeArena_t* pArena, TreeNode_t* pNode);
+
+//****************************************************************************************
+//
+//! \brief  Compare two subtrees.
+//! Subtrees are equal when they have the same shape and the data of every pair of
+//! nodes at the same position are equal. Both subtrees are visited in pre-order side by
+//! side, and compare stops at the first difference.
+//!
+//! \param  [in] pNodeA is the root of one subtree, NULL for empty subtree.
+//! \param  [in] pNodeB is the root of another subtree, NULL for empty subtree.
+//! \param  [in] pCmp is the user's compare function, called as pCmp(Ctx, A data,
+//!              B data), 0 means equal. NULL to compare the data pointers, or the
+//!              TREE_DATA_SIZE bytes of inline data.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval 1 if subtrees are equal, 0 if not, -1 if a subtree is deeper than
+//!         <TREE_ITER_DEPTH> without parent pointer (see \ref TREE_ITER_OVERFLOW).
+//!
+//! \note   O(n) with no stack, and O(1) for a shared subtree (pNodeA == pNodeB). With
+//!         <USE_NODE_AUGMENT>, subtrees of different size or height differ at once.
+//
+//****************************************************************************************
+extern int Tree_SubTreeEqual(TreeNode_t* pNodeA, TreeNode_t* pNodeB, TreeCompareFun_t pCmp, void* Ctx);
+
+#ifdef USE_PERSISTENT_NODE
+//****************************************************************************************
+//
+//! \brief  Append node in a new version of tree.
+//! The nodes of path are copied, the children out of path are shared, then pNewNode is
+//! appended to the copy of the last node. The version of ppPath[0] is not changed.
+//!
+//! \param  [in] pPool is the node pool, it MUST have Depth free nodes.
+//! \param  [out] ppRoot is the root of new version.
+//! \param  [in] ppPath is the path from root, ppPath[i + 1] is a child of ppPath[i], and
+//!              pNewNode is appended to ppPath[Depth - 1].
+//! \param  [in] Depth is the number of nodes of path, 0 to make pNewNode a new version.
+//! \param  [in] pNewNode is a new node, it's owned by the new version.
+//! \param  [in] Mode is \ref INSERT_POS_LEFT or \ref INSERT_POS_RIGHT.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Mode or
+//!         path is wrong, \ref ERR_NODE_EXIST if the child node is not empty,
+//!         \ref ERR_MEM if pool has not enough free nodes.
+//!
+//! \note   O(Depth). The path is what a search from root visit, for example the stack
+//!         of a BST descent.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_PersistAppend(TreePool_t* pPool, TreeNode_t** ppRoot, TreeNode_t** ppPath,
+                                          int Depth, TreeNode_t* pNewNode, int Mode);
+
+//****************************************************************************************
+//
+//! \brief  Delete subtree in a new version of tree.
+//! The nodes of path except the last one are copied, the children out of path are
+//! shared, and the link of ppPath[Depth - 1] is cleared in the copy.
+//!
+//! \param  [in] pPool is the node pool, it MUST have Depth - 1 free nodes.
+//! \param  [out] ppRoot is the root of new version, NULL if Depth is 1.
+//! \param  [in] ppPath is the path from root to the root of subtree to delete.
+//! \param  [in] Depth is the number of nodes of path.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if path is
+//!         wrong, \ref ERR_MEM if pool has not enough free nodes.
+//!
+//! \note   O(Depth). The subtree is still used by old versions, it's freed by
+//!         \ref Tree_PersistRelease of the last one.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_PersistDelete(TreePool_t* pPool, TreeNode_t** ppRoot, TreeNode_t** ppPath,
+                                          int Depth);
+
+//****************************************************************************************
+//
+//! \brief  Take one more reference of version.
+//! Every Tree_PersistRetain MUST be paired with one \ref Tree_PersistRelease.
+//!
+//! \param  [in] pRoot is the root of version, NULL for empty version.
+//
+//****************************************************************************************
+extern void Tree_PersistRetain(TreeNode_t* pRoot);
+
+//****************************************************************************************
+//
+//! \brief  Release one reference of version.
+//! The nodes that are used by no more parent and no more version are returned to pool.
+//! A tree built by \ref Tree_NodeAppend is a version with one reference, because every
+//! node is initialized with one reference.
+//!
+//! \param  [in] pPool is the node pool of the nodes.
+//! \param  [in] ppRoot is the root of version, it's set to NULL.
+//! \retval \ref ERR_FAILURE if *ppRoot is NULL, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   O(freed nodes), no recursion and no work stack is used. Nodes are not
+//!         protected from concurrent readers, with \ref TreeEpoch_t publish the new
+//!         root by \ref TREE_RCU_ASSIGN and release the old one after
+//!         \ref Tree_EpochSynchronize.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_PersistRelease(TreePool_t* pPool, TreeNode_t** ppRoot);
+#endif // USE_PERSISTENT_NODE
+
 
 //****************************************************************************************
 //! \brief  Get the depth of tree.
@@ -208,9 +875,65 @@ extern TreeErrorCode_t Tree_SubTreeDelete_Static(TreeNode_t** ppNode);
 //! \param  [in] pNode is the root of tree.
 //! \retval the depth of tree checked, it should >= 1, return zero indicates pNode is
 //!         an invalid node.
+//!
+//! \note   O(1) when <USE_NODE_AUGMENT> is selected, otherwise O(n) without recursion
+//!         and work stack: parent pointer is followed to go back, or right links of
+//!         in-order predecessors are borrowed and restored without parent pointer, so
+//!         the subtree must not be used by another thread at the same time then.
 //****************************************************************************************
 extern int Tree_DepthGet(TreeNode_t* pNode);
 
+//****************************************************************************************
+//! \brief  Get the number of nodes of tree.
+//!
+//! \param  [in] pNode is the root of tree.
+//! \retval the number of nodes, return zero indicates pNode is an invalid node.
+//!
+//! \note   O(1) when <USE_NODE_AUGMENT> is selected, otherwise O(n) without recursion
+//!         and work stack, see \ref Tree_DepthGet.
+//****************************************************************************************
+extern int Tree_SizeGet(TreeNode_t* pNode);
+
+#ifdef USE_NODE_AUGMENT
+//****************************************************************************************
+//! \brief  Update cached height and size of node and all its ancestors.
+//!
+//! \param  [in] pNode is the lowest node whose children are changed, NULL is ignored.
+//!
+//! \note
+//!         -# Library functions call it internally, user only need it after changing
+//!            left/right/parent field by hand, for example rotating nodes.
+//!         -# O(depth), the children of pNode must be up to date.
+//!         -# MUST uncomment <USE_NODE_AUGMENT> macro in order to use this function.
+//****************************************************************************************
+extern void Tree_NodeAugmentUpdate(TreeNode_t* pNode);
+
+//****************************************************************************************
+//! \brief  Get the node at position Index of in-order sequence.
+//!
+//! \param  [in] pNode is the root of tree.
+//! \param  [in] Index is the zero based position, 0 is the most left node.
+//! \retval the node found, or NULL if Index is out of range.
+//!
+//! \note   O(depth), MUST uncomment <USE_NODE_AUGMENT> macro in order to use this
+//!         function.
+//****************************************************************************************
+extern TreeNode_t* Tree_NodeSelect(TreeNode_t* pNode, int Index);
+
+//****************************************************************************************
+//! \brief  Get the position of node in in-order sequence of its tree.
+//! It is the reverse of \ref Tree_NodeSelect, the number of nodes which are before
+//! pNode in the whole tree containing it.
+//!
+//! \param  [in] pNode is the tree node.
+//! \retval the zero based position of pNode, or -1 if pNode is NULL.
+//!
+//! \note   O(depth), MUST uncomment <USE_NODE_AUGMENT> macro in order to use this
+//!         function.
+//****************************************************************************************
+extern int Tree_NodeRank(TreeNode_t* pNode);
+#endif // USE_NODE_AUGMENT
+
 //****************************************************************************************
 //! \brief  Set Node value.
 //!
@@ -221,7 +944,8 @@ extern int Tree_DepthGet(TreeNode_t* pNode);
 //!
 //! \note   The tree node just store the pointer of data, so, we can use this tree
 //!         to store any type of data. <General Programming Method>, Here is a code
-//!         snippet for you.
+//!         snippet for you. With <USE_INLINE_DATA>, TREE_DATA_SIZE bytes at Value are
+//!         copied into node instead, and NULL Value clear the node data.
 //! \code
 //!
 //! typedef struct STUDENT
@@ -250,7 +974,8 @@ extern TreeErrorCode_t Tree_NodeValueSet(TreeNode_t* pNode, void* Value);
 //!
 //! \note   The tree node just store the pointer of data, so, we can use this tree
 //!         to store any type of data. <General Programming Method>, Here is a code
-//!         snippet for you.
+//!         snippet for you. With <USE_INLINE_DATA>, the address of data stored in
+//!         node is returned, copy TREE_DATA_SIZE bytes from it to get the value.
 //! \code
 //!
 //! typedef struct STUDENT
@@ -301,7 +1026,9 @@ extern TreeErrorCode_t Tree_NodeAppend(TreeNode_t* pNode, TreeNode_t* pNewNode,
 //! \param  [in] Ctx is tree context environment, just for call back function.
 //!
 //! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
-//!         input parameters contain invalid pointer.
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the default work
+//!         stack can not hold this tree (stack algorithm only, see <TREE_STACK_DEPTH>).
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
 //****************************************************************************************
 extern TreeErrorCode_t Tree_TravesePreOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
 
@@ -315,7 +1042,9 @@ extern TreeErrorCode_t Tree_TravesePreOrder(TreeNode_t* pNode, TreeCallBackFun_t
 //! \param  [in] Ctx is tree context environment, just for call back function.
 //!
 //! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
-//!         input parameters contain invalid pointer.
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the default work
+//!         stack can not hold this tree (stack algorithm only, see <TREE_STACK_DEPTH>).
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
 //****************************************************************************************
 extern TreeErrorCode_t Tree_TraveseInOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
 
@@ -329,10 +1058,294 @@ extern TreeErrorCode_t Tree_TraveseInOrder(TreeNode_t* pNode, TreeCallBackFun_t
 //! \param  [in] Ctx is tree context environment, just for call back function.
 //!
 //! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
-//!         input parameters contain invalid pointer.
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the default work
+//!         stack can not hold this tree (stack algorithm only, see <TREE_STACK_DEPTH>).
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
 //****************************************************************************************
 extern TreeErrorCode_t Tree_TravesePostOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
 
+#ifdef USE_PARENT_POINTER
+//****************************************************************************************
+//! \brief  Foreach Tree Node by parent pointer.
+//! This function visit all tree node in pre-order algorithm, it follows parent pointer
+//! to go back, so no stack memory is used no matter how deep the tree is.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   The parent pointer of every node must be maintained by \ref Tree_NodeAppend.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TravesePreOrder_Parent(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node by parent pointer.
+//! This function visit all tree node in in-order algorithm, it follows parent pointer
+//! to go back, so no stack memory is used no matter how deep the tree is.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   The parent pointer of every node must be maintained by \ref Tree_NodeAppend.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TraveseInOrder_Parent(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node by parent pointer.
+//! This function visit all tree node in post-order algorithm, it follows parent pointer
+//! to go back, so no stack memory is used no matter how deep the tree is.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   The parent pointer of every node must be maintained by \ref Tree_NodeAppend.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TravesePostOrder_Parent(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
+#endif // USE_PARENT_POINTER
+
+//****************************************************************************************
+//! \brief  Init work queue.
+//!
+//! \param  [in] pQueue is the work queue.
+//! \param  [in] pBuf is the queue buffer, it must be valid while the queue is in use.
+//! \param  [in] Size is the number of entries of pBuf.
+//****************************************************************************************
+extern void Tree_QueueInit(TreeQueue_t* pQueue, TreeNode_t** pBuf, int Size);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in level-order (breadth-first) algorithm, nodes
+//! of the same level are visited from left to right.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the default work
+//!         queue can not hold a level of this tree, see <TREE_QUEUE_SIZE>.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TraveseLevelOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node with user's work queue.
+//! This function visit all tree node in level-order (breadth-first) algorithm, nodes
+//! of the same level are visited from left to right.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] pQueue is the work queue, it need (width of tree + 1) entries at most.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if pQueue is too
+//!         small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TraveseLevelOrderEx(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                                               TreeQueue_t* pQueue);
+
+//****************************************************************************************
+//! \brief  Start iterating a tree.
+//! Typical usage:
+//! \code
+//!     TreeIter_t  Iter;
+//!     TreeNode_t* pNode;
+//!     for(pNode = Tree_IterFirst(&Iter, pRoot, TREE_ITER_IN_ORDER); NULL != pNode;
+//!         pNode = Tree_IterNext(&Iter))
+//!     {
+//!         ...
+//!     }
+//! \endcode
+//!
+//! \param  [in] pIter is the iterator.
+//! \param  [in] pRoot is the root of tree that want to iterate, nodes above it are
+//!              never visited.
+//! \param  [in] Order is the iterate order, it can be one of the following value:
+//!              - \ref TREE_ITER_PRE_ORDER
+//!              - \ref TREE_ITER_IN_ORDER
+//!              - \ref TREE_ITER_POST_ORDER
+//!              .
+//! \retval the first node, or NULL if tree is empty or parameters are wrong.
+//!
+//! \note
+//!         -# The tree must not be changed while iterating, except the data of nodes.
+//!         -# Without parent pointer, check \ref TREE_ITER_OVERFLOW when NULL is
+//!            returned.
+//****************************************************************************************
+extern TreeNode_t* Tree_IterFirst(TreeIter_t* pIter, TreeNode_t* pRoot, int Order);
+
+//****************************************************************************************
+//! \brief  Get the next node of iterator.
+//!
+//! \param  [in] pIter is the iterator started by \ref Tree_IterFirst.
+//! \retval the next node, or NULL if all nodes have been visited.
+//!
+//! \note   O(1) amortised, every edge of tree is passed twice at most.
+//****************************************************************************************
+extern TreeNode_t* Tree_IterNext(TreeIter_t* pIter);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node in batch.
+//! This function collect the data pointers of up to Size nodes into ppBuf, then call
+//! pFun once for them, so one indirect call is paid for every Size nodes and pFun can
+//! work on an array (unroll, vectorize or prefetch the following payloads).
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] Order is the visit order, the same as Order parameter of
+//!              \ref Tree_IterFirst.
+//! \param  [in] pFun is the user's batch callback.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] ppBuf is the batch buffer supplied by user.
+//! \param  [in] Size is the number of entries of ppBuf, it should be > 0.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Order
+//!         or Size is wrong, \ref ERR_MEM if the default work stack can not hold this
+//!         tree (stack algorithm only, see <TREE_STACK_DEPTH>).
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   Nodes are walked by the same loops as \ref Tree_TravesePreOrder,
+//!         \ref Tree_TraveseInOrder and \ref Tree_TravesePostOrder, and data are put
+//!         into ppBuf in the loop, so the depth of tree is limited the same way.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TraveseBatch(TreeNode_t* pNode, int Order, TreeBatchFun_t pFun, void* Ctx,
+                                         void** ppBuf, int Size);
+
+#ifdef USE_STACK_ALGORITHM
+//****************************************************************************************
+//! \brief  Init work stack.
+//!
+//! \param  [in] pStack is the work stack.
+//! \param  [in] pBuf is the stack buffer, it must be valid while the stack is in use.
+//! \param  [in] Size is the number of entries of pBuf.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
+//****************************************************************************************
+extern void Tree_StackInit(TreeStack_t* pStack, TreeNode_t** pBuf, int Size);
+
+//****************************************************************************************
+//! \brief  Get the depth of tree with user's work stack.
+//!
+//! \param  [in] pNode is the root of tree.
+//! \param  [in] pStack is the work stack, it need (depth of tree) entries.
+//! \retval the depth of tree checked, it should >= 1, return zero indicates pNode is
+//!         an invalid node, return -1 if pStack is too small for this tree.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
+//****************************************************************************************
+extern int Tree_DepthGetEx(TreeNode_t* pNode, TreeStack_t* pStack);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node with user's work stack.
+//! This function visit all tree node in pre-order algorithm.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] pStack is the work stack, one entry is used for every node on current
+//!              path which has both left and right child.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if pStack is too
+//!         small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TravesePreOrderEx(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                                              TreeStack_t* pStack);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node with user's work stack.
+//! This function visit all tree node in in-order algorithm.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] pStack is the work stack, one entry is used for every node on current
+//!              path which has left child.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if pStack is too
+//!         small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TraveseInOrderEx(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                                             TreeStack_t* pStack);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node with user's work stack.
+//! This function visit all tree node in post-order algorithm.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] pStack is the work stack, it need (depth of tree) entries.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if pStack is too
+//!         small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TravesePostOrderEx(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                                               TreeStack_t* pStack);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node in batch with user's work stack.
+//! The same as \ref Tree_TraveseBatch, nodes are walked by the loops of
+//! \ref Tree_TravesePreOrderEx, \ref Tree_TraveseInOrderEx and
+//! \ref Tree_TravesePostOrderEx, and data are put into ppBuf in the loop.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] Order is the visit order, the same as Order parameter of
+//!              \ref Tree_IterFirst.
+//! \param  [in] pFun is the user's batch callback.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \param  [in] ppBuf is the batch buffer supplied by user.
+//! \param  [in] Size is the number of entries of ppBuf, it should be > 0.
+//! \param  [in] pStack is the work stack, it need the entries of the _Ex function of
+//!              the same order.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Order
+//!         or Size is wrong, \ref ERR_MEM if pStack is too small for this tree.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note   MUST uncomment <USE_STACK_ALGORITHM> macro in order to use this function.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TraveseBatchEx(TreeNode_t* pNode, int Order, TreeBatchFun_t pFun, void* Ctx,
+                                           void** ppBuf, int Size, TreeStack_t* pStack);
+
+#endif // USE_STACK_ALGORITHM
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1018 @@
+//****************************************************************************************
+//!
+//! \file    BinaryTree.hpp
+//! \brief   C++ Binary Tree Interface.
+//!          Header only template on top of the C API, nodes keep the layout of
+//!          \ref TreeNode_t and value is typed, so compare and traverse functors
+//!          are inlined instead of called through function pointer.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Compile with C++11 or later, and link with BinaryTree.c and
+//!          BinarySearchTree.c. Red-black tree is used with <USE_PARENT_POINTER>,
+//!          otherwise it is a plain binary search tree.
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#ifndef __BINARYTREE_HPP__
+#define __BINARYTREE_HPP__
+
+#include "BinaryTree.h"
+#include "BinarySearchTree.h"
+#ifdef USE_TREE_STATS
+#include "BinaryTreeStats.h"
+#endif
+#include <climits>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+
+//****************************************************************************************
+//!                           PUBLIC DATA INTERFACE
+//****************************************************************************************
+
+//! \brief  Whether value of type T is stored in the inline data of \ref TreeNode_t.
+//! With <USE_INLINE_DATA>, a T that fits in <TREE_DATA_SIZE> bytes and needs at most
+//! pointer alignment is constructed in the data field. A bigger T is stored after the
+//! links, and the <TREE_DATA_SIZE> bytes of data field are unused then, select a
+//! bigger <TREE_DATA_SIZE> or disable <USE_INLINE_DATA> to avoid this cost.
+template<typename T>
+struct BinaryTreeInData
+{
+#ifdef USE_INLINE_DATA
+    static const bool Value = (sizeof(T) <= TREE_DATA_SIZE && alignof(T) <= alignof(void*));
+#else
+    static const bool Value = false;
+#endif
+};
+
+//! \brief  Typed tree node.
+//! The node starts with \ref TreeNode_t, so it can be passed to the C API, and the
+//! value is stored right after the links in the same memory block. Without
+//! <USE_INLINE_DATA> the data field points to value, so C callbacks receive a T*.
+//! With <USE_INLINE_DATA> the value is stored in data field if it fits, see
+//! \ref BinaryTreeInData, then C callbacks receive a T* too.
+template<typename T, bool InData = BinaryTreeInData<T>::Value>
+struct BinaryTreeNode : public TreeNode_t
+{
+    template<typename... Args>
+    explicit BinaryTreeNode(Args&&... args) : value(std::forward<Args>(args)...)
+    {
+        Tree_NodeInit(this);
+#ifndef USE_INLINE_DATA
+        this->data = &value;
+#endif
+    }
+
+    BinaryTreeNode(const BinaryTreeNode&)            = delete;
+    BinaryTreeNode& operator=(const BinaryTreeNode&) = delete;
+
+    //! \brief  User's value, it is the key of node too.
+    T& Value()
+    {
+        return (value);
+    }
+
+    const T& Value() const
+    {
+        return (value);
+    }
+
+private:
+    T value;
+};
+
+#ifdef USE_INLINE_DATA
+//! \brief  Typed tree node whose value is constructed in the inline data.
+template<typename T>
+struct BinaryTreeNode<T, true> : public TreeNode_t
+{
+    template<typename... Args>
+    explicit BinaryTreeNode(Args&&... args)
+    {
+        Tree_NodeInit(this);
+        ::new(static_cast<void*>(this->data)) T(std::forward<Args>(args)...);
+    }
+
+    ~BinaryTreeNode()
+    {
+        Value().~T();
+    }
+
+    BinaryTreeNode(const BinaryTreeNode&)            = delete;
+    BinaryTreeNode& operator=(const BinaryTreeNode&) = delete;
+
+    //! \brief  User's value, it is the key of node too.
+    T& Value()
+    {
+        return (*reinterpret_cast<T*>(this->data));
+    }
+
+    const T& Value() const
+    {
+        return (*reinterpret_cast<const T*>(this->data));
+    }
+};
+#endif // USE_INLINE_DATA
+
+//****************************************************************************************
+//!                           PUBLIC API
+//****************************************************************************************
+
+//! \brief  Ordered binary tree of T.
+//! Values are ordered by Compare, which is a "less than" functor like std::less, and
+//! nodes are allocated by Alloc rebound to \ref BinaryTreeNode.
+//!
+//! \note
+//!         -# Insert/erase use the C algorithms: with <USE_PARENT_POINTER> the tree is
+//!            balanced by \ref Tree_RbInsertFixup and \ref Tree_RbNodeErase, otherwise
+//!            \ref Tree_NodeAppend and \ref Tree_BstLinkErase are used. Only the
+//!            descent is done here, so Compare is inlined.
+//!         -# Tree is movable, not copyable. Exceptions of Alloc, T and Compare are
+//!            passed to caller, the tree is not changed and no node is leaked then.
+//!         -# \ref Root can be passed to C API that only read the tree, such as
+//!            \ref Tree_SubTreeEqual, the tree MUST NOT be relinked by C API.
+template<typename T, typename Compare = std::less<T>, typename Alloc = std::allocator<T> >
+class BinaryTree
+{
+public:
+    typedef BinaryTreeNode<T>                            Node_t;
+    typedef std::allocator_traits<Alloc>                 AllocTraits_t;
+    typedef typename AllocTraits_t::template rebind_alloc<Node_t> NodeAlloc_t;
+    typedef std::allocator_traits<NodeAlloc_t>           NodeTraits_t;
+
+    //! \brief  Owner of a node that is not in a tree.
+    //! It is returned by \ref Extract and consumed by \ref Insert, so a node can move
+    //! between trees without freeing and allocating. The node is released when the
+    //! handle is destroyed.
+    class NodeHandle
+    {
+    public:
+        NodeHandle() : pNode(NULL), NodeAlloc() {}
+
+        NodeHandle(NodeHandle&& Other) noexcept
+            : pNode(Other.pNode), NodeAlloc(std::move(Other.NodeAlloc))
+        {
+            Other.pNode = NULL;
+        }
+
+        NodeHandle& operator=(NodeHandle&& Other) noexcept
+        {
+            if(this != &Other)
+            {
+                Reset();
+                pNode       = Other.pNode;
+                NodeAlloc   = std::move(Other.NodeAlloc);
+                Other.pNode = NULL;
+            }
+
+            return (*this);
+        }
+
+        NodeHandle(const NodeHandle&)            = delete;
+        NodeHandle& operator=(const NodeHandle&) = delete;
+
+        ~NodeHandle()
+        {
+            Reset();
+        }
+
+        //! \brief  Check whether handle own a node.
+        bool Empty() const
+        {
+            return (NULL == pNode);
+        }
+
+        explicit operator bool() const
+        {
+            return (NULL != pNode);
+        }
+
+        //! \brief  Value of node, handle MUST NOT be empty.
+        //! \note   Key can be changed here, the node is not in a tree.
+        T& Value() const
+        {
+            return (pNode->Value());
+        }
+
+    private:
+        friend class BinaryTree;
+
+        NodeHandle(Node_t* pOwnNode, const NodeAlloc_t& OwnAlloc)
+            : pNode(pOwnNode), NodeAlloc(OwnAlloc)
+        {
+        }
+
+        void Reset()
+        {
+            if(NULL != pNode)
+            {
+                NodeTraits_t::destroy(NodeAlloc, pNode);
+                NodeTraits_t::deallocate(NodeAlloc, pNode, 1);
+                pNode = NULL;
+            }
+        }
+
+        Node_t*     pNode;       //!< Owned node, NULL if handle is empty.
+        NodeAlloc_t NodeAlloc;   //!< Allocator that release the node.
+    };
+
+    BinaryTree() : pRoot(NULL), Count(0), Cmp(), NodeAlloc() {}
+
+    explicit BinaryTree(const Compare& UserCmp, const Alloc& UserAlloc = Alloc())
+        : pRoot(NULL), Count(0), Cmp(UserCmp), NodeAlloc(UserAlloc)
+    {
+    }
+
+    BinaryTree(BinaryTree&& Other) noexcept
+        : pRoot(Other.pRoot), Count(Other.Count), Cmp(std::move(Other.Cmp)),
+          NodeAlloc(std::move(Other.NodeAlloc))
+    {
+        Other.pRoot = NULL;
+        Other.Count = 0;
+    }
+
+    BinaryTree& operator=(BinaryTree&& Other) noexcept
+    {
+        if(this != &Other)
+        {
+            Clear();
+            pRoot       = Other.pRoot;
+            Count       = Other.Count;
+            Cmp         = std::move(Other.Cmp);
+            NodeAlloc   = std::move(Other.NodeAlloc);
+            Other.pRoot = NULL;
+            Other.Count = 0;
+        }
+
+        return (*this);
+    }
+
+    BinaryTree(const BinaryTree&)            = delete;
+    BinaryTree& operator=(const BinaryTree&) = delete;
+
+    ~BinaryTree()
+    {
+        Clear();
+    }
+
+    //**********************************************************************************
+    //! \brief  Construct value in a new node and insert it.
+    //!
+    //! \param  [in] args are passed to the constructor of T.
+    //!
+    //! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_NODE_EXIST if a value
+    //!         with the same key is existing, the new node is released then.
+    //**********************************************************************************
+    template<typename... Args>
+    TreeErrorCode_t Emplace(Args&&... args)
+    {
+        Node_t*         pNode   = NodeCreate(std::forward<Args>(args)...);
+        TreeErrorCode_t ErrCode = ERR_FAILURE;
+
+        //! Compare may throw in the descent, the node is not linked yet then.
+        try
+        {
+            ErrCode = NodeInsert(pNode);
+        }
+        catch(...)
+        {
+            NodeDelete(pNode);
+            throw;
+        }
+
+        if(ERR_SUCCESS != ErrCode)
+        {
+            NodeDelete(pNode);
+        }
+
+        return (ErrCode);
+    }
+
+    TreeErrorCode_t Insert(const T& Value)
+    {
+        return Emplace(Value);
+    }
+
+    TreeErrorCode_t Insert(T&& Value)
+    {
+        return Emplace(std::move(Value));
+    }
+
+    //**********************************************************************************
+    //! \brief  Insert the node owned by handle, nothing is allocated.
+    //!
+    //! \param  [in] Handle is the owner of node, it is empty after insert successfully.
+    //!
+    //! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
+    //!         handle is empty, \ref ERR_NODE_EXIST if a value with the same key is
+    //!         existing, handle keep the node then.
+    //!
+    //! \note   The handle MUST come from a tree whose allocator is equal to this one.
+    //**********************************************************************************
+    TreeErrorCode_t Insert(NodeHandle& Handle)
+    {
+        TreeErrorCode_t ErrCode = ERR_FAILURE;
+
+        if(Handle.Empty())
+        {
+            return (ERR_INVALID_POINTER);
+        }
+
+        ErrCode = NodeInsert(Handle.pNode);
+        if(ERR_SUCCESS == ErrCode)
+        {
+            Handle.pNode = NULL;
+        }
+
+        return (ErrCode);
+    }
+
+    //**********************************************************************************
+    //! \brief  Find value by key.
+    //!
+    //! \param  [in] Key is compared with values by Compare.
+    //!
+    //! \retval the value that is equal to Key, or NULL if not found.
+    //!
+    //! \note   Key of returned value MUST NOT be changed.
+    //**********************************************************************************
+    template<typename K>
+    T* Find(const K& Key)
+    {
+        return ValueOf(NodeFind(Key));
+    }
+
+    template<typename K>
+    const T* Find(const K& Key) const
+    {
+        return ValueOf(NodeFind(Key));
+    }
+
+    //**********************************************************************************
+    //! \brief  Find the first value that is not less than key.
+    //!
+    //! \retval the value, or NULL if all values are less than Key.
+    //**********************************************************************************
+    template<typename K>
+    T* LowerBound(const K& Key)
+    {
+        return ValueOf(NodeLowerBound(Key));
+    }
+
+    template<typename K>
+    const T* LowerBound(const K& Key) const
+    {
+        return ValueOf(NodeLowerBound(Key));
+    }
+
+    //**********************************************************************************
+    //! \brief  Find a batch of keys, see \ref Tree_BstFindBatch.
+    //! Up to <TREE_BST_BATCH_WIDTH> descents are stepped in round-robin, and the next
+    //! node of every descent is prefetched, so cache misses of the keys are overlapped.
+    //!
+    //! \param  [in]  pKey is the array of keys.
+    //! \param  [out] ppValue is the array of results, ppValue[i] is the value that is
+    //!               equal to pKey[i], or NULL if not found.
+    //! \param  [in]  Count is the number of keys.
+    //**********************************************************************************
+    template<typename K>
+    void FindBatch(const K* pKey, T** ppValue, int Count)
+    {
+        NodeFindBatch(pKey, ppValue, Count);
+    }
+
+    template<typename K>
+    void FindBatch(const K* pKey, const T** ppValue, int Count) const
+    {
+        NodeFindBatch(pKey, ppValue, Count);
+    }
+
+    //**********************************************************************************
+    //! \brief  Erase value by key, its node is released.
+    //!
+    //! \retval number of erased values, 0 or 1.
+    //**********************************************************************************
+    template<typename K>
+    int Erase(const K& Key)
+    {
+        Node_t* pNode = NodeRemove(Key);
+
+        if(NULL == pNode)
+        {
+            return (0);
+        }
+
+        NodeDelete(pNode);
+
+        return (1);
+    }
+
+    //**********************************************************************************
+    //! \brief  Erase value by key, and pass its node to caller.
+    //!
+    //! \retval handle that own the node, it is empty if not found.
+    //**********************************************************************************
+    template<typename K>
+    NodeHandle Extract(const K& Key)
+    {
+        return NodeHandle(NodeRemove(Key), NodeAlloc);
+    }
+
+    //**********************************************************************************
+    //! \brief  Erase and release all nodes.
+    //! Left child is rotated up until there is none, then the node is released and its
+    //! right child take the place, so no stack is needed even if tree is unbalanced.
+    //**********************************************************************************
+    void Clear()
+    {
+        TreeNode_t* pNode = pRoot;
+        TreeNode_t* pNext = NULL;
+
+        while(NULL != pNode)
+        {
+            if(NULL != pNode->left)
+            {
+                pNext        = pNode->left;
+                pNode->left  = pNext->right;
+                pNext->right = pNode;
+            }
+            else
+            {
+                pNext = pNode->right;
+                NodeDelete(static_cast<Node_t*>(pNode));
+            }
+            pNode = pNext;
+        }
+
+        pRoot = NULL;
+        Count = 0;
+    }
+
+    //! \brief  Number of values in tree.
+    int Size() const
+    {
+        return (Count);
+    }
+
+    bool Empty() const
+    {
+        return (NULL == pRoot);
+    }
+
+    //! \brief  Root node, it is NULL if tree is empty. Nodes are \ref Node_t.
+    TreeNode_t* Root() const
+    {
+        return (pRoot);
+    }
+
+    //**********************************************************************************
+    //! \brief  Traverse tree and call Fun(T&) for each value.
+    //!
+    //! \param  [in] Fun is the callable object, it's inlined when possible.
+    //!
+    //! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_MEM if the work stack
+    //!         can not grow.
+    //!         Traversal stops at once when Fun return non-zero, and the value is
+    //!         returned, so stop with a negative value or one not less than
+    //!         <TREE_STOP_BASE>.
+    //!
+    //! \note   Nodes are walked by the loops of \ref Tree_TravesePreOrderEx,
+    //!         \ref Tree_TraveseInOrderEx and \ref Tree_TravesePostOrderEx, written here
+    //!         so Fun is inlined. The work stack starts with <TREE_STACK_DEPTH> entries
+    //!         on the call stack and is doubled on heap when it is full, so the depth of
+    //!         tree is not limited. Key of value MUST NOT be changed.
+    //**********************************************************************************
+    template<typename F>
+    TreeErrorCode_t TravesePreOrder(F&& Fun)
+    {
+        return NodePreOrder<Node_t>(pRoot, Fun);
+    }
+
+    template<typename F>
+    TreeErrorCode_t TravesePreOrder(F&& Fun) const
+    {
+        return NodePreOrder<const Node_t>(pRoot, Fun);
+    }
+
+    template<typename F>
+    TreeErrorCode_t TraveseInOrder(F&& Fun)
+    {
+        return NodeInOrder<Node_t>(pRoot, Fun);
+    }
+
+    template<typename F>
+    TreeErrorCode_t TraveseInOrder(F&& Fun) const
+    {
+        return NodeInOrder<const Node_t>(pRoot, Fun);
+    }
+
+    template<typename F>
+    TreeErrorCode_t TravesePostOrder(F&& Fun)
+    {
+        return NodePostOrder<Node_t>(pRoot, Fun);
+    }
+
+    template<typename F>
+    TreeErrorCode_t TravesePostOrder(F&& Fun) const
+    {
+        return NodePostOrder<const Node_t>(pRoot, Fun);
+    }
+
+private:
+    //! \internal
+    //! \brief  Allocate node and construct value in it.
+    template<typename... Args>
+    Node_t* NodeCreate(Args&&... args)
+    {
+        Node_t* pNode = NodeTraits_t::allocate(NodeAlloc, 1);
+
+        try
+        {
+            NodeTraits_t::construct(NodeAlloc, pNode, std::forward<Args>(args)...);
+        }
+        catch(...)
+        {
+            NodeTraits_t::deallocate(NodeAlloc, pNode, 1);
+            throw;
+        }
+
+        return (pNode);
+    }
+
+    //! \internal
+    //! \brief  Destroy value and release node.
+    void NodeDelete(Node_t* pNode)
+    {
+        NodeTraits_t::destroy(NodeAlloc, pNode);
+        NodeTraits_t::deallocate(NodeAlloc, pNode, 1);
+    }
+
+    //! \internal
+    //! \brief  Value of node, or NULL if node is NULL.
+    static T* ValueOf(TreeNode_t* pNode)
+    {
+        return (NULL == pNode) ? NULL : &static_cast<Node_t*>(pNode)->Value();
+    }
+
+    //! \internal
+    //! \brief  Account a descent that passed Depth nodes, see \ref Tree_StatsDescent.
+    static void DepthDone(int Depth)
+    {
+#ifdef USE_TREE_STATS
+        Tree_StatsDescent(Depth);
+#else
+        (void)Depth;
+#endif
+    }
+
+    //! \internal
+    //! \brief  Go down to the node of key, see \ref Tree_BstFind.
+    template<typename K>
+    TreeNode_t* NodeFind(const K& Key) const
+    {
+        TreeNode_t* pNode = pRoot;
+        int         Depth = 0;
+
+        while(NULL != pNode)
+        {
+            const T& Value = static_cast<Node_t*>(pNode)->Value();
+
+            Depth++;
+            if(Cmp(Key, Value))
+            {
+                pNode = pNode->left;
+            }
+            else if(Cmp(Value, Key))
+            {
+                pNode = pNode->right;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        DepthDone(Depth);
+        return (pNode);
+    }
+
+    //! \internal
+    //! \brief  Go down to the first node that is not less than key, see
+    //!         \ref Tree_BstLowerBound.
+    template<typename K>
+    TreeNode_t* NodeLowerBound(const K& Key) const
+    {
+        TreeNode_t* pNode  = pRoot;
+        TreeNode_t* pBound = NULL;
+        int         Depth  = 0;
+
+        while(NULL != pNode)
+        {
+            Depth++;
+            if(Cmp(static_cast<Node_t*>(pNode)->Value(), Key))
+            {
+                pNode  = pNode->right;
+            }
+            else
+            {
+                pBound = pNode;
+                pNode  = pNode->left;
+            }
+        }
+
+        DepthDone(Depth);
+        return (pBound);
+    }
+
+    //! \internal
+    //! \brief  Go down to the nodes of keys in lockstep, see \ref Tree_BstFindBatch.
+    //!         Value is in the node, so the next node is ready for compare when it is
+    //!         loaded.
+    template<typename K, typename V>
+    void NodeFindBatch(const K* pKey, V** ppValue, int Count) const
+    {
+        TreeNode_t* pLane[TREE_BST_BATCH_WIDTH];
+        int         Index[TREE_BST_BATCH_WIDTH];
+        int         Depth[TREE_BST_BATCH_WIDTH];
+        int         Width  = (Count < TREE_BST_BATCH_WIDTH) ? Count : TREE_BST_BATCH_WIDTH;
+        int         Active = 0;
+        int         Next   = 0;
+
+        for(int i = 0; i < Width; i++)
+        {
+            pLane[i] = pRoot;
+            Index[i] = Next++;
+            Depth[i] = 0;
+        }
+
+        Active = (Width > 0) ? Width : 0;
+        while(0 != Active)
+        {
+            for(int i = 0; i < Width; i++)
+            {
+                TreeNode_t* pNode = pLane[i];
+
+                if(Index[i] < 0)
+                {
+                    continue;
+                }
+
+                if(NULL != pNode)
+                {
+                    const K&    Key   = pKey[Index[i]];
+                    const T&    Value = static_cast<Node_t*>(pNode)->Value();
+                    TreeNode_t* pNext = Cmp(Key, Value) ? pNode->left
+                                      : (Cmp(Value, Key) ? pNode->right : pNode);
+
+                    Depth[i]++;
+                    if(pNext != pNode)
+                    {
+                        if(NULL != pNext)
+                        {
+                            //! Step down, the node is loaded while other lanes are stepped.
+                            TREE_PREFETCH(pNext);
+                            pLane[i] = pNext;
+                            continue;
+                        }
+                        pNode = NULL;
+                    }
+                }
+
+                //! Descent is finished, start the next key in this lane.
+                ppValue[Index[i]] = ValueOf(pNode);
+                DepthDone(Depth[i]);
+                if(Next < Count)
+                {
+                    pLane[i] = pRoot;
+                    Index[i] = Next++;
+                    Depth[i] = 0;
+                }
+                else
+                {
+                    Index[i] = -1;
+                    Active--;
+                }
+            }
+        }
+    }
+
+    //! \internal
+    //! \brief  Go down to the link of key.
+    //!
+    //! \param  [in]  Key is compared with values by Compare.
+    //! \param  [out] ppParent is the owner of link, NULL if it is the root pointer.
+    //!
+    //! \retval address of link, it points to the node of key, or NULL if not found.
+    template<typename K>
+    TreeNode_t** LinkFind(const K& Key, TreeNode_t** ppParent)
+    {
+        TreeNode_t** ppLink  = &pRoot;
+        TreeNode_t*  pParent = NULL;
+        TreeNode_t*  pNode   = NULL;
+        int          Depth   = 0;
+
+        while(NULL != (pNode = *ppLink))
+        {
+            const T& Value = static_cast<Node_t*>(pNode)->Value();
+
+            Depth++;
+            if(Cmp(Key, Value))
+            {
+                ppLink = &pNode->left;
+            }
+            else if(Cmp(Value, Key))
+            {
+                ppLink = &pNode->right;
+            }
+            else
+            {
+                break;
+            }
+            pParent = pNode;
+        }
+
+        DepthDone(Depth);
+        *ppParent = pParent;
+
+        return (ppLink);
+    }
+
+    //! \internal
+    //! \brief  Link new node as a leaf, then rebalance tree.
+    TreeErrorCode_t NodeInsert(Node_t* pNewNode)
+    {
+        TreeNode_t*  pParent = NULL;
+        TreeNode_t** ppLink  = LinkFind(pNewNode->Value(), &pParent);
+
+        if(NULL != *ppLink)
+        {
+            return (ERR_NODE_EXIST);
+        }
+
+        if(NULL == pParent)
+        {
+            *ppLink = pNewNode;
+        }
+        else
+        {
+            Tree_NodeAppend(pParent, pNewNode,
+                            (ppLink == &pParent->left) ? INSERT_POS_LEFT : INSERT_POS_RIGHT);
+        }
+
+#ifdef USE_PARENT_POINTER
+        Tree_RbInsertFixup(&pRoot, pNewNode);
+#endif
+        Count++;
+
+        return (ERR_SUCCESS);
+    }
+
+    //! \internal
+    //! \brief  Unlink the node of key from tree.
+    //!
+    //! \retval the unlinked node, or NULL if not found.
+    template<typename K>
+    Node_t* NodeRemove(const K& Key)
+    {
+        TreeNode_t*  pParent = NULL;
+        TreeNode_t** ppLink  = LinkFind(Key, &pParent);
+        TreeNode_t*  pNode   = *ppLink;
+
+        if(NULL == pNode)
+        {
+            return (NULL);
+        }
+
+#ifdef USE_PARENT_POINTER
+        Tree_RbNodeErase(&pRoot, pNode);
+#else
+        Tree_BstLinkErase(ppLink, pParent);
+#endif
+        Count--;
+
+        return (static_cast<Node_t*>(pNode));
+    }
+
+    //! \internal
+    //! \brief  Work stack of traversal, it starts on the call stack and is doubled on
+    //!         heap when it is full, see <TREE_STACK_DEPTH>.
+    class WalkStack
+    {
+    public:
+        WalkStack() : pBase(Buf), Size(TREE_STACK_DEPTH), Top(0), pHeap() {}
+
+        WalkStack(const WalkStack&)            = delete;
+        WalkStack& operator=(const WalkStack&) = delete;
+
+        //! \brief  Push node, return false if stack is full and can not grow.
+        bool Push(TreeNode_t* pNode)
+        {
+            if(Top == Size && !Grow())
+            {
+                return (false);
+            }
+            pBase[Top++] = pNode;
+
+            return (true);
+        }
+
+        //! \brief  Pop node, stack MUST not be empty.
+        TreeNode_t* Pop()
+        {
+            return (pBase[--Top]);
+        }
+
+        //! \brief  Top node, stack MUST not be empty.
+        TreeNode_t* Peek() const
+        {
+            return (pBase[Top - 1]);
+        }
+
+        bool Empty() const
+        {
+            return (0 == Top);
+        }
+
+    private:
+        bool Grow()
+        {
+            TreeNode_t** pBuf = (Size <= INT_MAX / 2) ? new(std::nothrow) TreeNode_t*[2 * Size]
+                                                      : NULL;
+
+            if(NULL == pBuf)
+            {
+                return (false);
+            }
+
+            for(int i = 0; i < Top; i++)
+            {
+                pBuf[i] = pBase[i];
+            }
+            pHeap.reset(pBuf);
+            pBase = pBuf;
+            Size  = 2 * Size;
+
+            return (true);
+        }
+
+        TreeNode_t*                   Buf[TREE_STACK_DEPTH]; //!< Entries on call stack.
+        TreeNode_t**                  pBase;                 //!< Stack buffer in use.
+        int                           Size;                  //!< Capacity of pBase.
+        int                           Top;                   //!< Number of entries in use.
+        std::unique_ptr<TreeNode_t*[]> pHeap;                //!< Owner of heap buffer.
+    };
+
+    //! \internal
+    //! \brief  Visit nodes in pre-order, N is Node_t or const Node_t, see
+    //!         \ref Tree_TravesePreOrderEx.
+    template<typename N, typename F>
+    static TreeErrorCode_t NodePreOrder(TreeNode_t* pNode, F& Fun)
+    {
+        WalkStack Stack;
+        int       Ret = 0;
+
+        while(NULL != pNode)
+        {
+            TREE_PREFETCH(pNode->left);
+            TREE_PREFETCH(pNode->right);
+
+            Ret = Fun(static_cast<N*>(pNode)->Value());
+            if(0 != Ret)
+            {
+                return ((TreeErrorCode_t)Ret);
+            }
+
+            if(NULL != pNode->left)
+            {
+                //! Right child is visited after the whole left subtree.
+                if(NULL != pNode->right && !Stack.Push(pNode->right))
+                {
+                    return (ERR_MEM);
+                }
+                pNode = pNode->left;
+            }
+            else if(NULL != pNode->right)
+            {
+                pNode = pNode->right;
+            }
+            else
+            {
+                pNode = Stack.Empty() ? NULL : Stack.Pop();
+            }
+        }
+
+        return (ERR_SUCCESS);
+    }
+
+    //! \internal
+    //! \brief  Visit nodes in in-order, see \ref Tree_TraveseInOrderEx.
+    template<typename N, typename F>
+    static TreeErrorCode_t NodeInOrder(TreeNode_t* pNode, F& Fun)
+    {
+        WalkStack Stack;
+        int       Ret = 0;
+
+        while(NULL != pNode || !Stack.Empty())
+        {
+            if(NULL == pNode)
+            {
+                //! Left subtree is finished, visit its parent.
+                pNode = Stack.Pop();
+            }
+            else if(NULL != pNode->left)
+            {
+                //! Node is visited after its left subtree.
+                if(!Stack.Push(pNode))
+                {
+                    return (ERR_MEM);
+                }
+                pNode = pNode->left;
+                continue;
+            }
+
+            TREE_PREFETCH(pNode->right);
+            Ret = Fun(static_cast<N*>(pNode)->Value());
+            if(0 != Ret)
+            {
+                return ((TreeErrorCode_t)Ret);
+            }
+            pNode = pNode->right;
+        }
+
+        return (ERR_SUCCESS);
+    }
+
+    //! \internal
+    //! \brief  Visit nodes in post-order, the stack always hold the path from root to
+    //!         current node, see \ref Tree_TravesePostOrderEx.
+    template<typename N, typename F>
+    static TreeErrorCode_t NodePostOrder(TreeNode_t* pNode, F& Fun)
+    {
+        WalkStack   Stack;
+        TreeNode_t* pTop = NULL;
+        int         Ret  = 0;
+
+        while(NULL != pNode)
+        {
+            //! Go down to the first node of post-order of subtree.
+            do
+            {
+                if(!Stack.Push(pNode))
+                {
+                    return (ERR_MEM);
+                }
+                pNode = (NULL != pNode->left) ? pNode->left : pNode->right;
+            } while(NULL != pNode);
+
+            //! Visit nodes up the path until the right subtree of parent is not visited.
+            do
+            {
+                pNode = Stack.Pop();
+                Ret   = Fun(static_cast<N*>(pNode)->Value());
+                if(0 != Ret)
+                {
+                    return ((TreeErrorCode_t)Ret);
+                }
+
+                pTop = Stack.Empty() ? NULL : Stack.Peek();
+            } while(NULL != pTop && (pTop->right == pNode || NULL == pTop->right));
+
+            pNode = (NULL != pTop) ? pTop->right : NULL;
+        }
+
+        return (ERR_SUCCESS);
+    }
+
+    TreeNode_t* pRoot;       //!< Root node, NULL if tree is empty.
+    int         Count;       //!< Number of nodes in tree.
+    Compare     Cmp;         //!< Compare functor, Cmp(a, b) is true if a is less than b.
+    NodeAlloc_t NodeAlloc;   //!< Node allocator.
+};
+
+#endif // __BINARYTREE_HPP__
@@ -0,0 +1,654 @@
+//******************************************************************************
+//!
+//! \file    BinaryTreeIdx.c
+//! \brief   Compact Binary Tree Implement
+//!          Node links are stored as 32-bit indices of a node array instead of
+//!          pointers, so every node is 16 bytes on both 32-bit and 64-bit host.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//******************************************************************************
+
+#include "BinaryTreeIdx.h"
+#include <stddef.h>
+
+//! \internal
+//! \brief The mask of append mode parameters.
+#define INSERT_MODE_MASK         (INSERT_POS_LEFT  | INSERT_POS_RIGHT)
+
+//! \internal
+//! \brief Check node index.
+#define IDX_VALID(pTree, Node)   ((Node) < (pTree)->Size)
+
+//**************************************************************************************
+//!                     ASSERT MACRO
+//**************************************************************************************
+#ifndef ASSERT
+
+#ifdef  NDEBUG
+#define ASSERT(x)
+#else
+#define ASSERT(x) do {while(!(x));} while(0)
+#endif
+
+#endif  // ASSERT
+
+//****************************************************************************************
+//!                     PARENT INDEX WALKER
+//****************************************************************************************
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the next node in pre-order.
+//!
+//! \param  [in] pNodes is the node array.
+//! \param  [in] Node is current node.
+//! \param  [in] Root is the root of subtree, walker never go above it.
+//! \retval next node, or TREE_IDX_NULL if Node is the last one.
+//
+//****************************************************************************************
+static TreeIdx_t IdxPreOrderNext(TreeIdxNode_t* pNodes, TreeIdx_t Node, TreeIdx_t Root)
+{
+    TreeIdx_t Parent = TREE_IDX_NULL;
+
+    if(TREE_IDX_NULL != pNodes[Node].left)
+    {
+        return (pNodes[Node].left);
+    }
+
+    if(TREE_IDX_NULL != pNodes[Node].right)
+    {
+        return (pNodes[Node].right);
+    }
+
+    //! Go back until we come from a left child which has right sibling.
+    while(Node != Root)
+    {
+        Parent = pNodes[Node].parent;
+        if(pNodes[Parent].left == Node && TREE_IDX_NULL != pNodes[Parent].right)
+        {
+            return (pNodes[Parent].right);
+        }
+        Node = Parent;
+    }
+
+    return (TREE_IDX_NULL);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the first node of subtree in in-order.
+//
+//****************************************************************************************
+static TreeIdx_t IdxInOrderFirst(TreeIdxNode_t* pNodes, TreeIdx_t Root)
+{
+    while(TREE_IDX_NULL != pNodes[Root].left)
+    {
+        Root = pNodes[Root].left;
+    }
+
+    return (Root);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the next node in in-order.
+//
+//****************************************************************************************
+static TreeIdx_t IdxInOrderNext(TreeIdxNode_t* pNodes, TreeIdx_t Node, TreeIdx_t Root)
+{
+    TreeIdx_t Parent = TREE_IDX_NULL;
+
+    if(TREE_IDX_NULL != pNodes[Node].right)
+    {
+        return IdxInOrderFirst(pNodes, pNodes[Node].right);
+    }
+
+    //! Go back until we come from a left child.
+    while(Node != Root)
+    {
+        Parent = pNodes[Node].parent;
+        if(pNodes[Parent].left == Node)
+        {
+            return (Parent);
+        }
+        Node = Parent;
+    }
+
+    return (TREE_IDX_NULL);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the first node of subtree in post-order.
+//
+//****************************************************************************************
+static TreeIdx_t IdxPostOrderFirst(TreeIdxNode_t* pNodes, TreeIdx_t Root)
+{
+    for(;;)
+    {
+        if(TREE_IDX_NULL != pNodes[Root].left)
+        {
+            Root = pNodes[Root].left;
+        }
+        else if(TREE_IDX_NULL != pNodes[Root].right)
+        {
+            Root = pNodes[Root].right;
+        }
+        else
+        {
+            return (Root);
+        }
+    }
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the next node in post-order.
+//
+//****************************************************************************************
+static TreeIdx_t IdxPostOrderNext(TreeIdxNode_t* pNodes, TreeIdx_t Node, TreeIdx_t Root)
+{
+    TreeIdx_t Parent = TREE_IDX_NULL;
+
+    if(Node == Root)
+    {
+        return (TREE_IDX_NULL);
+    }
+
+    //! Right sibling subtree is visited before parent.
+    Parent = pNodes[Node].parent;
+    if(pNodes[Parent].left == Node && TREE_IDX_NULL != pNodes[Parent].right)
+    {
+        return IdxPostOrderFirst(pNodes, pNodes[Parent].right);
+    }
+
+    return (Parent);
+}
+
+//****************************************************************************************
+//
+//! \brief  Init compact tree.
+//! All nodes of pBuf are initialized by \ref Tree_IdxNodeInit.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] pBuf is the node array, it must be valid while the tree is in use.
+//! \param  [in] Size is the number of nodes of pBuf, it must be less than
+//!              \ref TREE_IDX_NULL.
+//
+//****************************************************************************************
+void Tree_IdxInit(TreeIdxTree_t* pTree, TreeIdxNode_t* pBuf, TreeIdx_t Size)
+{
+    TreeIdx_t i = 0;
+
+    //! Check input parameter
+    ASSERT(NULL != pTree);
+    ASSERT(NULL != pBuf || 0 == Size);
+    ASSERT(TREE_IDX_NULL != Size);
+
+    pTree->pNodes = pBuf;
+    pTree->Size   = Size;
+
+    for(i = 0; i < Size; i++)
+    {
+        Tree_IdxNodeInit(pTree, i);
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Init existing tree node.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the index of tree node.
+//! \retval \ref ERR_SUCCESS if init node successfully, \ref ERR_INVALID_POINTER if
+//!         Node is not a valid index.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_IdxNodeInit(TreeIdxTree_t* pTree, TreeIdx_t Node)
+{
+    TreeIdxNode_t* pNode = NULL;
+
+    //! Check input parameter
+    ASSERT(NULL != pTree);
+    if(!IDX_VALID(pTree, Node))
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pNode         = &pTree->pNodes[Node];
+    pNode->parent = TREE_IDX_NULL;   //!< Init parent index field.
+    pNode->left   = TREE_IDX_NULL;   //!< Init left child index field.
+    pNode->right  = TREE_IDX_NULL;   //!< Init right child index field.
+    pNode->data   = TREE_IDX_NULL;   //!< Init data field.
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Delete tree node.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the index of tree node.
+//! \retval \ref ERR_SUCCESS if delete node successfully, \ref ERR_INVALID_POINTER if
+//!         Node is not a valid index, \ref ERR_FAILURE if Node is not a leaf node.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_IdxNodeDelete(TreeIdxTree_t* pTree, TreeIdx_t Node)
+{
+    TreeIdxNode_t* pNode  = NULL;
+    TreeIdx_t      Parent = TREE_IDX_NULL;
+
+    //! Check input parameter
+    ASSERT(NULL != pTree);
+    if(!IDX_VALID(pTree, Node))
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! Check left/right child node, This function only delete leaf node.
+    pNode = &pTree->pNodes[Node];
+    if(TREE_IDX_NULL != pNode->left || TREE_IDX_NULL != pNode->right)
+    {
+        return (ERR_FAILURE);
+    }
+
+    //! If node has parent node, then break the link between them.
+    Parent = pNode->parent;
+    if(TREE_IDX_NULL != Parent)
+    {
+        if(pTree->pNodes[Parent].left == Node)
+        {
+            pTree->pNodes[Parent].left = TREE_IDX_NULL;
+        }
+
+        if(pTree->pNodes[Parent].right == Node)
+        {
+            pTree->pNodes[Parent].right = TREE_IDX_NULL;
+        }
+    }
+
+    //! Reset Node Field.
+    return Tree_IdxNodeInit(pTree, Node);
+}
+
+//****************************************************************************************
+//
+//! \brief  Delete subtree.
+//! Parent index is followed to go back, so no recursion and no stack is used.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] pNode is the address of node index. typical it's the root of a tree,
+//!              it is set to \ref TREE_IDX_NULL after delete.
+//! \retval \ref ERR_SUCCESS if delete subtree successfully, \ref ERR_FAILURE if
+//!         *pNode is not a valid index.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_IdxSubTreeDelete(TreeIdxTree_t* pTree, TreeIdx_t* pNode)
+{
+    TreeIdxNode_t* pNodes = NULL;
+    TreeIdx_t      Root   = TREE_IDX_NULL;
+    TreeIdx_t      Node   = TREE_IDX_NULL;
+    TreeIdx_t      Parent = TREE_IDX_NULL;
+
+    //! Check input parameter
+    ASSERT(NULL != pTree);
+    ASSERT(NULL != pNode);
+    Root = *pNode;
+
+    if(!IDX_VALID(pTree, Root))
+    {
+        return (ERR_FAILURE);
+    }
+
+    //! Go down to a leaf node, delete it, then go back to its parent.
+    pNodes = pTree->pNodes;
+    Node   = Root;
+    for(;;)
+    {
+        if(TREE_IDX_NULL != pNodes[Node].left)
+        {
+            Node = pNodes[Node].left;
+        }
+        else if(TREE_IDX_NULL != pNodes[Node].right)
+        {
+            Node = pNodes[Node].right;
+        }
+        else
+        {
+            Parent = pNodes[Node].parent;
+            Tree_IdxNodeDelete(pTree, Node);
+            if(Node == Root)
+            {
+                break;
+            }
+            Node = Parent;
+        }
+    }
+
+    *pNode = TREE_IDX_NULL;
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Get the depth of tree.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the root of tree.
+//! \retval the depth of tree checked, it should >= 1, return zero indicates Node is
+//!         an invalid node.
+//****************************************************************************************
+int Tree_IdxDepthGet(TreeIdxTree_t* pTree, TreeIdx_t Node)
+{
+    TreeIdxNode_t* pNodes = NULL;
+    TreeIdx_t      Root   = Node;
+    TreeIdx_t      Parent = TREE_IDX_NULL;
+    int            Deep   = 1;
+    int            Max    = 1;
+
+    //! Check input parameter
+    ASSERT(NULL != pTree);
+    if(!IDX_VALID(pTree, Node))
+    {
+        return (0);
+    }
+
+    //! Pre-order walk, Deep is the depth of current node.
+    pNodes = pTree->pNodes;
+    while(TREE_IDX_NULL != Node)
+    {
+        if(Deep > Max)
+        {
+            Max = Deep;
+        }
+
+        if(TREE_IDX_NULL != pNodes[Node].left)
+        {
+            Node = pNodes[Node].left;
+            Deep++;
+            continue;
+        }
+
+        if(TREE_IDX_NULL != pNodes[Node].right)
+        {
+            Node = pNodes[Node].right;
+            Deep++;
+            continue;
+        }
+
+        //! Go back until we come from a left child which has right sibling.
+        for(;;)
+        {
+            if(Node == Root)
+            {
+                Node = TREE_IDX_NULL;
+                break;
+            }
+
+            Parent = pNodes[Node].parent;
+            if(pNodes[Parent].left == Node && TREE_IDX_NULL != pNodes[Parent].right)
+            {
+                Node = pNodes[Parent].right;
+                break;
+            }
+
+            Node = Parent;
+            Deep--;
+        }
+    }
+
+    return (Max);
+}
+
+//****************************************************************************************
+//! \brief  Set Node value.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the target tree node.
+//! \param  [in] Value is the user data, typical it's an index of user's data array.
+//! \retval \ref ERR_SUCCESS if set node value successfully, \ref ERR_INVALID_POINTER
+//!         if Node is not a valid index.
+//****************************************************************************************
+TreeErrorCode_t Tree_IdxNodeValueSet(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeIdx_t Value)
+{
+    //! Check input parameters.
+    ASSERT(NULL != pTree);
+    if(!IDX_VALID(pTree, Node))
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! Fill Node value
+    pTree->pNodes[Node].data = Value;
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Get Node value.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the target tree node.
+//! \retval the user data stored in tree node, or \ref TREE_IDX_NULL if Node is not a
+//!         valid index.
+//****************************************************************************************
+TreeIdx_t Tree_IdxNodeValueGet(TreeIdxTree_t* pTree, TreeIdx_t Node)
+{
+    //! Check input parameters.
+    ASSERT(NULL != pTree);
+    if(!IDX_VALID(pTree, Node))
+    {
+        return (TREE_IDX_NULL);
+    }
+
+    //! Return data field.
+    return (pTree->pNodes[Node].data);
+}
+
+//****************************************************************************************
+//! \brief  Append an node.
+//! This function append an new node to an existing node.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the index of exising node, new node will be
+//!         inserted behind it.
+//! \param  [in] NewNode is the index of node that want to insert.
+//! \param  [in] Mode control insert point of node.
+//!              the parameter can be one of the following value:
+//!              - \ref INSERT_POS_LEFT  New node will be appended to left child.
+//!              - \ref INSERT_POS_RIGHT New node will be appended to right child.
+//!              .
+//! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid index, \ref ERR_NODE_EXIST if the
+//!         child node is not empty, \ref ERR_WRONG_PARAM if Mode parameter is
+//!         wrong.
+//! \note   This function is designed for tree end node.
+//****************************************************************************************
+TreeErrorCode_t Tree_IdxNodeAppend(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeIdx_t NewNode, int Mode)
+{
+    TreeIdx_t* pLink = NULL;
+
+    //! Check input parameters
+    ASSERT(NULL != pTree);
+    if(!IDX_VALID(pTree, Node) || !IDX_VALID(pTree, NewNode))
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! Check mode parameter.
+    if(0 != (Mode & (~INSERT_MODE_MASK)))
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    //! Select Left/Right link.
+    if((Mode & INSERT_MODE_MASK) == INSERT_POS_LEFT)
+    {
+        pLink = &pTree->pNodes[Node].left;
+    }
+    else
+    {
+        pLink = &pTree->pNodes[Node].right;
+    }
+
+    if(TREE_IDX_NULL != *pLink)
+    {
+        return (ERR_NODE_EXIST);
+    }
+
+    *pLink = NewNode;
+    pTree->pNodes[NewNode].parent = Node;
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in pre-order algorithm. Parent index is followed
+//! to go back, so no recursion and no stack is used.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree, its Data parameter is the address of node data field
+//!              (TreeIdx_t*).
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer or index.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+TreeErrorCode_t Tree_IdxTravesePreOrder(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeIdxNode_t* pNodes = NULL;
+    TreeIdx_t      Root   = Node;
+    int            Ret    = 0;
+
+    if(NULL == pTree || NULL == pFun || !IDX_VALID(pTree, Node))
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pNodes = pTree->pNodes;
+    for(Node = Node; TREE_IDX_NULL != Node; Node = IdxPreOrderNext(pNodes, Node, Root))
+    {
+        Ret = pFun(Ctx, &pNodes[Node].data);
+        if(0 != Ret)
+        {
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in in-order algorithm. Parent index is followed
+//! to go back, so no recursion and no stack is used.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree, its Data parameter is the address of node data field
+//!              (TreeIdx_t*).
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer or index.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+TreeErrorCode_t Tree_IdxTraveseInOrder(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeIdxNode_t* pNodes = NULL;
+    TreeIdx_t      Root   = Node;
+    int            Ret    = 0;
+
+    if(NULL == pTree || NULL == pFun || !IDX_VALID(pTree, Node))
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pNodes = pTree->pNodes;
+    for(Node = IdxInOrderFirst(pNodes, Root); TREE_IDX_NULL != Node; Node = IdxInOrderNext(pNodes, Node, Root))
+    {
+        Ret = pFun(Ctx, &pNodes[Node].data);
+        if(0 != Ret)
+        {
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in post-order algorithm. Parent index is followed
+//! to go back, so no recursion and no stack is used.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree, its Data parameter is the address of node data field
+//!              (TreeIdx_t*).
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer or index.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+TreeErrorCode_t Tree_IdxTravesePostOrder(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeCallBackFun_t pFun, void* Ctx)
+{
+    TreeIdxNode_t* pNodes = NULL;
+    TreeIdx_t      Root   = Node;
+    int            Ret    = 0;
+
+    if(NULL == pTree || NULL == pFun || !IDX_VALID(pTree, Node))
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pNodes = pTree->pNodes;
+    for(Node = IdxPostOrderFirst(pNodes, Root); TREE_IDX_NULL != Node; Node = IdxPostOrderNext(pNodes, Node, Root))
+    {
+        Ret = pFun(Ctx, &pNodes[Node].data);
+        if(0 != Ret)
+        {
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+
+    return (ERR_SUCCESS);
+}
@@ -0,0 +1,242 @@
+//****************************************************************************************
+//!
+//! \file    BinaryTreeIdx.h
+//! \brief   Compact Binary Tree Model Interface.
+//!          Node links are stored as 32-bit indices of a node array instead of
+//!          pointers, so every node is 16 bytes on both 32-bit and 64-bit host.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Compact tree is used like \ref TreeNode_t tree, node pointer is replaced
+//!          by node index and \ref TREE_IDX_NULL is used as NULL.
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#ifndef __BINARYTREEIDX_H__
+#define __BINARYTREEIDX_H__
+
+#include <stdint.h>
+#include "BinaryTree.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//****************************************************************************************
+//!                           PUBLIC DATA INTERFACE
+//****************************************************************************************
+
+//! \brief  Node index typedef.
+typedef uint32_t TreeIdx_t;
+
+//! \brief  Invalid node index, it works as NULL pointer of \ref TreeNode_t tree.
+#define TREE_IDX_NULL          ((TreeIdx_t)0xFFFFFFFFUL)
+
+//! \brief  Compact Tree Node typedef
+typedef struct TreeIdxNode
+{
+    TreeIdx_t parent; //!< Parent node index.
+    TreeIdx_t left  ; //!< Left node index.
+    TreeIdx_t right ; //!< Right node index.
+    TreeIdx_t data  ; //!< User defined data, typical an index of user's data array.
+}TreeIdxNode_t;
+
+//! \brief  Compact Tree typedef
+//! All nodes of a compact tree are stored in one user supplied array.
+typedef struct TreeIdxTree
+{
+    TreeIdxNode_t* pNodes;  //!< Node array.
+    TreeIdx_t      Size  ;  //!< Number of nodes of node array.
+}TreeIdxTree_t;
+
+//****************************************************************************************
+//!                           PUBLIC API
+//****************************************************************************************
+
+//****************************************************************************************
+//
+//! \brief  Init compact tree.
+//! All nodes of pBuf are initialized by \ref Tree_IdxNodeInit.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] pBuf is the node array, it must be valid while the tree is in use.
+//! \param  [in] Size is the number of nodes of pBuf, it must be less than
+//!              \ref TREE_IDX_NULL.
+//
+//****************************************************************************************
+extern void Tree_IdxInit(TreeIdxTree_t* pTree, TreeIdxNode_t* pBuf, TreeIdx_t Size);
+
+//****************************************************************************************
+//
+//! \brief  Init existing tree node.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the index of tree node.
+//! \retval \ref ERR_SUCCESS if init node successfully, \ref ERR_INVALID_POINTER if
+//!         Node is not a valid index.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_IdxNodeInit(TreeIdxTree_t* pTree, TreeIdx_t Node);
+
+//****************************************************************************************
+//
+//! \brief  Delete tree node.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the index of tree node.
+//! \retval \ref ERR_SUCCESS if delete node successfully, \ref ERR_INVALID_POINTER if
+//!         Node is not a valid index, \ref ERR_FAILURE if Node is not a leaf node.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_IdxNodeDelete(TreeIdxTree_t* pTree, TreeIdx_t Node);
+
+//****************************************************************************************
+//
+//! \brief  Delete subtree.
+//! Parent index is followed to go back, so no recursion and no stack is used.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] pNode is the address of node index. typical it's the root of a tree,
+//!              it is set to \ref TREE_IDX_NULL after delete.
+//! \retval \ref ERR_SUCCESS if delete subtree successfully, \ref ERR_FAILURE if
+//!         *pNode is not a valid index.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_IdxSubTreeDelete(TreeIdxTree_t* pTree, TreeIdx_t* pNode);
+
+//****************************************************************************************
+//! \brief  Get the depth of tree.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the root of tree.
+//! \retval the depth of tree checked, it should >= 1, return zero indicates Node is
+//!         an invalid node.
+//****************************************************************************************
+extern int Tree_IdxDepthGet(TreeIdxTree_t* pTree, TreeIdx_t Node);
+
+//****************************************************************************************
+//! \brief  Set Node value.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the target tree node.
+//! \param  [in] Value is the user data, typical it's an index of user's data array.
+//! \retval \ref ERR_SUCCESS if set node value successfully, \ref ERR_INVALID_POINTER
+//!         if Node is not a valid index.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_IdxNodeValueSet(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeIdx_t Value);
+
+//****************************************************************************************
+//! \brief  Get Node value.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the target tree node.
+//! \retval the user data stored in tree node, or \ref TREE_IDX_NULL if Node is not a
+//!         valid index.
+//****************************************************************************************
+extern TreeIdx_t Tree_IdxNodeValueGet(TreeIdxTree_t* pTree, TreeIdx_t Node);
+
+//****************************************************************************************
+//! \brief  Append an node.
+//! This function append an new node to an existing node.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the index of exising node, new node will be
+//!         inserted behind it.
+//! \param  [in] NewNode is the index of node that want to insert.
+//! \param  [in] Mode control insert point of node.
+//!              the parameter can be one of the following value:
+//!              - \ref INSERT_POS_LEFT  New node will be appended to left child.
+//!              - \ref INSERT_POS_RIGHT New node will be appended to right child.
+//!              .
+//! \retval \ref ERR_SUCCESS if insert successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid index, \ref ERR_NODE_EXIST if the
+//!         child node is not empty, \ref ERR_WRONG_PARAM if Mode parameter is
+//!         wrong.
+//! \note   This function is designed for tree end node.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_IdxNodeAppend(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeIdx_t NewNode, int Mode);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in pre-order algorithm. Parent index is followed
+//! to go back, so no recursion and no stack is used.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree, its Data parameter is the address of node data field
+//!              (TreeIdx_t*).
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer or index.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_IdxTravesePreOrder(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeCallBackFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in in-order algorithm. Parent index is followed
+//! to go back, so no recursion and no stack is used.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree, its Data parameter is the address of node data field
+//!              (TreeIdx_t*).
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer or index.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_IdxTraveseInOrder(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeCallBackFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//! \brief  Foreach Tree Node.
+//! This function visit all tree node in post-order algorithm. Parent index is followed
+//! to go back, so no recursion and no stack is used.
+//!
+//! \param  [in] pTree is the compact tree.
+//! \param  [in] Node is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback which can do something with every node data
+//!              of the tree, its Data parameter is the address of node data field
+//!              (TreeIdx_t*).
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer or index.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//****************************************************************************************
+extern TreeErrorCode_t Tree_IdxTravesePostOrder(TreeIdxTree_t* pTree, TreeIdx_t Node, TreeCallBackFun_t pFun, void* Ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BINARYTREEIDX_H__
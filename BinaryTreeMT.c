@@ -0,0 +1,2093 @@
+//******************************************************************************
+//!
+//! \file    BinaryTreeMT.c
+//! \brief   Multi-thread Binary Tree Implement
+//!          Parallel algorithms built on \ref TreeNode_t, POSIX threads are used.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Link with -lpthread (or -pthread).
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#include "BinaryTreeMT.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#ifdef   USE_TREE_STATS
+#include "BinaryTreeStats.h"
+#endif
+
+//**************************************************************************************
+//!                     ASSERT MACRO
+//**************************************************************************************
+#ifndef ASSERT
+
+#ifdef  NDEBUG
+#define ASSERT(x)
+#else
+#define ASSERT(x) do {while(!(x));} while(0)
+#endif
+
+#endif  // ASSERT
+
+//! \internal
+//! \brief The mask of append mode parameters.
+#define INSERT_MODE_MASK         (INSERT_POS_LEFT  | INSERT_POS_RIGHT)
+
+#ifdef USE_DYNAMIC_MEMORY
+//! \internal
+//! \brief Free one node of dynamic API.
+#ifdef USE_NODE_CACHE
+#define NODE_FREE(pNode)         Tree_NodeCacheFree(pNode)
+#else
+#define NODE_FREE(pNode)         free(pNode)
+#endif
+#endif // USE_DYNAMIC_MEMORY
+
+//**************************************************************************************
+//!                     STATISTICS MACRO
+//**************************************************************************************
+
+#ifdef USE_TREE_STATS
+//! \internal
+//! \brief Add Value to a counter of the block bound to calling thread.
+#define STATS_ADD(Field, Value)                                                       \
+    do                                                                                \
+    {                                                                                 \
+        TreeStats_t* pStats_ = g_pTreeStats;                                          \
+        if(NULL != pStats_)                                                           \
+        {                                                                             \
+            TREE_STATS_STORE(pStats_->Field, pStats_->Field + (Value));               \
+        }                                                                             \
+    } while(0)
+
+//! \internal
+//! \brief Declare start time of a timed call, it is 0 if no block is bound.
+#define STATS_TIMER(Start)     uint64_t Start = (NULL != g_pTreeStats) ? Tree_StatsClock() : 0
+
+//! \internal
+//! \brief Record latency of a timed call into histogram Hist of the bound block.
+#define STATS_END(Hist, Start)                                                        \
+    do                                                                                \
+    {                                                                                 \
+        if(0 != (Start) && NULL != g_pTreeStats)                                      \
+        {                                                                             \
+            Tree_StatsLatency(&g_pTreeStats->Hist, Start);                            \
+        }                                                                             \
+    } while(0)
+
+//! \internal
+//! \brief Keep/get the block a subtree queued to reclaimer is accounted to. It is kept
+//!        in data field of subtree root, which is never read again.
+#ifdef USE_INLINE_DATA
+typedef char ReclaimStatsFit_t[(TREE_DATA_SIZE >= sizeof(TreeStats_t*)) ? 1 : -1];
+#define RECLAIM_STATS_SET(pNode, pStats)  memcpy((pNode)->data, &(pStats), sizeof(pStats))
+#define RECLAIM_STATS_GET(pNode, pStats)  memcpy(&(pStats), (pNode)->data, sizeof(pStats))
+#else
+#define RECLAIM_STATS_SET(pNode, pStats)  ((pNode)->data = (void*)(pStats))
+#define RECLAIM_STATS_GET(pNode, pStats)  ((pStats) = (TreeStats_t*)(pNode)->data)
+#endif
+
+//! \internal
+//! \brief Account the work depth reached by a traverse call, see \ref Tree_StatsTravese.
+#define STATS_DEPTH(Depth)     Tree_StatsTravese(Depth)
+#else
+#define STATS_ADD(Field, Value)  ((void)0)
+#define STATS_TIMER(Start)
+#define STATS_END(Hist, Start)   ((void)0)
+#define STATS_DEPTH(Depth)       ((void)0)
+#endif // USE_TREE_STATS
+
+//****************************************************************************************
+//!                     PARALLEL TRAVERSE
+//****************************************************************************************
+
+//! \internal
+//! \brief Task of parallel traverse, a subtree and the depth of its root.
+typedef struct ParTask
+{
+    TreeNode_t* pNode;
+    int         Depth;
+}ParTask_t;
+
+//! \internal
+//! \brief Size of pending stack of sequential part of parallel traverse.
+//! Right subtrees which are not visited yet are kept here, the oldest one is given
+//! away when another thread is idle. When it is full, the right subtree is visited
+//! by iterator at once.
+#define PAR_PEND_SIZE          64
+
+struct ParPool;
+
+//! \internal
+//! \brief Worker of parallel traverse.
+//! Owner push/pop task at Tail, thief steal task at Head. Task depth is increasing
+//! from Head to Tail, and a subtree is only given away when the deque is empty, so
+//! <TREE_MT_MAX_SPLIT> entries are enough.
+typedef struct ParWorker
+{
+    struct ParPool* pPool;
+    pthread_t       Thread;
+    pthread_mutex_t Lock;
+    ParTask_t       Task[TREE_MT_MAX_SPLIT];
+    int             Head;
+    int             Tail;
+    int             Index;
+}ParWorker_t;
+
+//! \internal
+//! \brief Shared state of parallel traverse.
+typedef struct ParPool
+{
+    ParWorker_t*      pWorker;
+    int               Threads;
+    int               SplitDepth;
+    TreeCallBackFun_t pFun;
+    void**            ppCtx;
+    pthread_mutex_t   Lock;
+    pthread_cond_t    Cond;      //!< Idle threads wait for new task here.
+    int               Pending;   //!< Number of tasks in deques or in progress.
+    int               Ret;       //!< The first non-zero value, stops all threads.
+    int               Idle;      //!< Number of waiting threads, read without lock.
+    unsigned long     Seq;       //!< Number of pushed tasks, to catch push before wait.
+}ParPool_t;
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Push task into the deque of worker, and wake an idle thread.
+//!
+//! \param  [in] Give is non-zero to push only if somebody is idle and the deque is
+//!              empty, it's used to give away a subtree of sequential part.
+//! \retval non-zero if the task is pushed.
+//
+//****************************************************************************************
+static int ParTaskPush(ParWorker_t* pWorker, TreeNode_t* pNode, int Depth, int Give)
+{
+    ParPool_t* pPool = pWorker->pPool;
+    int        Push  = 0;
+
+    pthread_mutex_lock(&pPool->Lock);
+    pthread_mutex_lock(&pWorker->Lock);
+    if(!Give || (0 != pPool->Idle && pWorker->Head == pWorker->Tail))
+    {
+        ASSERT(pWorker->Tail < TREE_MT_MAX_SPLIT);
+        pWorker->Task[pWorker->Tail].pNode = pNode;
+        pWorker->Task[pWorker->Tail].Depth = Depth;
+        pWorker->Tail++;
+        Push = 1;
+    }
+    pthread_mutex_unlock(&pWorker->Lock);
+
+    if(Push)
+    {
+        pPool->Pending++;
+        pPool->Seq++;
+        if(0 != pPool->Idle)
+        {
+            pthread_cond_signal(&pPool->Cond);
+        }
+    }
+    pthread_mutex_unlock(&pPool->Lock);
+
+    return (Push);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get task from deque, the newest one for owner, the oldest one for thief.
+//!
+//! \retval non-zero if a task is got.
+//
+//****************************************************************************************
+static int ParTaskGet(ParWorker_t* pWorker, ParTask_t* pTask, int Steal)
+{
+    int Got = 0;
+
+    pthread_mutex_lock(&pWorker->Lock);
+    if(pWorker->Head != pWorker->Tail)
+    {
+        if(Steal)
+        {
+            *pTask = pWorker->Task[pWorker->Head++];
+        }
+        else
+        {
+            *pTask = pWorker->Task[--pWorker->Tail];
+        }
+
+        //! Reuse the deque from the beginning when it's empty.
+        if(pWorker->Head == pWorker->Tail)
+        {
+            pWorker->Head = 0;
+            pWorker->Tail = 0;
+        }
+        Got = 1;
+    }
+    pthread_mutex_unlock(&pWorker->Lock);
+
+    return (Got);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Visit subtree by iterator.
+//!
+//! \retval the first non-zero value of pFun, or ERR_MEM if iterator overflow.
+//
+//****************************************************************************************
+static int ParIterRun(ParPool_t* pPool, TreeNode_t* pNode, void* Ctx)
+{
+    TreeIter_t Iter;
+    int        Ret = 0;
+
+    for(pNode = Tree_IterFirst(&Iter, pNode, TREE_ITER_PRE_ORDER); NULL != pNode;
+        pNode = Tree_IterNext(&Iter))
+    {
+        Ret = pPool->pFun(Ctx, pNode->data);
+        if(0 != Ret)
+        {
+            return (Ret);
+        }
+    }
+
+    return (TREE_ITER_OVERFLOW(&Iter) ? (int)ERR_MEM : 0);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Visit subtree below split depth.
+//! It is walked in pre-order with a pending stack of right subtrees. While another
+//! thread is idle, the oldest pending subtree is given away as a new task, so a long
+//! run of a skewed tree is split again instead of being left to one thread.
+//!
+//! \retval the first non-zero value of pFun, or ERR_MEM if iterator overflow.
+//
+//****************************************************************************************
+static int ParSeqRun(ParWorker_t* pWorker, TreeNode_t* pNode, void* Ctx)
+{
+    ParPool_t*  pPool  = pWorker->pPool;
+    TreeNode_t* Pend[PAR_PEND_SIZE];
+    int         Bottom = 0;
+    int         Top    = 0;
+    int         Ret    = 0;
+
+    for(;;)
+    {
+        while(NULL != pNode)
+        {
+            Ret = pPool->pFun(Ctx, pNode->data);
+            if(0 != Ret)
+            {
+                return (Ret);
+            }
+
+            if(NULL == pNode->left || NULL == pNode->right)
+            {
+                pNode = (NULL != pNode->left) ? pNode->left : pNode->right;
+                continue;
+            }
+
+            //! Idle is only a hint here, it's checked again under lock.
+            if(0 != __atomic_load_n(&pPool->Idle, __ATOMIC_RELAXED))
+            {
+                if(Bottom != Top)
+                {
+                    if(ParTaskPush(pWorker, Pend[Bottom], pPool->SplitDepth, 1))
+                    {
+                        Bottom++;
+                    }
+                }
+                else if(ParTaskPush(pWorker, pNode->right, pPool->SplitDepth, 1))
+                {
+                    pNode = pNode->left;
+                    continue;
+                }
+            }
+
+            if(Top < PAR_PEND_SIZE)
+            {
+                Pend[Top++] = pNode->right;
+            }
+            else
+            {
+                Ret = ParIterRun(pPool, pNode->right, Ctx);
+                if(0 != Ret)
+                {
+                    return (Ret);
+                }
+            }
+            pNode = pNode->left;
+        }
+
+        if(Bottom == Top)
+        {
+            return (0);
+        }
+        pNode = Pend[--Top];
+        if(Bottom == Top)
+        {
+            Bottom = 0;
+            Top    = 0;
+        }
+    }
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Run one task.
+//! Nodes above split depth are visited here, their right subtrees are pushed as new
+//! tasks, the subtree at split depth is visited by \ref ParSeqRun.
+//!
+//! \retval the first non-zero value of pFun, or ERR_MEM if iterator overflow.
+//
+//****************************************************************************************
+static int ParTaskRun(ParWorker_t* pWorker, ParTask_t* pTask)
+{
+    ParPool_t*  pPool = pWorker->pPool;
+    void*       Ctx   = pPool->ppCtx[pWorker->Index];
+    TreeNode_t* pNode = pTask->pNode;
+    int         Depth = pTask->Depth;
+    int         Ret   = 0;
+
+    while(NULL != pNode && Depth < pPool->SplitDepth)
+    {
+        Ret = pPool->pFun(Ctx, pNode->data);
+        if(0 != Ret)
+        {
+            return (Ret);
+        }
+
+        if(NULL != pNode->left)
+        {
+            if(NULL != pNode->right)
+            {
+                ParTaskPush(pWorker, pNode->right, Depth + 1, 0);
+            }
+            pNode = pNode->left;
+        }
+        else
+        {
+            pNode = pNode->right;
+        }
+        Depth++;
+    }
+
+    return (ParSeqRun(pWorker, pNode, Ctx));
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Worker loop, run own task first, then steal task from other workers, wait
+//!         on condition variable when there is nothing to steal.
+//
+//****************************************************************************************
+static void* ParWorkerRun(void* pArg)
+{
+    ParWorker_t*  pWorker = (ParWorker_t*)pArg;
+    ParPool_t*    pPool   = pWorker->pPool;
+    ParTask_t     Task;
+    unsigned long Seq     = 0;
+    int           Ret     = 0;
+    int           Got     = 0;
+    int           i       = 0;
+
+    pthread_mutex_lock(&pPool->Lock);
+    Seq = pPool->Seq;
+    pthread_mutex_unlock(&pPool->Lock);
+
+    for(;;)
+    {
+        //! Own task first, then steal from the next workers in turn.
+        Got = ParTaskGet(pWorker, &Task, 0);
+        for(i = 1; !Got && i < pPool->Threads; i++)
+        {
+            Got = ParTaskGet(&pPool->pWorker[(pWorker->Index + i) % pPool->Threads], &Task, 1);
+        }
+
+        pthread_mutex_lock(&pPool->Lock);
+        if(0 != pPool->Ret || (!Got && 0 == pPool->Pending))
+        {
+            pthread_mutex_unlock(&pPool->Lock);
+            break;
+        }
+
+        if(!Got)
+        {
+            //! Other workers are still running, wait for a new task or the end. If a
+            //! task was pushed since the last scan, scan again instead.
+            if(Seq == pPool->Seq)
+            {
+                __atomic_store_n(&pPool->Idle, pPool->Idle + 1, __ATOMIC_RELAXED);
+                pthread_cond_wait(&pPool->Cond, &pPool->Lock);
+                __atomic_store_n(&pPool->Idle, pPool->Idle - 1, __ATOMIC_RELAXED);
+            }
+            Seq = pPool->Seq;
+            pthread_mutex_unlock(&pPool->Lock);
+            continue;
+        }
+        pthread_mutex_unlock(&pPool->Lock);
+
+        Ret = ParTaskRun(pWorker, &Task);
+
+        pthread_mutex_lock(&pPool->Lock);
+        pPool->Pending--;
+        if(0 != Ret && 0 == pPool->Ret)
+        {
+            pPool->Ret = Ret;
+        }
+        if(0 != pPool->Ret || 0 == pPool->Pending)
+        {
+            pthread_cond_broadcast(&pPool->Cond);
+        }
+        pthread_mutex_unlock(&pPool->Lock);
+    }
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \brief  Foreach Tree Node in parallel.
+//! The tree is split at subtree boundaries into tasks, every thread own a task deque
+//! and steal the oldest (biggest) task from other threads when its deque is empty.
+//! Nodes whose depth is < SplitDepth are split, deeper subtrees are visited by one
+//! thread, but while another thread is idle the oldest unvisited right subtree of
+//! them is given away as a new task, so a skewed tree is not left to one thread.
+//! Idle threads wait on a condition variable instead of spinning.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback, it is called once for every node, from
+//!              several threads at the same time and in no defined order.
+//! \param  [in] ppCtx is the array of Threads contexts, thread i always call pFun with
+//!              ppCtx[i], so every thread can reduce into its own context without
+//!              lock. Merge them after this function returns.
+//! \param  [in] Threads is the number of threads, include the calling thread, it should
+//!              be in [1, <TREE_MT_MAX_THREADS>].
+//! \param  [in] SplitDepth is the sequential cutoff, it should be in
+//!              [0, <TREE_MT_MAX_SPLIT>]. About 2^SplitDepth tasks are made for a
+//!              balanced tree, a few times of Threads is good for load balance.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Threads
+//!         or SplitDepth is out of range, \ref ERR_MEM if a sequential subtree is
+//!         deeper than <TREE_ITER_DEPTH> (without parent pointer only).
+//!         When pFun return non-zero, the thread stops at once and the others stop
+//!         at their next task, the first non-zero value is returned.
+//!
+//! \note
+//!         -# Only for callback that does not depend on visit order, such as an
+//!            associative and commutative reduction.
+//!         -# If a thread can not be created, the work is shared by the others.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_TraveseParallel(TreeNode_t* pNode, TreeCallBackFun_t pFun, void** ppCtx,
+                                     int Threads, int SplitDepth)
+{
+    ParWorker_t Worker[TREE_MT_MAX_THREADS];
+    int         Created[TREE_MT_MAX_THREADS];
+    ParPool_t   Pool;
+    int         i = 0;
+
+    //! Check input parameters
+    if(NULL == pNode || NULL == pFun || NULL == ppCtx)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(Threads < 1 || Threads > TREE_MT_MAX_THREADS || SplitDepth < 0 || SplitDepth > TREE_MT_MAX_SPLIT)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    Pool.pWorker    = Worker;
+    Pool.Threads    = Threads;
+    Pool.SplitDepth = SplitDepth;
+    Pool.pFun       = pFun;
+    Pool.ppCtx      = ppCtx;
+    Pool.Pending    = 0;
+    Pool.Ret        = 0;
+    Pool.Idle       = 0;
+    Pool.Seq        = 0;
+    pthread_mutex_init(&Pool.Lock, NULL);
+    pthread_cond_init(&Pool.Cond, NULL);
+
+    for(i = 0; i < Threads; i++)
+    {
+        Worker[i].pPool = &Pool;
+        Worker[i].Head  = 0;
+        Worker[i].Tail  = 0;
+        Worker[i].Index = i;
+        pthread_mutex_init(&Worker[i].Lock, NULL);
+    }
+
+    //! The whole tree is the first task of calling thread.
+    ParTaskPush(&Worker[0], pNode, 0, 0);
+
+    for(i = 1; i < Threads; i++)
+    {
+        Created[i] = (0 == pthread_create(&Worker[i].Thread, NULL, ParWorkerRun, &Worker[i]));
+    }
+
+    //! Calling thread is worker 0.
+    ParWorkerRun(&Worker[0]);
+
+    for(i = 1; i < Threads; i++)
+    {
+        if(Created[i])
+        {
+            pthread_join(Worker[i].Thread, NULL);
+        }
+    }
+
+    for(i = 0; i < Threads; i++)
+    {
+        pthread_mutex_destroy(&Worker[i].Lock);
+    }
+    pthread_cond_destroy(&Pool.Cond);
+    pthread_mutex_destroy(&Pool.Lock);
+
+    return ((TreeErrorCode_t)Pool.Ret);
+}
+
+//****************************************************************************************
+//!                     SUBTREE CLONE
+//****************************************************************************************
+
+//! \internal
+//! \brief Shared tasks of \ref Tree_SubTreeClone_Parallel.
+typedef struct ClonePool
+{
+    pthread_mutex_t Lock;
+    TreeNode_t**    pTask;     //!< Root of subtree of every task.
+    TreeNode_t**    pParent;   //!< Copy of parent of every task.
+    TreeNode_t***   ppLink;    //!< Link to the copy of every task.
+    int*            pSize;     //!< Number of nodes of every task.
+    int*            pOffset;   //!< Slice of every task in arena buffer.
+    TreeNode_t*     pBase;     //!< Arena buffer.
+    int             Next;
+    int             Count;
+    int             Copy;      //!< 0 to count tasks, 1 to copy tasks.
+    int             Fail;      //!< Non-zero if a task can not be counted, atomic access.
+}ClonePool_t;
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Worker of parallel clone, count or copy the next task until all tasks are
+//!         taken.
+//
+//****************************************************************************************
+static void* CloneWorkerRun(void* pArg)
+{
+    ClonePool_t* pPool = (ClonePool_t*)pArg;
+    TreeArena_t  Arena;
+    TreeNode_t*  pCopy = NULL;
+    int          i     = 0;
+
+    for(;;)
+    {
+        pthread_mutex_lock(&pPool->Lock);
+        i = (pPool->Next < pPool->Count) ? pPool->Next++ : -1;
+        pthread_mutex_unlock(&pPool->Lock);
+
+        if(i < 0)
+        {
+            break;
+        }
+
+        if(!pPool->Copy)
+        {
+            pPool->pSize[i] = Tree_SizeGet(pPool->pTask[i]);
+            if(pPool->pSize[i] <= 0)
+            {
+                __atomic_store_n(&pPool->Fail, 1, __ATOMIC_RELAXED);
+            }
+            continue;
+        }
+
+        //! Every task has its own slice, Size nodes from offset, so it never fails.
+        Tree_ArenaInit(&Arena, pPool->pBase + pPool->pOffset[i], pPool->pSize[i]);
+        pCopy = Tree_SubTreeClone(&Arena, pPool->pTask[i]);
+#ifdef USE_PARENT_POINTER
+        TREE_PARENT_SET(pCopy, pPool->pParent[i]);
+#endif
+        *pPool->ppLink[i] = pCopy;
+    }
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Run workers of parallel clone, the calling thread works too.
+//
+//****************************************************************************************
+static void CloneRun(ClonePool_t* pPool, int First, int Threads)
+{
+    pthread_t Thread[TREE_MT_MAX_THREADS];
+    int       Created[TREE_MT_MAX_THREADS];
+    int       i = 0;
+
+    pPool->Next = First;
+    for(i = 1; i < Threads; i++)
+    {
+        Created[i] = (0 == pthread_create(&Thread[i], NULL, CloneWorkerRun, pPool));
+    }
+
+    CloneWorkerRun(pPool);
+
+    for(i = 1; i < Threads; i++)
+    {
+        if(Created[i])
+        {
+            pthread_join(Thread[i], NULL);
+        }
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Copy a subtree into arena by several threads.
+//! The top of subtree is split into subtrees, their sizes are counted in parallel, then
+//! every subtree is copied by \ref Tree_SubTreeClone into its own slice of arena in
+//! parallel, and the top nodes are copied by calling thread.
+//!
+//! \param  [in] pArena is the node arena.
+//! \param  [in] pNode is the root of subtree that want to clone.
+//! \param  [in] Threads is the number of threads, include the calling thread, it should
+//!              be in [1, <TREE_MT_MAX_THREADS>].
+//! \retval the root of copy, or NULL if pNode is NULL, Threads is out of range or arena
+//!         has not enough free nodes, then nothing is allocated from arena.
+//!
+//! \note
+//!         -# The copy is the same tree as \ref Tree_SubTreeClone, but the nodes of
+//!            every subtree are placed together.
+//!         -# With <USE_NODE_AUGMENT>, sizes are not counted.
+//
+//****************************************************************************************
+TreeNode_t* Tree_SubTreeClone_Parallel(TreeArena_t* pArena, TreeNode_t* pNode, int Threads)
+{
+    TreeNode_t*  Task[TREE_MT_CLONE_TASKS];
+    TreeNode_t*  Parent[TREE_MT_CLONE_TASKS];
+    TreeNode_t** Link[TREE_MT_CLONE_TASKS];
+    int          Size[TREE_MT_CLONE_TASKS];
+    int          Offset[TREE_MT_CLONE_TASKS];
+    ClonePool_t  Pool;
+    TreeNode_t*  pRoot  = NULL;
+    TreeNode_t*  pCopy  = NULL;
+    TreeNode_t*  pNext  = NULL;
+    int          Top    = 0;
+    int          Target = 0;
+    int          Total  = 0;
+    int          Child  = 0;
+    int          Fail   = 0;
+    int          i      = 0;
+
+    //! Check input parameters
+    if(NULL == pArena || NULL == pNode || Threads < 1 || Threads > TREE_MT_MAX_THREADS)
+    {
+        return (NULL);
+    }
+
+    //! Split top of subtree in level order, a few tasks per thread for load balance.
+    //! Task[0, Top) are the top nodes, Task[Top, Count) are the subtrees.
+    Task[0]    = pNode;
+    Pool.Count = 1;
+    Target     = (4 * Threads < TREE_MT_CLONE_TASKS) ? 4 * Threads : TREE_MT_CLONE_TASKS;
+    while(Threads > 1 && Top < Pool.Count && Pool.Count - Top < Target
+          && Pool.Count + 2 <= TREE_MT_CLONE_TASKS)
+    {
+        pNext = Task[Top++];
+        if(NULL != pNext->left)
+        {
+            Task[Pool.Count++] = pNext->left;
+        }
+        if(NULL != pNext->right)
+        {
+            Task[Pool.Count++] = pNext->right;
+        }
+    }
+
+    Pool.pTask   = Task;
+    Pool.pParent = Parent;
+    Pool.ppLink  = Link;
+    Pool.pSize   = Size;
+    Pool.pOffset = Offset;
+    Pool.Fail    = 0;
+    pthread_mutex_init(&Pool.Lock, NULL);
+
+    //! Count subtrees.
+    Pool.Copy = 0;
+#ifdef USE_NODE_AUGMENT
+    Pool.Next = Top;
+    CloneWorkerRun(&Pool);
+#else
+    CloneRun(&Pool, Top, Threads);
+#endif
+
+    Total = Top;
+    Fail = __atomic_load_n(&Pool.Fail, __ATOMIC_RELAXED);
+    for(i = Top; i < Pool.Count && !Fail; i++)
+    {
+        Total += Size[i];
+    }
+
+    if(Fail || pArena->Size - pArena->Used < Total)
+    {
+        pthread_mutex_destroy(&Pool.Lock);
+        return (NULL);
+    }
+
+    //! Slice offsets of subtrees follow the top nodes.
+    Pool.pBase = pArena->pBase;
+    Child      = pArena->Used + Top;
+    for(i = Top; i < Pool.Count; i++)
+    {
+        Offset[i] = Child;
+        Child    += Size[i];
+    }
+
+    //! Copy top nodes in the same order, the children of Task[i] are the next ones.
+    Link[0]   = &pRoot;
+    Parent[0] = NULL;
+    Child     = 1;
+    for(i = 0; i < Top; i++)
+    {
+        pCopy  = &pArena->pBase[pArena->Used + i];
+        *pCopy = *Task[i];
+#ifdef USE_PARENT_POINTER
+        TREE_PARENT_SET(pCopy, Parent[i]);
+#endif
+#ifdef USE_PERSISTENT_NODE
+        pCopy->refs = 1;
+#endif
+        *Link[i] = pCopy;
+
+        if(NULL != pCopy->left)
+        {
+            Parent[Child] = pCopy;
+            Link[Child++] = &pCopy->left;
+        }
+        if(NULL != pCopy->right)
+        {
+            Parent[Child] = pCopy;
+            Link[Child++] = &pCopy->right;
+        }
+    }
+
+    //! Copy subtrees.
+    Pool.Copy = 1;
+    CloneRun(&Pool, Top, Threads);
+    pthread_mutex_destroy(&Pool.Lock);
+
+    pArena->Used += Total;
+
+    return (pRoot);
+}
+
+//****************************************************************************************
+//!                     SUBTREE DELETE
+//****************************************************************************************
+
+#ifdef USE_DYNAMIC_MEMORY
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Detach subtree from its parent, and clear the link.
+//
+//****************************************************************************************
+static void SubTreeDetach(TreeNode_t** ppNode)
+{
+#ifdef USE_PARENT_POINTER
+    TreeNode_t* pNode   = *ppNode;
+    TreeNode_t* pParent = TREE_PARENT(pNode);
+
+    if(NULL != pParent)
+    {
+        if(pParent->left == pNode)
+        {
+            pParent->left = NULL;
+        }
+
+        if(pParent->right == pNode)
+        {
+            pParent->right = NULL;
+        }
+
+        pNode->parent = NULL;
+#ifdef USE_NODE_AUGMENT
+        Tree_NodeAugmentUpdate(pParent);
+#endif
+    }
+#endif // USE_PARENT_POINTER
+
+    *ppNode = NULL;
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Free detached subtree without recursion and without work stack.
+//! Same as the rotation teardown of BinaryTree.c, parent pointers are not used.
+//! \retval the number of nodes freed.
+//
+//****************************************************************************************
+static size_t SubTreeFree(TreeNode_t* pNode)
+{
+    TreeNode_t* pChild = NULL;
+    size_t      Freed  = 0;
+
+    while(NULL != pNode)
+    {
+        if(NULL != pNode->left)
+        {
+            //! Rotate right.
+            pChild        = pNode->left;
+            pNode->left   = pChild->right;
+            pChild->right = pNode;
+            pNode         = pChild;
+        }
+        else
+        {
+            pChild = pNode->right;
+            NODE_FREE(pNode);
+            pNode  = pChild;
+            Freed++;
+        }
+    }
+
+    return (Freed);
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Reclaimer thread, free pending subtrees until it's stopped.
+//! Frees are accounted to the block captured when the subtree was queued.
+//
+//****************************************************************************************
+static void* ReclaimerRun(void* pArg)
+{
+    TreeReclaimer_t* pReclaimer = (TreeReclaimer_t*)pArg;
+    TreeNode_t*      pList      = NULL;
+    TreeNode_t*      pNode      = NULL;
+#ifdef USE_TREE_STATS
+    TreeStats_t*     pStats     = NULL;
+#endif
+
+    pthread_mutex_lock(&pReclaimer->Lock);
+    for(;;)
+    {
+        while(NULL == pReclaimer->pHead && !pReclaimer->Stop)
+        {
+            pthread_cond_wait(&pReclaimer->Cond, &pReclaimer->Lock);
+        }
+
+        //! Pending subtrees are freed before stop.
+        pList             = pReclaimer->pHead;
+        pReclaimer->pHead = NULL;
+        if(NULL == pList)
+        {
+            break;
+        }
+        pthread_mutex_unlock(&pReclaimer->Lock);
+
+        //! Pending subtrees are chained by left child of their roots.
+        while(NULL != pList)
+        {
+            pNode       = pList;
+            pList       = pNode->left;
+            pNode->left = NULL;
+#ifdef USE_TREE_STATS
+            RECLAIM_STATS_GET(pNode, pStats);
+            Tree_StatsReclaimed(pStats, (uint64_t)SubTreeFree(pNode));
+#else
+            SubTreeFree(pNode);
+#endif
+        }
+
+        pthread_mutex_lock(&pReclaimer->Lock);
+    }
+    pthread_mutex_unlock(&pReclaimer->Lock);
+
+    return (NULL);
+}
+
+//! \internal
+//! \brief Shared tasks of \ref Tree_SubTreeDelete_Parallel.
+typedef struct DelPool
+{
+    pthread_mutex_t Lock;
+    TreeNode_t**    pTask;
+    int             Next;
+    int             Count;
+    size_t          Freed;     //!< Nodes freed by workers.
+}DelPool_t;
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Worker of parallel delete, take the next task until all tasks are taken.
+//
+//****************************************************************************************
+static void* DelWorkerRun(void* pArg)
+{
+    DelPool_t*  pPool = (DelPool_t*)pArg;
+    TreeNode_t* pNode = NULL;
+    size_t      Freed = 0;
+
+    for(;;)
+    {
+        pthread_mutex_lock(&pPool->Lock);
+        pPool->Freed += Freed;
+        pNode = (pPool->Next < pPool->Count) ? pPool->pTask[pPool->Next++] : NULL;
+        pthread_mutex_unlock(&pPool->Lock);
+
+        if(NULL == pNode)
+        {
+            break;
+        }
+        Freed = SubTreeFree(pNode);
+    }
+
+    return (NULL);
+}
+
+//****************************************************************************************
+//
+//! \brief  Start a background reclaimer thread.
+//!
+//! \param  [in] pReclaimer is the address of reclaimer.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         pReclaimer is NULL, \ref ERR_FAILURE if the thread can not be created.
+//!
+//! \note   MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_ReclaimerCreate(TreeReclaimer_t* pReclaimer)
+{
+    //! Check input parameters
+    if(NULL == pReclaimer)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pReclaimer->pHead = NULL;
+    pReclaimer->Stop  = 0;
+    pthread_mutex_init(&pReclaimer->Lock, NULL);
+    pthread_cond_init(&pReclaimer->Cond, NULL);
+
+    if(0 != pthread_create(&pReclaimer->Thread, NULL, ReclaimerRun, pReclaimer))
+    {
+        pthread_cond_destroy(&pReclaimer->Cond);
+        pthread_mutex_destroy(&pReclaimer->Lock);
+        return (ERR_FAILURE);
+    }
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Stop the reclaimer thread, all pending subtrees are freed before return.
+//!
+//! \param  [in] pReclaimer is the address of reclaimer.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         pReclaimer is NULL.
+//!
+//! \note   MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_ReclaimerDestory(TreeReclaimer_t* pReclaimer)
+{
+    //! Check input parameters
+    if(NULL == pReclaimer)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pthread_mutex_lock(&pReclaimer->Lock);
+    pReclaimer->Stop = 1;
+    pthread_cond_signal(&pReclaimer->Cond);
+    pthread_mutex_unlock(&pReclaimer->Lock);
+
+    pthread_join(pReclaimer->Thread, NULL);
+    pthread_cond_destroy(&pReclaimer->Cond);
+    pthread_mutex_destroy(&pReclaimer->Lock);
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Destory subtree in dynamic method by the background reclaimer.
+//! The subtree is detached from tree and handed over to reclaimer, then this function
+//! returns at once, nodes are freed later in the reclaimer thread.
+//!
+//! \param  [in] pReclaimer is the address of a running reclaimer.
+//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_FAILURE if subtree is empty,
+//!         \ref ERR_INVALID_POINTER if input parameters contain invalid pointer.
+//!
+//! \note
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//!         -# O(length of left spine) in calling thread, O(n) in reclaimer thread.
+//!         -# Subtree MUST not be accessed after this function, user's data pointed by
+//!            nodes is NOT freed.
+//!         -# With <USE_TREE_STATS>, frees are accounted to the block bound to calling
+//!            thread now, it must be valid until the reclaimer is destoryed.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_SubTreeDelete_Async(TreeReclaimer_t* pReclaimer, TreeNode_t** ppNode)
+{
+    TreeNode_t*  pNode  = NULL;
+    TreeNode_t*  pChild = NULL;
+#ifdef USE_TREE_STATS
+    TreeStats_t* pStats = g_pTreeStats;
+#endif
+
+    //! Check input parameters
+    if(NULL == pReclaimer || NULL == ppNode)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pNode = *ppNode;
+    if(NULL == pNode)
+    {
+        return (ERR_FAILURE);
+    }
+
+    SubTreeDetach(ppNode);
+
+    //! Rotate right until root has no left child, then the left child is free to
+    //! chain pending subtrees. These rotations are part of \ref SubTreeFree anyway.
+    while(NULL != pNode->left)
+    {
+        pChild        = pNode->left;
+        pNode->left   = pChild->right;
+        pChild->right = pNode;
+        pNode         = pChild;
+    }
+#ifdef USE_TREE_STATS
+    RECLAIM_STATS_SET(pNode, pStats);
+#endif
+
+    pthread_mutex_lock(&pReclaimer->Lock);
+    pNode->left       = pReclaimer->pHead;
+    pReclaimer->pHead = pNode;
+    pthread_cond_signal(&pReclaimer->Cond);
+    pthread_mutex_unlock(&pReclaimer->Lock);
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Destory subtree in dynamic method by several threads.
+//! The top of subtree is split into subtrees, and they are freed by Threads threads
+//! (include the calling thread) in parallel.
+//!
+//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
+//! \param  [in] Threads is the number of threads, it should be in
+//!              [1, <TREE_MT_MAX_THREADS>].
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_FAILURE if subtree is empty,
+//!         \ref ERR_INVALID_POINTER if ppNode is NULL, \ref ERR_WRONG_PARAM if
+//!         Threads is out of range.
+//!
+//! \note
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//!         -# The speedup depends on the allocator, free() that takes a global lock
+//!            does not scale, see <USE_NODE_CACHE>.
+//!         -# With <USE_TREE_STATS>, frees of all threads are accounted to the block
+//!            bound to calling thread.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_SubTreeDelete_Parallel(TreeNode_t** ppNode, int Threads)
+{
+    TreeNode_t* Task[TREE_MT_DELETE_TASKS];
+    pthread_t   Thread[TREE_MT_MAX_THREADS];
+    int         Created[TREE_MT_MAX_THREADS];
+    DelPool_t   Pool;
+    TreeNode_t* pNode  = NULL;
+    int         Target = 0;
+    int         i      = 0;
+    STATS_TIMER(Start);
+
+    //! Check input parameters
+    if(NULL == ppNode)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(Threads < 1 || Threads > TREE_MT_MAX_THREADS)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    if(NULL == *ppNode)
+    {
+        return (ERR_FAILURE);
+    }
+
+    Task[0] = *ppNode;
+    SubTreeDetach(ppNode);
+
+    //! Split top of subtree in level order, a few tasks per thread for load balance.
+    Pool.pTask = Task;
+    Pool.Next  = 0;
+    Pool.Count = 1;
+    Pool.Freed = 0;
+    Target     = (4 * Threads < TREE_MT_DELETE_TASKS) ? 4 * Threads : TREE_MT_DELETE_TASKS;
+    while(Threads > 1 && Pool.Next < Pool.Count && Pool.Count - Pool.Next < Target
+          && Pool.Count + 2 <= TREE_MT_DELETE_TASKS)
+    {
+        pNode = Task[Pool.Next++];
+        if(NULL != pNode->left)
+        {
+            Task[Pool.Count++] = pNode->left;
+        }
+        if(NULL != pNode->right)
+        {
+            Task[Pool.Count++] = pNode->right;
+        }
+        NODE_FREE(pNode);
+    }
+    //! Every task taken by the split is freed.
+    Pool.Freed = (size_t)Pool.Next;
+
+    pthread_mutex_init(&Pool.Lock, NULL);
+    for(i = 1; i < Threads; i++)
+    {
+        Created[i] = (0 == pthread_create(&Thread[i], NULL, DelWorkerRun, &Pool));
+    }
+
+    //! Calling thread works too.
+    DelWorkerRun(&Pool);
+
+    for(i = 1; i < Threads; i++)
+    {
+        if(Created[i])
+        {
+            pthread_join(Thread[i], NULL);
+        }
+    }
+    pthread_mutex_destroy(&Pool.Lock);
+
+    STATS_ADD(Frees, Pool.Freed);
+    STATS_END(Delete, Start);
+    return (ERR_SUCCESS);
+}
+#endif // USE_DYNAMIC_MEMORY
+
+//****************************************************************************************
+//!                     NODE CACHE
+//****************************************************************************************
+
+#ifdef USE_NODE_CACHE
+//! \internal
+//! \brief Node cache of one thread.
+//! Free nodes are linked by left child. A batch is a list of free nodes, batches are
+//! linked by right child of their first node, in spare list and in the shared pool.
+typedef struct NodeCache
+{
+    TreeNode_t* pFree;         //!< Free nodes, Count nodes.
+    int         Count;
+    TreeNode_t* pSpare;        //!< Batches taken from shared pool.
+    int         Registered;
+}NodeCache_t;
+
+static __thread NodeCache_t s_NodeCache;
+static TreeNode_t*          s_pNodePool     = NULL;
+static pthread_once_t       s_NodeCacheOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t        s_NodeCacheKey;
+
+//! \internal
+//! \brief Return node cache to pool when thread exits.
+static void NodeCacheExit(void* pArg)
+{
+    (void)pArg;
+    Tree_NodeCacheFlush();
+}
+
+//! \internal
+//! \brief Create the key whose destructor flushes node cache.
+static void NodeCacheKeyCreate(void)
+{
+    pthread_key_create(&s_NodeCacheKey, NodeCacheExit);
+}
+
+//! \internal
+//! \brief Register node cache of calling thread, so it's flushed when thread exits.
+static void NodeCacheRegister(NodeCache_t* pCache)
+{
+    pthread_once(&s_NodeCacheOnce, NodeCacheKeyCreate);
+    pthread_setspecific(s_NodeCacheKey, pCache);
+    pCache->Registered = 1;
+}
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Push a chain of batches (pFirst ... pLast) to shared pool, lock free.
+//
+//****************************************************************************************
+static void NodePoolPush(TreeNode_t* pFirst, TreeNode_t* pLast)
+{
+    TreeNode_t* pHead = __atomic_load_n(&s_pNodePool, __ATOMIC_RELAXED);
+
+    do
+    {
+        pLast->right = pHead;
+    } while(!__atomic_compare_exchange_n(&s_pNodePool, &pHead, pFirst, 1,
+                                         __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+//****************************************************************************************
+//
+//! \brief  Allocate one node from the cache of calling thread.
+//! When the cache is empty, it takes all batches from the shared pool, and then it
+//! allocates <TREE_NODE_CACHE_BATCH> nodes by one malloc call if pool is empty too.
+//!
+//! \retval the address of node, it's NOT initialized. NULL if memory is exhausted.
+//!
+//! \note
+//!         -# MUST uncomment <USE_NODE_CACHE> macro in order to use this function,
+//!            then \ref Tree_NodeCreate call it.
+//!         -# Lock free, O(1).
+//!         -# Memory of nodes is never returned to malloc.
+//
+//****************************************************************************************
+TreeNode_t* Tree_NodeCacheAlloc(void)
+{
+    NodeCache_t* pCache = &s_NodeCache;
+    TreeNode_t*  pNode  = NULL;
+    int          i      = 0;
+
+    if(!pCache->Registered)
+    {
+        NodeCacheRegister(pCache);
+    }
+
+    if(NULL == pCache->pFree)
+    {
+        //! Take all batches of shared pool, no ABA problem with exchange.
+        if(NULL == pCache->pSpare)
+        {
+            pCache->pSpare = __atomic_exchange_n(&s_pNodePool, (TreeNode_t*)NULL, __ATOMIC_ACQUIRE);
+        }
+
+        if(NULL != pCache->pSpare)
+        {
+            pCache->pFree  = pCache->pSpare;
+            pCache->pSpare = pCache->pSpare->right;
+            for(pNode = pCache->pFree; NULL != pNode; pNode = pNode->left)
+            {
+                pCache->Count++;
+            }
+        }
+        else
+        {
+            pNode = (TreeNode_t*)malloc(TREE_NODE_CACHE_BATCH * sizeof(TreeNode_t));
+            if(NULL == pNode)
+            {
+                return (NULL);
+            }
+
+            for(i = 0; i < TREE_NODE_CACHE_BATCH - 1; i++)
+            {
+                pNode[i].left = &pNode[i + 1];
+            }
+            pNode[i].left  = NULL;
+            pCache->pFree  = pNode;
+            pCache->Count  = TREE_NODE_CACHE_BATCH;
+        }
+    }
+
+    pNode         = pCache->pFree;
+    pCache->pFree = pNode->left;
+    pCache->Count--;
+
+    return (pNode);
+}
+
+//****************************************************************************************
+//
+//! \brief  Put one node to the cache of calling thread.
+//! A full batch of <TREE_NODE_CACHE_BATCH> nodes is moved to the shared pool, so the
+//! node may be freed by a thread other than the one allocated it.
+//!
+//! \param  [in] pNode is the address of node got by \ref Tree_NodeCacheAlloc.
+//!
+//! \note
+//!         -# MUST uncomment <USE_NODE_CACHE> macro in order to use this function,
+//!            then \ref Tree_NodeDestory and dynamic delete functions call it.
+//!         -# Lock free, O(1).
+//
+//****************************************************************************************
+void Tree_NodeCacheFree(TreeNode_t* pNode)
+{
+    NodeCache_t* pCache = &s_NodeCache;
+    TreeNode_t*  pLast  = NULL;
+    int          i      = 0;
+
+    ASSERT(NULL != pNode);
+
+    if(!pCache->Registered)
+    {
+        NodeCacheRegister(pCache);
+    }
+
+    pNode->left   = pCache->pFree;
+    pCache->pFree = pNode;
+    pCache->Count++;
+
+    //! Keep one batch in cache, so alloc/free around the border do not hit the pool.
+    if(pCache->Count >= 2 * TREE_NODE_CACHE_BATCH)
+    {
+        pLast = pCache->pFree;
+        for(i = 1; i < TREE_NODE_CACHE_BATCH; i++)
+        {
+            pLast = pLast->left;
+        }
+
+        pNode         = pCache->pFree;
+        pCache->pFree = pLast->left;
+        pCache->Count -= TREE_NODE_CACHE_BATCH;
+        pLast->left   = NULL;
+        NodePoolPush(pNode, pNode);
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Move all nodes in the cache of calling thread to the shared pool.
+//!
+//! \note   It's called automatically when a thread that used the cache exits.
+//
+//****************************************************************************************
+void Tree_NodeCacheFlush(void)
+{
+    NodeCache_t* pCache = &s_NodeCache;
+    TreeNode_t*  pLast  = NULL;
+
+    if(NULL != pCache->pFree)
+    {
+        pCache->pFree->right = pCache->pSpare;
+        pCache->pSpare       = pCache->pFree;
+        pCache->pFree        = NULL;
+        pCache->Count        = 0;
+    }
+
+    if(NULL != pCache->pSpare)
+    {
+        for(pLast = pCache->pSpare; NULL != pLast->right; pLast = pLast->right)
+        {
+        }
+        NodePoolPush(pCache->pSpare, pLast);
+        pCache->pSpare = NULL;
+    }
+}
+#endif // USE_NODE_CACHE
+
+//****************************************************************************************
+//!                     EPOCH READER/WRITER
+//****************************************************************************************
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Get the link that point to node, the link in parent is found by parent
+//!         pointer, so caller may pass a copy of the pointer.
+//
+//****************************************************************************************
+static TreeNode_t** RcuLinkGet(TreeNode_t** ppNode)
+{
+#ifdef USE_PARENT_POINTER
+    TreeNode_t* pNode   = *ppNode;
+    TreeNode_t* pParent = TREE_PARENT(pNode);
+
+    if(NULL != pParent)
+    {
+        return ((pParent->left == pNode) ? &pParent->left : &pParent->right);
+    }
+#endif // USE_PARENT_POINTER
+
+    return (ppNode);
+}
+
+//****************************************************************************************
+//
+//! \brief  Initialize epoch domain.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         pEpoch is NULL.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_EpochInit(TreeEpoch_t* pEpoch)
+{
+    int i = 0;
+
+    //! Check input parameters
+    if(NULL == pEpoch)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    for(i = 0; i < TREE_MT_MAX_READERS; i++)
+    {
+        pEpoch->Slot[i].Epoch = 0;
+    }
+
+    //! Epoch 0 is reserved for idle slot.
+    pEpoch->Epoch = 1;
+    pthread_mutex_init(&pEpoch->Lock, NULL);
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Destory epoch domain, no reader or writer may use it any more.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         pEpoch is NULL.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_EpochDestory(TreeEpoch_t* pEpoch)
+{
+    //! Check input parameters
+    if(NULL == pEpoch)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pthread_mutex_destroy(&pEpoch->Lock);
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Enter read side critical section.
+//! Nodes reachable from the tree are not freed until the reader exits, so the tree
+//! can be walked without lock.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//! \param  [in] Slot is the reader slot owned by calling thread, in
+//!              [0, <TREE_MT_MAX_READERS>).
+//!
+//! \note
+//!         -# Wait free, only the own slot is written, so readers scale with cores.
+//!         -# Can not be nested.
+//!         -# Load the root pointer by \ref TREE_RCU_DEREF, walk by
+//!            \ref Tree_RcuTravesePreOrder, \ref Tree_RcuTraveseInOrder, search by
+//!            \ref Tree_RcuFind, or load every link by \ref TREE_RCU_DEREF
+//!            in your own walk. Other traverse and search functions read links by plain
+//!            loads, they are data races to ThreadSanitizer and the C memory model.
+//!         -# Functions that walk up by parent pointer (\ref Tree_TravesePreOrder_Parent,
+//!            the iterator with <USE_PARENT_POINTER>) are NOT safe when subtrees are
+//!            unlinked.
+//
+//****************************************************************************************
+void Tree_EpochReadEnter(TreeEpoch_t* pEpoch, int Slot)
+{
+    unsigned long Epoch = 0;
+
+    ASSERT(NULL != pEpoch);
+    ASSERT(Slot >= 0 && Slot < TREE_MT_MAX_READERS);
+
+    Epoch = __atomic_load_n(&pEpoch->Epoch, __ATOMIC_ACQUIRE);
+
+    //! Slot MUST be visible to writer before any link is read, a seq_cst RMW orders
+    //! the slot store before later loads, against the seq_cst RMW of the writer.
+    (void)__atomic_exchange_n(&pEpoch->Slot[Slot].Epoch, Epoch, __ATOMIC_SEQ_CST);
+}
+
+//****************************************************************************************
+//
+//! \brief  Exit read side critical section.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//! \param  [in] Slot is the reader slot used by \ref Tree_EpochReadEnter.
+//
+//****************************************************************************************
+void Tree_EpochReadExit(TreeEpoch_t* pEpoch, int Slot)
+{
+    ASSERT(NULL != pEpoch);
+    ASSERT(Slot >= 0 && Slot < TREE_MT_MAX_READERS);
+
+    __atomic_store_n(&pEpoch->Slot[Slot].Epoch, 0UL, __ATOMIC_RELEASE);
+}
+
+//****************************************************************************************
+//
+//! \brief  Enter write side, writers are serialized by a mutex.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//!
+//! \note   Writer can read links by plain loads, but \ref Tree_DepthGet and
+//!         \ref Tree_SizeGet borrow links without parent pointer, do not call them on
+//!         nodes that readers can reach.
+//
+//****************************************************************************************
+void Tree_EpochWriteEnter(TreeEpoch_t* pEpoch)
+{
+    ASSERT(NULL != pEpoch);
+
+    pthread_mutex_lock(&pEpoch->Lock);
+}
+
+//****************************************************************************************
+//
+//! \brief  Exit write side.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//
+//****************************************************************************************
+void Tree_EpochWriteExit(TreeEpoch_t* pEpoch)
+{
+    ASSERT(NULL != pEpoch);
+
+    pthread_mutex_unlock(&pEpoch->Lock);
+}
+
+//****************************************************************************************
+//
+//! \brief  Wait a grace period.
+//! Return when every reader that was in read side critical section at the time of call
+//! has exited, so nodes unlinked before can be freed or reused.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//!
+//! \note   MUST not be called in read side critical section.
+//
+//****************************************************************************************
+void Tree_EpochSynchronize(TreeEpoch_t* pEpoch)
+{
+    unsigned long Epoch = 0;
+    unsigned long Seen  = 0;
+    int           i     = 0;
+
+    ASSERT(NULL != pEpoch);
+
+    //! Unlink MUST be visible before slots are scanned, the seq_cst RMW orders the
+    //! release stores of unlink before the seq_cst slot loads below.
+    Epoch = __atomic_add_fetch(&pEpoch->Epoch, 1UL, __ATOMIC_SEQ_CST);
+
+    //! Readers entered after the new epoch can not see unlinked nodes, don't wait them.
+    for(i = 0; i < TREE_MT_MAX_READERS; i++)
+    {
+        for(;;)
+        {
+            Seen = __atomic_load_n(&pEpoch->Slot[i].Epoch, __ATOMIC_SEQ_CST);
+            if(0 == Seen || Seen >= Epoch)
+            {
+                break;
+            }
+            sched_yield();
+        }
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Append an node, the new node is published atomically.
+//! Same as \ref Tree_NodeAppend, but concurrent readers see the node either not at all
+//! or fully initialized.
+//!
+//! \param  [in] pNode is the address of exising node.
+//! \param  [in] pNewNode is the address of node that want to insert, its value and
+//!              children MUST be set before.
+//! \param  [in] Mode is \ref INSERT_POS_LEFT or \ref INSERT_POS_RIGHT.
+//! \retval same as \ref Tree_NodeAppend.
+//!
+//! \note   Call it between \ref Tree_EpochWriteEnter and \ref Tree_EpochWriteExit.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_RcuNodeAppend(TreeNode_t* pNode, TreeNode_t* pNewNode, int Mode)
+{
+    TreeNode_t** ppLink = NULL;
+
+    //! Check input parameters
+    if(NULL == pNode || NULL == pNewNode)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    //! Check mode parameter.
+    if(0 != (Mode & (~INSERT_MODE_MASK)))
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+    ppLink = ((Mode & INSERT_MODE_MASK) == INSERT_POS_LEFT) ? &pNode->left : &pNode->right;
+    if(NULL != *ppLink)
+    {
+        return (ERR_NODE_EXIST);
+    }
+
+#ifdef USE_PARENT_POINTER
+    pNewNode->parent = pNode;
+#endif
+
+    //! Node is ready, publish it.
+    TREE_RCU_ASSIGN(*ppLink, pNewNode);
+#ifdef USE_NODE_AUGMENT
+    Tree_NodeAugmentUpdate(pNode);
+#endif
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Unlink subtree from tree atomically.
+//! Readers that are still in the subtree can finish, free the subtree after
+//! \ref Tree_EpochSynchronize by any delete function.
+//!
+//! \param  [in] ppNode is the address of tree node pointer, it's the link in parent
+//!              or the root pointer (the link is found by parent pointer if
+//!              <USE_PARENT_POINTER> is enabled).
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         ppNode is NULL, \ref ERR_FAILURE if subtree is empty.
+//!
+//! \note   Call it between \ref Tree_EpochWriteEnter and \ref Tree_EpochWriteExit.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_RcuSubTreeUnlink(TreeNode_t** ppNode)
+{
+    TreeNode_t*  pNode   = NULL;
+    TreeNode_t** ppLink  = NULL;
+
+    //! Check input parameters
+    if(NULL == ppNode)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pNode = *ppNode;
+    if(NULL == pNode)
+    {
+        return (ERR_FAILURE);
+    }
+
+    ppLink = RcuLinkGet(ppNode);
+    TREE_RCU_ASSIGN(*ppLink, (TreeNode_t*)NULL);
+
+    //! Update ppNode only if it is a copy, a plain store to the link would race readers.
+    if(ppLink != ppNode)
+    {
+        *ppNode = NULL;
+    }
+
+#ifdef USE_PARENT_POINTER
+    if(NULL != TREE_PARENT(pNode))
+    {
+#ifdef USE_NODE_AUGMENT
+        Tree_NodeAugmentUpdate(TREE_PARENT(pNode));
+#endif
+        //! Subtree is detached, delete functions will not touch the tree any more.
+        pNode->parent = NULL;
+    }
+#endif
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Replace an node by its new copy atomically (read-copy-update).
+//! The new node takes over the children of old node, then it's published in the link.
+//! Readers see either the old value or the new value, never a partial update.
+//!
+//! \param  [in] ppNode is the address of tree node pointer, same as
+//!              \ref Tree_RcuSubTreeUnlink.
+//! \param  [in] pNewNode is the new copy, its value MUST be set before.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!
+//! \note
+//!         -# Call it between \ref Tree_EpochWriteEnter and \ref Tree_EpochWriteExit.
+//!         -# Free or reuse old node after \ref Tree_EpochSynchronize.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_RcuNodeReplace(TreeNode_t** ppNode, TreeNode_t* pNewNode)
+{
+    TreeNode_t*  pNode  = NULL;
+    TreeNode_t** ppLink = NULL;
+
+    //! Check input parameters
+    if(NULL == ppNode || NULL == *ppNode || NULL == pNewNode)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    pNode           = *ppNode;
+    ppLink          = RcuLinkGet(ppNode);
+    pNewNode->left  = pNode->left;
+    pNewNode->right = pNode->right;
+#ifdef USE_PARENT_POINTER
+    //! Tag bits (such as red black colour) are kept.
+    pNewNode->parent = pNode->parent;
+#endif
+#ifdef USE_NODE_AUGMENT
+    pNewNode->height = pNode->height;
+    pNewNode->size   = pNode->size;
+#endif
+
+    //! Publish new copy, then let children point to it.
+    TREE_RCU_ASSIGN(*ppLink, pNewNode);
+    if(ppLink != ppNode)
+    {
+        *ppNode = pNewNode;
+    }
+#ifdef USE_PARENT_POINTER
+    if(NULL != pNewNode->left)
+    {
+        TREE_PARENT_SET(pNewNode->left, pNewNode);
+    }
+    if(NULL != pNewNode->right)
+    {
+        TREE_PARENT_SET(pNewNode->right, pNewNode);
+    }
+#endif
+
+    return (ERR_SUCCESS);
+}
+
+//! \internal
+//! \brief Count nodes passed by \ref Tree_RcuFind, see \ref Tree_StatsDescent.
+#ifdef USE_TREE_STATS
+#define RCU_DEPTH_STEP(Depth)       ((Depth)++)
+#define RCU_DEPTH_DONE(Depth)       Tree_StatsDescent(Depth)
+#else
+#define RCU_DEPTH_STEP(Depth)       ((void)0)
+#define RCU_DEPTH_DONE(Depth)       ((void)(Depth))
+#endif
+
+//! \internal
+//! \brief Work stack of RCU reader walk, it starts with Buf on call stack.
+typedef struct RcuStack
+{
+    TreeNode_t** pBase;                     //!< Buf or heap buffer.
+    int          Size;                      //!< Entries of pBase.
+    int          Top;                       //!< Entries in use.
+#ifdef USE_TREE_STATS
+    int          Peak;                      //!< The most entries in use.
+#endif
+    TreeNode_t*  Buf[TREE_STACK_DEPTH];     //!< Default buffer.
+}RcuStack_t;
+
+//! \internal
+//! \brief Init RCU work stack with the default buffer.
+static void RcuStackInit(RcuStack_t* pStack)
+{
+    pStack->pBase = pStack->Buf;
+    pStack->Size  = TREE_STACK_DEPTH;
+    pStack->Top   = 0;
+#ifdef USE_TREE_STATS
+    pStack->Peak  = 0;
+#endif
+}
+
+//! \internal
+//! \brief Free heap buffer of RCU work stack.
+static void RcuStackRelease(RcuStack_t* pStack)
+{
+#ifdef USE_DYNAMIC_MEMORY
+    if(pStack->pBase != pStack->Buf)
+    {
+        free(pStack->pBase);
+    }
+#endif // USE_DYNAMIC_MEMORY
+
+    pStack->pBase = pStack->Buf;
+}
+
+//! \internal
+//! \brief Push node to RCU work stack, the stack is doubled on heap when it is full.
+//! \retval \ref ERR_SUCCESS, or \ref ERR_MEM if the stack can not grow.
+static TreeErrorCode_t RcuStackPush(RcuStack_t* pStack, TreeNode_t* pNode)
+{
+    if(pStack->Top >= pStack->Size)
+    {
+#ifdef USE_DYNAMIC_MEMORY
+        TreeNode_t** pBuf = NULL;
+
+        if(pStack->Size > INT_MAX / 2)
+        {
+            return (ERR_MEM);
+        }
+
+        pBuf = (TreeNode_t**)malloc((size_t)pStack->Size * 2 * sizeof(TreeNode_t*));
+        if(NULL == pBuf)
+        {
+            return (ERR_MEM);
+        }
+
+        memcpy(pBuf, pStack->pBase, (size_t)pStack->Top * sizeof(TreeNode_t*));
+        RcuStackRelease(pStack);
+        pStack->pBase  = pBuf;
+        pStack->Size  *= 2;
+#else
+        return (ERR_MEM);
+#endif // USE_DYNAMIC_MEMORY
+    }
+
+    pStack->pBase[pStack->Top++] = pNode;
+#ifdef USE_TREE_STATS
+    if(pStack->Top > pStack->Peak)
+    {
+        pStack->Peak = pStack->Top;
+    }
+#endif
+
+    return (ERR_SUCCESS);
+}
+
+//! \internal
+//! \brief Pre-order walk of published subtree, return the first non-zero value of pFun,
+//!        or \ref ERR_MEM if the work stack can not grow.
+//!        Right child is pushed and left child is followed, so a left or right vine
+//!        needs one entry only.
+static int RcuPreOrderWalk(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                           RcuStack_t* pStack)
+{
+    TreeNode_t* pRight = NULL;
+    int         Ret    = 0;
+
+    for(;;)
+    {
+        while(NULL != pNode)
+        {
+            STATS_ADD(Callbacks, 1);
+            Ret = pFun(Ctx, pNode->data);
+            if(0 != Ret)
+            {
+                return (Ret);
+            }
+
+            pRight = TREE_RCU_DEREF(pNode->right);
+            if(NULL != pRight && ERR_SUCCESS != RcuStackPush(pStack, pRight))
+            {
+                return (ERR_MEM);
+            }
+
+            pNode = TREE_RCU_DEREF(pNode->left);
+        }
+
+        if(0 == pStack->Top)
+        {
+            return (0);
+        }
+        pNode = pStack->pBase[--pStack->Top];
+    }
+}
+
+//! \internal
+//! \brief In-order walk of published subtree, return the first non-zero value of pFun,
+//!        or \ref ERR_MEM if the work stack can not grow.
+static int RcuInOrderWalk(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx,
+                          RcuStack_t* pStack)
+{
+    int Ret = 0;
+
+    for(;;)
+    {
+        while(NULL != pNode)
+        {
+            if(ERR_SUCCESS != RcuStackPush(pStack, pNode))
+            {
+                return (ERR_MEM);
+            }
+            pNode = TREE_RCU_DEREF(pNode->left);
+        }
+
+        if(0 == pStack->Top)
+        {
+            return (0);
+        }
+        pNode = pStack->pBase[--pStack->Top];
+
+        STATS_ADD(Callbacks, 1);
+        Ret = pFun(Ctx, pNode->data);
+        if(0 != Ret)
+        {
+            return (Ret);
+        }
+
+        pNode = TREE_RCU_DEREF(pNode->right);
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Foreach Tree Node in pre-order, in read side critical section.
+//! Same as \ref Tree_TravesePreOrder, but every link is loaded by \ref TREE_RCU_DEREF,
+//! so nodes published by writers are seen fully initialized.
+//!
+//! \param  [in] pNode is the root of tree, load it by \ref TREE_RCU_DEREF.
+//! \param  [in] pFun is the user's callback.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the work stack
+//!         can not grow.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note
+//!         -# Call it between \ref Tree_EpochReadEnter and \ref Tree_EpochReadExit.
+//!         -# No recursion, the work stack starts with <TREE_STACK_DEPTH> entries on
+//!            call stack and grows on heap with <USE_DYNAMIC_MEMORY>, it holds the
+//!            right children pending on the current path.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_RcuTravesePreOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    RcuStack_t Stack;
+    int        Ret = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    RcuStackInit(&Stack);
+    Ret = RcuPreOrderWalk(pNode, pFun, Ctx, &Stack);
+    RcuStackRelease(&Stack);
+    if(ERR_MEM == Ret)
+    {
+        return (ERR_MEM);
+    }
+
+    STATS_DEPTH(Stack.Peak);
+    STATS_END(Travese, Start);
+    return ((TreeErrorCode_t)Ret);
+}
+
+//****************************************************************************************
+//
+//! \brief  Foreach Tree Node in in-order, in read side critical section.
+//! Same as \ref Tree_TraveseInOrder, but every link is loaded by \ref TREE_RCU_DEREF,
+//! so nodes published by writers are seen fully initialized.
+//!
+//! \param  [in] pNode is the root of tree, load it by \ref TREE_RCU_DEREF.
+//! \param  [in] pFun is the user's callback.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the work stack
+//!         can not grow.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note
+//!         -# Call it between \ref Tree_EpochReadEnter and \ref Tree_EpochReadExit.
+//!         -# No recursion, the work stack starts with <TREE_STACK_DEPTH> entries on
+//!            call stack and grows on heap with <USE_DYNAMIC_MEMORY>, it holds the
+//!            nodes whose left subtree is being walked.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_RcuTraveseInOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx)
+{
+    RcuStack_t Stack;
+    int        Ret = 0;
+    STATS_TIMER(Start);
+
+    if(NULL == pNode || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    RcuStackInit(&Stack);
+    Ret = RcuInOrderWalk(pNode, pFun, Ctx, &Stack);
+    RcuStackRelease(&Stack);
+    if(ERR_MEM == Ret)
+    {
+        return (ERR_MEM);
+    }
+
+    STATS_DEPTH(Stack.Peak);
+    STATS_END(Travese, Start);
+    return ((TreeErrorCode_t)Ret);
+}
+
+//****************************************************************************************
+//
+//! \brief  Find node in binary search tree, in read side critical section.
+//! Same as \ref Tree_BstFind, but every link is loaded by \ref TREE_RCU_DEREF.
+//!
+//! \param  [in] pRoot is the root of tree, load it by \ref TREE_RCU_DEREF.
+//! \param  [in] Key is the key that want to find, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//! \retval the node whose data is equal to Key, or NULL if not found.
+//!
+//! \note
+//!         -# Call it between \ref Tree_EpochReadEnter and \ref Tree_EpochReadExit,
+//!            the node is valid until \ref Tree_EpochReadExit.
+//!         -# O(height), no recursion.
+//
+//****************************************************************************************
+TreeNode_t* Tree_RcuFind(TreeNode_t* pRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx)
+{
+    int Ret   = 0;
+    int Depth = 0;
+
+    if(NULL == pCmp)
+    {
+        return (NULL);
+    }
+
+    while(NULL != pRoot)
+    {
+        RCU_DEPTH_STEP(Depth);
+        Ret = pCmp(Ctx, Key, pRoot->data);
+        if(0 == Ret)
+        {
+            RCU_DEPTH_DONE(Depth);
+            return (pRoot);
+        }
+
+        pRoot = (Ret < 0) ? TREE_RCU_DEREF(pRoot->left) : TREE_RCU_DEREF(pRoot->right);
+    }
+
+    RCU_DEPTH_DONE(Depth);
+    return (NULL);
+}
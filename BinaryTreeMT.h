@@ -0,0 +1,551 @@
+//****************************************************************************************
+//!
+//! \file    BinaryTreeMT.h
+//! \brief   Multi-thread Binary Tree Interface.
+//!          Parallel algorithms built on \ref TreeNode_t, POSIX threads are used.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Link with -lpthread (or -pthread).
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#ifndef __BINARYTREEMT_H__
+#define __BINARYTREEMT_H__
+
+#include "BinaryTree.h"
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//****************************************************************************************
+//!                           CONFIGURE MACRO
+//****************************************************************************************
+
+//! Max number of threads of parallel functions.
+//!
+//! \note Default: 64 threads.
+#ifndef TREE_MT_MAX_THREADS
+#define TREE_MT_MAX_THREADS    64
+#endif
+
+//! Max split depth of \ref Tree_TraveseParallel.
+//! Task deque of every thread has <TREE_MT_MAX_SPLIT> entries, they are located in
+//! the stack of calling thread, so no memory is allocated.
+//!
+//! \note Default: 32 levels.
+#ifndef TREE_MT_MAX_SPLIT
+#define TREE_MT_MAX_SPLIT      32
+#endif
+
+//! Max number of tasks of \ref Tree_SubTreeDelete_Parallel.
+//! The top of subtree is split into at most <TREE_MT_DELETE_TASKS> subtrees, they are
+//! located in the stack of calling thread.
+//!
+//! \note Default: 256 tasks.
+#ifndef TREE_MT_DELETE_TASKS
+#define TREE_MT_DELETE_TASKS   256
+#endif
+
+//! Max number of tasks of \ref Tree_SubTreeClone_Parallel.
+//! The top of subtree is split into at most <TREE_MT_CLONE_TASKS> subtrees, they are
+//! located in the stack of calling thread.
+//!
+//! \note Default: 256 tasks.
+#ifndef TREE_MT_CLONE_TASKS
+#define TREE_MT_CLONE_TASKS    256
+#endif
+
+//! Number of nodes moved at once between thread cache and shared pool of
+//! \ref Tree_NodeCacheAlloc. It's also the number of nodes got by one malloc call.
+//!
+//! \note Default: 64 nodes.
+#ifndef TREE_NODE_CACHE_BATCH
+#define TREE_NODE_CACHE_BATCH  64
+#endif
+
+//! Max number of concurrent readers of \ref TreeEpoch_t.
+//! Every reader thread owns one slot, slot index is in [0, <TREE_MT_MAX_READERS>).
+//!
+//! \note Default: 64 readers.
+#ifndef TREE_MT_MAX_READERS
+#define TREE_MT_MAX_READERS    64
+#endif
+
+//! Cache line size, reader slots are padded to it, so readers do not share lines.
+//!
+//! \note Default: 64 bytes.
+#ifndef TREE_MT_CACHE_LINE
+#define TREE_MT_CACHE_LINE     64
+#endif
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "BinaryTreeMT need __atomic builtins of GCC or clang."
+#endif
+
+//! \brief Read a link in read side critical section, such as the root pointer.
+#define TREE_RCU_DEREF(pLink)         __atomic_load_n(&(pLink), __ATOMIC_ACQUIRE)
+
+//! \brief Publish a link, the node MUST be fully initialized before.
+#define TREE_RCU_ASSIGN(pLink, pNode) __atomic_store_n(&(pLink), (pNode), __ATOMIC_RELEASE)
+
+//****************************************************************************************
+//!                           PUBLIC DATA INTERFACE
+//****************************************************************************************
+
+//****************************************************************************************
+//! \brief Background reclaimer, free subtrees in its own thread.
+//! Pending subtrees are chained through the left child of their roots, so no memory is
+//! allocated when a subtree is handed over.
+//****************************************************************************************
+typedef struct TreeReclaimer
+{
+    pthread_t       Thread;
+    pthread_mutex_t Lock;
+    pthread_cond_t  Cond;
+    TreeNode_t*     pHead;     //!< Pending subtrees.
+    int             Stop;
+}TreeReclaimer_t;
+
+//! \brief Reader slot of \ref TreeEpoch_t, 0 means the reader is not reading.
+typedef struct TreeEpochSlot
+{
+    unsigned long Epoch;
+    char          Pad[TREE_MT_CACHE_LINE - sizeof(unsigned long)];
+}TreeEpochSlot_t;
+
+//****************************************************************************************
+//! \brief Epoch domain, lock free readers and serialized writers.
+//! Readers enter and exit a read side critical section without lock, writers
+//! unlink nodes, wait a grace period by \ref Tree_EpochSynchronize, then free nodes.
+//****************************************************************************************
+typedef struct TreeEpoch
+{
+    TreeEpochSlot_t Slot[TREE_MT_MAX_READERS];
+    unsigned long   Epoch;
+    pthread_mutex_t Lock;      //!< Writer lock.
+}TreeEpoch_t;
+
+//****************************************************************************************
+//!                           PUBLIC API
+//****************************************************************************************
+
+//****************************************************************************************
+//
+//! \brief  Foreach Tree Node in parallel.
+//! The tree is split at subtree boundaries into tasks, every thread own a task deque
+//! and steal the oldest (biggest) task from other threads when its deque is empty.
+//! Nodes whose depth is < SplitDepth are split, deeper subtrees are visited by one
+//! thread, but while another thread is idle the oldest unvisited right subtree of
+//! them is given away as a new task, so a skewed tree is not left to one thread.
+//! Idle threads wait on a condition variable instead of spinning.
+//!
+//! \param  [in] pNode is the root of tree that want to traver.
+//! \param  [in] pFun is the user's callback, it is called once for every node, from
+//!              several threads at the same time and in no defined order.
+//! \param  [in] ppCtx is the array of Threads contexts, thread i always call pFun with
+//!              ppCtx[i], so every thread can reduce into its own context without
+//!              lock. Merge them after this function returns.
+//! \param  [in] Threads is the number of threads, include the calling thread, it should
+//!              be in [1, <TREE_MT_MAX_THREADS>].
+//! \param  [in] SplitDepth is the sequential cutoff, it should be in
+//!              [0, <TREE_MT_MAX_SPLIT>]. About 2^SplitDepth tasks are made for a
+//!              balanced tree, a few times of Threads is good for load balance.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Threads
+//!         or SplitDepth is out of range, \ref ERR_MEM if a sequential subtree is
+//!         deeper than <TREE_ITER_DEPTH> (without parent pointer only).
+//!         When pFun return non-zero, the thread stops at once and the others stop
+//!         at their next task, the first non-zero value is returned.
+//!
+//! \note
+//!         -# Only for callback that does not depend on visit order, such as an
+//!            associative and commutative reduction.
+//!         -# If a thread can not be created, the work is shared by the others.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_TraveseParallel(TreeNode_t* pNode, TreeCallBackFun_t pFun, void** ppCtx,
+                                            int Threads, int SplitDepth);
+
+//****************************************************************************************
+//
+//! \brief  Copy a subtree into arena by several threads.
+//! The top of subtree is split into subtrees, their sizes are counted in parallel, then
+//! every subtree is copied by \ref Tree_SubTreeClone into its own slice of arena in
+//! parallel, and the top nodes are copied by calling thread.
+//!
+//! \param  [in] pArena is the node arena.
+//! \param  [in] pNode is the root of subtree that want to clone.
+//! \param  [in] Threads is the number of threads, include the calling thread, it should
+//!              be in [1, <TREE_MT_MAX_THREADS>].
+//! \retval the root of copy, or NULL if pNode is NULL, Threads is out of range or arena
+//!         has not enough free nodes, then nothing is allocated from arena.
+//!
+//! \note
+//!         -# The copy is the same tree as \ref Tree_SubTreeClone, but the nodes of
+//!            every subtree are placed together.
+//!         -# With <USE_NODE_AUGMENT>, sizes are not counted.
+//
+//****************************************************************************************
+extern TreeNode_t* Tree_SubTreeClone_Parallel(TreeArena_t* pArena, TreeNode_t* pNode, int Threads);
+
+#ifdef USE_DYNAMIC_MEMORY
+//****************************************************************************************
+//
+//! \brief  Start a background reclaimer thread.
+//!
+//! \param  [in] pReclaimer is the address of reclaimer.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         pReclaimer is NULL, \ref ERR_FAILURE if the thread can not be created.
+//!
+//! \note   MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_ReclaimerCreate(TreeReclaimer_t* pReclaimer);
+
+//****************************************************************************************
+//
+//! \brief  Stop the reclaimer thread, all pending subtrees are freed before return.
+//!
+//! \param  [in] pReclaimer is the address of reclaimer.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         pReclaimer is NULL.
+//!
+//! \note   MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_ReclaimerDestory(TreeReclaimer_t* pReclaimer);
+
+//****************************************************************************************
+//
+//! \brief  Destory subtree in dynamic method by the background reclaimer.
+//! The subtree is detached from tree and handed over to reclaimer, then this function
+//! returns at once, nodes are freed later in the reclaimer thread.
+//!
+//! \param  [in] pReclaimer is the address of a running reclaimer.
+//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_FAILURE if subtree is empty,
+//!         \ref ERR_INVALID_POINTER if input parameters contain invalid pointer.
+//!
+//! \note
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//!         -# O(length of left spine) in calling thread, O(n) in reclaimer thread.
+//!         -# Subtree MUST not be accessed after this function, user's data pointed by
+//!            nodes is NOT freed.
+//!         -# With <USE_TREE_STATS>, frees are accounted to the block bound to calling
+//!            thread now, it must be valid until the reclaimer is destoryed.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_SubTreeDelete_Async(TreeReclaimer_t* pReclaimer, TreeNode_t** ppNode);
+
+//****************************************************************************************
+//
+//! \brief  Destory subtree in dynamic method by several threads.
+//! The top of subtree is split into subtrees, and they are freed by Threads threads
+//! (include the calling thread) in parallel.
+//!
+//! \param  [in] ppNode is the address of tree node pointer. typical it's the root of a tree.
+//! \param  [in] Threads is the number of threads, it should be in
+//!              [1, <TREE_MT_MAX_THREADS>].
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_FAILURE if subtree is empty,
+//!         \ref ERR_INVALID_POINTER if ppNode is NULL, \ref ERR_WRONG_PARAM if
+//!         Threads is out of range.
+//!
+//! \note
+//!         -# MUST uncomment <USE_DYNAMIC_MEMORY> macro in order to use this function.
+//!         -# The speedup depends on the allocator, free() that takes a global lock
+//!            does not scale, see <USE_NODE_CACHE>.
+//!         -# With <USE_TREE_STATS>, frees of all threads are accounted to the block
+//!            bound to calling thread.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_SubTreeDelete_Parallel(TreeNode_t** ppNode, int Threads);
+#endif // USE_DYNAMIC_MEMORY
+
+#ifdef USE_NODE_CACHE
+//****************************************************************************************
+//
+//! \brief  Allocate one node from the cache of calling thread.
+//! When the cache is empty, it takes all batches from the shared pool, and then it
+//! allocates <TREE_NODE_CACHE_BATCH> nodes by one malloc call if pool is empty too.
+//!
+//! \retval the address of node, it's NOT initialized. NULL if memory is exhausted.
+//!
+//! \note
+//!         -# MUST uncomment <USE_NODE_CACHE> macro in order to use this function,
+//!            then \ref Tree_NodeCreate call it.
+//!         -# Lock free, O(1).
+//!         -# Memory of nodes is never returned to malloc.
+//
+//****************************************************************************************
+extern TreeNode_t* Tree_NodeCacheAlloc(void);
+
+//****************************************************************************************
+//
+//! \brief  Put one node to the cache of calling thread.
+//! A full batch of <TREE_NODE_CACHE_BATCH> nodes is moved to the shared pool, so the
+//! node may be freed by a thread other than the one allocated it.
+//!
+//! \param  [in] pNode is the address of node got by \ref Tree_NodeCacheAlloc.
+//!
+//! \note
+//!         -# MUST uncomment <USE_NODE_CACHE> macro in order to use this function,
+//!            then \ref Tree_NodeDestory and dynamic delete functions call it.
+//!         -# Lock free, O(1).
+//
+//****************************************************************************************
+extern void Tree_NodeCacheFree(TreeNode_t* pNode);
+
+//****************************************************************************************
+//
+//! \brief  Move all nodes in the cache of calling thread to the shared pool.
+//!
+//! \note   It's called automatically when a thread that used the cache exits.
+//
+//****************************************************************************************
+extern void Tree_NodeCacheFlush(void);
+#endif // USE_NODE_CACHE
+
+//****************************************************************************************
+//
+//! \brief  Initialize epoch domain.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         pEpoch is NULL.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_EpochInit(TreeEpoch_t* pEpoch);
+
+//****************************************************************************************
+//
+//! \brief  Destory epoch domain, no reader or writer may use it any more.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         pEpoch is NULL.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_EpochDestory(TreeEpoch_t* pEpoch);
+
+//****************************************************************************************
+//
+//! \brief  Enter read side critical section.
+//! Nodes reachable from the tree are not freed until the reader exits, so the tree
+//! can be walked without lock.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//! \param  [in] Slot is the reader slot owned by calling thread, in
+//!              [0, <TREE_MT_MAX_READERS>).
+//!
+//! \note
+//!         -# Wait free, only the own slot is written, so readers scale with cores.
+//!         -# Can not be nested.
+//!         -# Load the root pointer by \ref TREE_RCU_DEREF, walk by
+//!            \ref Tree_RcuTravesePreOrder, \ref Tree_RcuTraveseInOrder, search by
+//!            \ref Tree_RcuFind, or load every link by \ref TREE_RCU_DEREF
+//!            in your own walk. Other traverse and search functions read links by plain
+//!            loads, they are data races to ThreadSanitizer and the C memory model.
+//!         -# Functions that walk up by parent pointer (\ref Tree_TravesePreOrder_Parent,
+//!            the iterator with <USE_PARENT_POINTER>) are NOT safe when subtrees are
+//!            unlinked.
+//
+//****************************************************************************************
+extern void Tree_EpochReadEnter(TreeEpoch_t* pEpoch, int Slot);
+
+//****************************************************************************************
+//
+//! \brief  Exit read side critical section.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//! \param  [in] Slot is the reader slot used by \ref Tree_EpochReadEnter.
+//
+//****************************************************************************************
+extern void Tree_EpochReadExit(TreeEpoch_t* pEpoch, int Slot);
+
+//****************************************************************************************
+//
+//! \brief  Enter write side, writers are serialized by a mutex.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//!
+//! \note   Writer can read links by plain loads, but \ref Tree_DepthGet and
+//!         \ref Tree_SizeGet borrow links without parent pointer, do not call them on
+//!         nodes that readers can reach.
+//
+//****************************************************************************************
+extern void Tree_EpochWriteEnter(TreeEpoch_t* pEpoch);
+
+//****************************************************************************************
+//
+//! \brief  Exit write side.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//
+//****************************************************************************************
+extern void Tree_EpochWriteExit(TreeEpoch_t* pEpoch);
+
+//****************************************************************************************
+//
+//! \brief  Wait a grace period.
+//! Return when every reader that was in read side critical section at the time of call
+//! has exited, so nodes unlinked before can be freed or reused.
+//!
+//! \param  [in] pEpoch is the address of epoch domain.
+//!
+//! \note   MUST not be called in read side critical section.
+//
+//****************************************************************************************
+extern void Tree_EpochSynchronize(TreeEpoch_t* pEpoch);
+
+//****************************************************************************************
+//
+//! \brief  Append an node, the new node is published atomically.
+//! Same as \ref Tree_NodeAppend, but concurrent readers see the node either not at all
+//! or fully initialized.
+//!
+//! \param  [in] pNode is the address of exising node.
+//! \param  [in] pNewNode is the address of node that want to insert, its value and
+//!              children MUST be set before.
+//! \param  [in] Mode is \ref INSERT_POS_LEFT or \ref INSERT_POS_RIGHT.
+//! \retval same as \ref Tree_NodeAppend.
+//!
+//! \note   Call it between \ref Tree_EpochWriteEnter and \ref Tree_EpochWriteExit.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_RcuNodeAppend(TreeNode_t* pNode, TreeNode_t* pNewNode, int Mode);
+
+//****************************************************************************************
+//
+//! \brief  Unlink subtree from tree atomically.
+//! Readers that are still in the subtree can finish, free the subtree after
+//! \ref Tree_EpochSynchronize by any delete function.
+//!
+//! \param  [in] ppNode is the address of tree node pointer, it's the link in parent
+//!              or the root pointer (the link is found by parent pointer if
+//!              <USE_PARENT_POINTER> is enabled).
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         ppNode is NULL, \ref ERR_FAILURE if subtree is empty.
+//!
+//! \note   Call it between \ref Tree_EpochWriteEnter and \ref Tree_EpochWriteExit.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_RcuSubTreeUnlink(TreeNode_t** ppNode);
+
+//****************************************************************************************
+//
+//! \brief  Replace an node by its new copy atomically (read-copy-update).
+//! The new node takes over the children of old node, then it's published in the link.
+//! Readers see either the old value or the new value, never a partial update.
+//!
+//! \param  [in] ppNode is the address of tree node pointer, same as
+//!              \ref Tree_RcuSubTreeUnlink.
+//! \param  [in] pNewNode is the new copy, its value MUST be set before.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!
+//! \note
+//!         -# Call it between \ref Tree_EpochWriteEnter and \ref Tree_EpochWriteExit.
+//!         -# Free or reuse old node after \ref Tree_EpochSynchronize.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_RcuNodeReplace(TreeNode_t** ppNode, TreeNode_t* pNewNode);
+
+//****************************************************************************************
+//
+//! \brief  Foreach Tree Node in pre-order, in read side critical section.
+//! Same as \ref Tree_TravesePreOrder, but every link is loaded by \ref TREE_RCU_DEREF,
+//! so nodes published by writers are seen fully initialized.
+//!
+//! \param  [in] pNode is the root of tree, load it by \ref TREE_RCU_DEREF.
+//! \param  [in] pFun is the user's callback.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the work stack
+//!         can not grow.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note
+//!         -# Call it between \ref Tree_EpochReadEnter and \ref Tree_EpochReadExit.
+//!         -# No recursion, the work stack starts with <TREE_STACK_DEPTH> entries on
+//!            call stack and grows on heap with <USE_DYNAMIC_MEMORY>, it holds the
+//!            right children pending on the current path.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_RcuTravesePreOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//
+//! \brief  Foreach Tree Node in in-order, in read side critical section.
+//! Same as \ref Tree_TraveseInOrder, but every link is loaded by \ref TREE_RCU_DEREF,
+//! so nodes published by writers are seen fully initialized.
+//!
+//! \param  [in] pNode is the root of tree, load it by \ref TREE_RCU_DEREF.
+//! \param  [in] pFun is the user's callback.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_MEM if the work stack
+//!         can not grow.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//!
+//! \note
+//!         -# Call it between \ref Tree_EpochReadEnter and \ref Tree_EpochReadExit.
+//!         -# No recursion, the work stack starts with <TREE_STACK_DEPTH> entries on
+//!            call stack and grows on heap with <USE_DYNAMIC_MEMORY>, it holds the
+//!            nodes whose left subtree is being walked.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_RcuTraveseInOrder(TreeNode_t* pNode, TreeCallBackFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//
+//! \brief  Find node in binary search tree, in read side critical section.
+//! Same as \ref Tree_BstFind, but every link is loaded by \ref TREE_RCU_DEREF.
+//!
+//! \param  [in] pRoot is the root of tree, load it by \ref TREE_RCU_DEREF.
+//! \param  [in] Key is the key that want to find, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function.
+//! \param  [in] Ctx is context environment, just for compare function.
+//! \retval the node whose data is equal to Key, or NULL if not found.
+//!
+//! \note
+//!         -# Call it between \ref Tree_EpochReadEnter and \ref Tree_EpochReadExit,
+//!            the node is valid until \ref Tree_EpochReadExit.
+//!         -# O(height), no recursion.
+//
+//****************************************************************************************
+extern TreeNode_t* Tree_RcuFind(TreeNode_t* pRoot, void* Key, TreeCompareFun_t pCmp, void* Ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BINARYTREEMT_H__
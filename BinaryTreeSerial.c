@@ -0,0 +1,1029 @@
+//******************************************************************************
+//!
+//! \file    BinaryTreeSerial.c
+//! \brief   Binary Tree Image Implement
+//!          Save tree into a position independent image, and use the image in place.
+//!          Stream tree chunk by chunk with bounded memory.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#include "BinaryTreeSerial.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+
+#ifdef USE_IMAGE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+//**************************************************************************************
+//!                     ASSERT MACRO
+//**************************************************************************************
+#ifndef ASSERT
+
+#ifdef  NDEBUG
+#define ASSERT(x)
+#else
+#define ASSERT(x) do {while(!(x));} while(0)
+#endif
+
+#endif  // ASSERT
+
+//****************************************************************************************
+//!                     IMAGE FORMAT
+//****************************************************************************************
+
+//! \internal
+//! \brief "BTIM" in memory, version of format, and the byte order mark.
+#define IMAGE_MAGIC            ((uint32_t)0x4D495442)
+#define IMAGE_VERSION          ((uint16_t)1)
+#define IMAGE_ENDIAN           ((uint16_t)0x0102)
+
+//! \internal
+//! \brief Header and records are aligned to 8 bytes.
+#define IMAGE_ALIGN            8
+
+//! \internal
+//! \brief Image header, 32 bytes, it's followed by Count records.
+typedef struct ImageHeader
+{
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t Endian;
+    uint32_t Count;
+    uint32_t RecSize;
+    uint32_t DataSize;
+    uint32_t Reserved[3];
+}ImageHeader_t;
+
+//! \internal
+//! \brief Record of one node, it's followed by DataSize bytes payload.
+//! Children are linked by record index, 0 means no child because record 0 is root.
+typedef struct ImageRec
+{
+    uint32_t Left;
+    uint32_t Right;
+}ImageRec_t;
+
+//! \internal
+//! \brief Pending right child of \ref Tree_ImageSave.
+typedef struct ImageTask
+{
+    TreeNode_t* pNode;
+    uint32_t    Parent;
+}ImageTask_t;
+
+//! \internal
+//! \brief Byte size of record with DataSize bytes payload.
+#define IMAGE_REC_SIZE(DataSize)                                                      \
+    ((sizeof(ImageRec_t) + (size_t)(DataSize) + IMAGE_ALIGN - 1) & ~(size_t)(IMAGE_ALIGN - 1))
+
+//! \internal
+//! \brief Get record Rec of image.
+#define IMAGE_REC(pImage, Rec)                                                        \
+    ((const ImageRec_t*)((pImage)->pRec + (size_t)(Rec) * (size_t)(pImage)->RecSize))
+
+//! \internal
+//! \brief Check child links of record Rec, the image is not trusted.
+//! Records are in pre-order, so left child is the next record and right child is after
+//! it. A link that breaks this would read out of image or loop, it means no child.
+#define IMAGE_LEFT_OK(pImage, Rec, Left)                                              \
+    ((uint32_t)(Rec) + 1 == (Left) && (Left) < (uint32_t)(pImage)->Count)
+#define IMAGE_RIGHT_OK(pImage, Rec, Right)                                            \
+    ((uint32_t)(Rec) < (Right) && (Right) < (uint32_t)(pImage)->Count)
+
+//****************************************************************************************
+//!                     STREAM FORMAT
+//****************************************************************************************
+
+//! \internal
+//! \brief Flag byte of stream record. Null marker is only used for empty tree, the null
+//! children of node are marked by the missing child bits.
+#define STREAM_NULL            ((unsigned char)0x00)
+#define STREAM_NODE            ((unsigned char)0x80)
+#define STREAM_LEFT            ((unsigned char)0x01)
+#define STREAM_RIGHT           ((unsigned char)0x02)
+
+//****************************************************************************************
+//
+//! \internal
+//! \brief  Decode one record and link the new node into tree.
+//!
+//! \param  [in] pDec is the decoder.
+//! \param  [in] pRec is the whole record.
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_FAILURE if the flag is
+//!         wrong, \ref ERR_MEM if pool or stack is empty, or the value of decode function.
+//
+//****************************************************************************************
+static TreeErrorCode_t StreamRecDecode(TreeStreamDec_t* pDec, const unsigned char* pRec)
+{
+    TreeNode_t*   pNode = NULL;
+    unsigned char Flag  = pRec[0];
+    int           Ret   = 0;
+
+    if(STREAM_NODE != (Flag & ~(STREAM_LEFT | STREAM_RIGHT)))
+    {
+        return (ERR_FAILURE);
+    }
+
+    //! Node with both children wait for its right child on stack.
+    if((STREAM_LEFT | STREAM_RIGHT) == (Flag & (STREAM_LEFT | STREAM_RIGHT)) && pDec->Top >= pDec->Size)
+    {
+        return (ERR_MEM);
+    }
+
+    pNode = Tree_PoolAlloc(pDec->pPool);
+    if(NULL == pNode)
+    {
+        return (ERR_MEM);
+    }
+
+    if(NULL != pDec->pFun)
+    {
+        Ret = pDec->pFun(pDec->Ctx, pNode, pRec + 1, pDec->DataSize);
+        if(0 != Ret)
+        {
+            Tree_PoolFree(pDec->pPool, &pNode);
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+#ifdef USE_INLINE_DATA
+    else if(pDec->DataSize > 0)
+    {
+        memcpy(pNode->data, pRec + 1, (size_t)pDec->DataSize);
+    }
+#endif
+
+    if(NULL == pDec->pRoot)
+    {
+        pDec->pRoot = pNode;
+    }
+    else
+    {
+        Tree_NodeAppend(pDec->pLast, pNode, pDec->LastPos);
+    }
+
+    //! Pre-order: left child is the next record, then right child.
+    if(0 != (Flag & STREAM_LEFT))
+    {
+        if(0 != (Flag & STREAM_RIGHT))
+        {
+            pDec->pStack[pDec->Top++] = pNode;
+        }
+        pDec->pLast   = pNode;
+        pDec->LastPos = INSERT_POS_LEFT;
+    }
+    else if(0 != (Flag & STREAM_RIGHT))
+    {
+        pDec->pLast   = pNode;
+        pDec->LastPos = INSERT_POS_RIGHT;
+    }
+    else if(pDec->Top > 0)
+    {
+        pDec->pLast   = pDec->pStack[--pDec->Top];
+        pDec->LastPos = INSERT_POS_RIGHT;
+    }
+    else
+    {
+        pDec->pLast = NULL;
+        pDec->Done  = 1;
+    }
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//!                     PUBLIC API
+//****************************************************************************************
+
+//****************************************************************************************
+//
+//! \brief  Get the byte size of image of tree.
+//!
+//! \param  [in] pNode is the root of tree, NULL for empty tree.
+//! \param  [in] DataSize is the payload size of every record, in bytes.
+//! \retval the byte size of image, 0 if DataSize < 0.
+//
+//****************************************************************************************
+size_t Tree_ImageSize(TreeNode_t* pNode, int DataSize)
+{
+    int Count = 0;
+
+    if(DataSize < 0)
+    {
+        return (0);
+    }
+
+    Count = (NULL == pNode) ? 0 : Tree_SizeGet(pNode);
+
+    return (sizeof(ImageHeader_t) + (size_t)Count * IMAGE_REC_SIZE(DataSize));
+}
+
+//****************************************************************************************
+//
+//! \brief  Save tree into image buffer.
+//! Records are written in pre-order, so the left child of record i is record i + 1,
+//! and the right child is linked by its record index. No pointer is stored, the
+//! image can be loaded at any address.
+//!
+//! \param  [in] pNode is the root of tree, NULL for empty tree.
+//! \param  [in] pBuf is the image buffer, it MUST be 8 bytes aligned.
+//! \param  [in] BufSize is the byte size of pBuf, see \ref Tree_ImageSize.
+//! \param  [in] DataSize is the payload size of every record, in bytes.
+//! \param  [in] pEnc is the user's encode function, NULL to copy DataSize bytes from
+//!              the data of node (the data pointer, or inline data).
+//! \param  [in] Ctx is context environment, just for encode function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if pBuf
+//!         is NULL, \ref ERR_WRONG_PARAM if DataSize is wrong, \ref ERR_MEM if
+//!         BufSize is too small or the tree is deeper than <TREE_IMAGE_DEPTH>.
+//!         When pEnc return non-zero, saving stops at once and the value is returned.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_ImageSave(TreeNode_t* pNode, void* pBuf, size_t BufSize, int DataSize,
+                               TreeEncodeFun_t pEnc, void* Ctx)
+{
+    ImageHeader_t* pHeader  = (ImageHeader_t*)pBuf;
+    unsigned char* pRec     = NULL;
+    ImageTask_t    Stack[TREE_IMAGE_DEPTH];
+    int            Top      = 0;
+    int            RecSize  = 0;
+    uint32_t       Count    = 0;
+    int            Ret      = 0;
+    size_t         Size     = 0;
+
+    //! Check input parameters
+    if(NULL == pBuf)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(DataSize < 0)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+#ifdef USE_INLINE_DATA
+    //! Only TREE_DATA_SIZE bytes can be copied from node.
+    if(NULL == pEnc && DataSize > TREE_DATA_SIZE)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+#endif
+
+    Size = Tree_ImageSize(pNode, DataSize);
+    if(0 == Size || BufSize < Size)
+    {
+        return (ERR_MEM);
+    }
+
+    RecSize = (int)IMAGE_REC_SIZE(DataSize);
+    pRec    = (unsigned char*)pBuf + sizeof(ImageHeader_t);
+
+    //! Pre-order walk, a pending right child is pushed with the record of its parent.
+    while(NULL != pNode)
+    {
+        ImageRec_t* pCur = (ImageRec_t*)(pRec + (size_t)Count * RecSize);
+
+        pCur->Left  = (NULL != pNode->left) ? Count + 1 : 0;
+        pCur->Right = 0;
+        if(NULL != pEnc)
+        {
+            Ret = pEnc(Ctx, pNode->data, pCur + 1, DataSize);
+            if(0 != Ret)
+            {
+                return ((TreeErrorCode_t)Ret);
+            }
+        }
+        else if(DataSize > 0)
+        {
+            memcpy(pCur + 1, pNode->data, (size_t)DataSize);
+        }
+
+        if(NULL != pNode->right)
+        {
+            if(Top >= TREE_IMAGE_DEPTH)
+            {
+                return (ERR_MEM);
+            }
+            Stack[Top].pNode  = pNode->right;
+            Stack[Top].Parent = Count;
+            Top++;
+        }
+        Count++;
+
+        if(NULL != pNode->left)
+        {
+            pNode = pNode->left;
+        }
+        else if(Top > 0)
+        {
+            //! Right child is the next record, link it to its parent.
+            Top--;
+            pNode = Stack[Top].pNode;
+            ((ImageRec_t*)(pRec + (size_t)Stack[Top].Parent * RecSize))->Right = Count;
+        }
+        else
+        {
+            pNode = NULL;
+        }
+    }
+
+    pHeader->Magic    = IMAGE_MAGIC;
+    pHeader->Version  = IMAGE_VERSION;
+    pHeader->Endian   = IMAGE_ENDIAN;
+    pHeader->Count    = Count;
+    pHeader->RecSize  = (uint32_t)RecSize;
+    pHeader->DataSize = (uint32_t)DataSize;
+    memset(pHeader->Reserved, 0, sizeof(pHeader->Reserved));
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Open image in memory, nothing is copied or allocated.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] pBuf is the image, it MUST be 8 bytes aligned and valid while the
+//!              handle is in use.
+//! \param  [in] Size is the byte size of pBuf.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if input
+//!         parameters contain invalid pointer, \ref ERR_FAILURE if pBuf is not a valid
+//!         image of this platform (magic, version, byte order or size is wrong).
+//!
+//! \note   O(1), records are not checked one by one. A child link which is not after
+//!         its parent in pre-order, or is out of image, is read as no child by
+//!         \ref Tree_ImageLeft, \ref Tree_ImageRight and \ref Tree_ImageFind.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_ImageOpen(TreeImage_t* pImage, const void* pBuf, size_t Size)
+{
+    const ImageHeader_t* pHeader = (const ImageHeader_t*)pBuf;
+
+    //! Check input parameters
+    if(NULL == pImage || NULL == pBuf)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(Size < sizeof(ImageHeader_t) || 0 != ((uintptr_t)pBuf & (IMAGE_ALIGN - 1)))
+    {
+        return (ERR_FAILURE);
+    }
+
+    if(IMAGE_MAGIC != pHeader->Magic || IMAGE_VERSION != pHeader->Version
+       || IMAGE_ENDIAN != pHeader->Endian || pHeader->DataSize > INT_MAX - IMAGE_ALIGN
+       || IMAGE_REC_SIZE(pHeader->DataSize) != pHeader->RecSize || pHeader->Count > INT_MAX
+       || (Size - sizeof(ImageHeader_t)) / pHeader->RecSize < pHeader->Count)
+    {
+        return (ERR_FAILURE);
+    }
+
+    pImage->pRec     = (const unsigned char*)pBuf + sizeof(ImageHeader_t);
+    pImage->Count    = (int)pHeader->Count;
+    pImage->RecSize  = (int)pHeader->RecSize;
+    pImage->DataSize = (int)pHeader->DataSize;
+    pImage->pMap     = NULL;
+    pImage->MapSize  = 0;
+
+    return (ERR_SUCCESS);
+}
+
+#ifdef USE_IMAGE_MMAP
+//****************************************************************************************
+//
+//! \brief  Map image file into memory and open it.
+//! Pages are read by the operating system when records are visited, so load time does
+//! not depend on the size of tree.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] pPath is the file path.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if input
+//!         parameters contain invalid pointer, \ref ERR_FAILURE if file can not be
+//!         mapped or it's not a valid image.
+//!
+//! \note   Only available when <USE_IMAGE_MMAP> is defined.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_ImageMap(TreeImage_t* pImage, const char* pPath)
+{
+    struct stat Stat;
+    void*       pMap = NULL;
+    int         Fd   = -1;
+
+    //! Check input parameters
+    if(NULL == pImage || NULL == pPath)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    Fd = open(pPath, O_RDONLY);
+    if(Fd < 0)
+    {
+        return (ERR_FAILURE);
+    }
+
+    if(0 != fstat(Fd, &Stat) || Stat.st_size <= 0)
+    {
+        close(Fd);
+        return (ERR_FAILURE);
+    }
+
+    //! Mapping is kept after the file is closed.
+    pMap = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, Fd, 0);
+    close(Fd);
+    if(MAP_FAILED == pMap)
+    {
+        return (ERR_FAILURE);
+    }
+
+    if(ERR_SUCCESS != Tree_ImageOpen(pImage, pMap, (size_t)Stat.st_size))
+    {
+        munmap(pMap, (size_t)Stat.st_size);
+        return (ERR_FAILURE);
+    }
+
+    pImage->pMap    = pMap;
+    pImage->MapSize = (size_t)Stat.st_size;
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Unmap image opened by \ref Tree_ImageMap.
+//!
+//! \param  [in] pImage is the image handle.
+//! \retval \ref ERR_FAILURE if image is not mapped, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   Only available when <USE_IMAGE_MMAP> is defined.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_ImageUnmap(TreeImage_t* pImage)
+{
+    //! Check input parameters
+    if(NULL == pImage || NULL == pImage->pMap)
+    {
+        return (ERR_FAILURE);
+    }
+
+    munmap(pImage->pMap, pImage->MapSize);
+    pImage->pRec    = NULL;
+    pImage->Count   = 0;
+    pImage->pMap    = NULL;
+    pImage->MapSize = 0;
+
+    return (ERR_SUCCESS);
+}
+#endif // USE_IMAGE_MMAP
+
+//****************************************************************************************
+//
+//! \brief  Get the root record of image.
+//!
+//! \param  [in] pImage is the image handle.
+//! \retval 0 if image is not empty, otherwise \ref TREE_IMAGE_NONE.
+//
+//****************************************************************************************
+int Tree_ImageRoot(const TreeImage_t* pImage)
+{
+    ASSERT(NULL != pImage);
+
+    return ((pImage->Count > 0) ? 0 : TREE_IMAGE_NONE);
+}
+
+//****************************************************************************************
+//
+//! \brief  Get the left child record.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] Rec is a valid record index.
+//! \retval the record index of left child, or \ref TREE_IMAGE_NONE if it has no left
+//!         child or the link is broken.
+//
+//****************************************************************************************
+int Tree_ImageLeft(const TreeImage_t* pImage, int Rec)
+{
+    uint32_t Left = 0;
+
+    ASSERT(NULL != pImage);
+    ASSERT(Rec >= 0 && Rec < pImage->Count);
+
+    Left = IMAGE_REC(pImage, Rec)->Left;
+
+    return (IMAGE_LEFT_OK(pImage, Rec, Left) ? (int)Left : TREE_IMAGE_NONE);
+}
+
+//****************************************************************************************
+//
+//! \brief  Get the right child record.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] Rec is a valid record index.
+//! \retval the record index of right child, or \ref TREE_IMAGE_NONE if it has no right
+//!         child or the link is broken.
+//
+//****************************************************************************************
+int Tree_ImageRight(const TreeImage_t* pImage, int Rec)
+{
+    uint32_t Right = 0;
+
+    ASSERT(NULL != pImage);
+    ASSERT(Rec >= 0 && Rec < pImage->Count);
+
+    Right = IMAGE_REC(pImage, Rec)->Right;
+
+    return (IMAGE_RIGHT_OK(pImage, Rec, Right) ? (int)Right : TREE_IMAGE_NONE);
+}
+
+//****************************************************************************************
+//
+//! \brief  Get the payload of record.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] Rec is a valid record index.
+//! \retval the address of payload in image, it's 8 bytes aligned and read only.
+//
+//****************************************************************************************
+const void* Tree_ImageData(const TreeImage_t* pImage, int Rec)
+{
+    ASSERT(NULL != pImage);
+    ASSERT(Rec >= 0 && Rec < pImage->Count);
+
+    return (IMAGE_REC(pImage, Rec) + 1);
+}
+
+//****************************************************************************************
+//
+//! \brief  Foreach record of image in pre-order.
+//! Records are stored in pre-order, so it's a sequential scan of image.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] pFun is the user's callback, its Data parameter is the payload of
+//!              record, it MUST not be written.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_ImageTravesePreOrder(const TreeImage_t* pImage, TreeCallBackFun_t pFun, void* Ctx)
+{
+    int Ret = 0;
+    int i   = 0;
+
+    //! Check input parameters
+    if(NULL == pImage || NULL == pFun)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    for(i = 0; i < pImage->Count; i++)
+    {
+        Ret = pFun(Ctx, (void*)(IMAGE_REC(pImage, i) + 1));
+        if(0 != Ret)
+        {
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Find record in image of binary search tree.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] Key is the key that want to find, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function, its Data parameter is the payload.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the record whose payload is equal to Key, or \ref TREE_IMAGE_NONE.
+//!
+//! \note   O(height), like \ref Tree_BstFind.
+//
+//****************************************************************************************
+int Tree_ImageFind(const TreeImage_t* pImage, void* Key, TreeCompareFun_t pCmp, void* Ctx)
+{
+    const ImageRec_t* pRec = NULL;
+    uint32_t          Rec  = 0;
+    int               Ret  = 0;
+
+    //! Check input parameters
+    if(NULL == pImage || NULL == pCmp || 0 == pImage->Count)
+    {
+        return (TREE_IMAGE_NONE);
+    }
+
+    //! Record 0 is never a child, so index 0 of a child link means no child. A valid
+    //! child is always after its parent, so the loop ends in Count steps at most.
+    for(;;)
+    {
+        pRec = IMAGE_REC(pImage, Rec);
+        Ret  = pCmp(Ctx, Key, (void*)(pRec + 1));
+        if(0 == Ret)
+        {
+            return ((int)Rec);
+        }
+
+        if(Ret < 0)
+        {
+            if(!IMAGE_LEFT_OK(pImage, Rec, pRec->Left))
+            {
+                return (TREE_IMAGE_NONE);
+            }
+            Rec = pRec->Left;
+        }
+        else
+        {
+            if(!IMAGE_RIGHT_OK(pImage, Rec, pRec->Right))
+            {
+                return (TREE_IMAGE_NONE);
+            }
+            Rec = pRec->Right;
+        }
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Initialize stream encoder.
+//!
+//! \param  [in] pEnc is the encoder.
+//! \param  [in] pNode is the root of tree, NULL for empty tree.
+//! \param  [in] pStack is the work stack, one entry for every pending right child.
+//! \param  [in] Size is the capacity of pStack, the height of tree is enough.
+//! \param  [in] DataSize is the payload size of every record, in bytes.
+//! \param  [in] pFun is the user's encode function, NULL to copy DataSize bytes from
+//!              the data of node (the data pointer, or inline data).
+//! \param  [in] Ctx is context environment, just for encode function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Size or
+//!         DataSize is wrong.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_StreamEncodeInit(TreeStreamEnc_t* pEnc, TreeNode_t* pNode, TreeNode_t** pStack,
+                                      int Size, int DataSize, TreeEncodeFun_t pFun, void* Ctx)
+{
+    //! Check input parameters
+    if(NULL == pEnc || NULL == pStack)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(Size <= 0 || DataSize < 0)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+#ifdef USE_INLINE_DATA
+    //! Only TREE_DATA_SIZE bytes can be copied from node.
+    if(NULL == pFun && DataSize > TREE_DATA_SIZE)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+#endif
+
+    pEnc->pStack   = pStack;
+    pEnc->Size     = Size;
+    pEnc->Top      = 0;
+    pEnc->pNext    = pNode;
+    pEnc->DataSize = DataSize;
+    pEnc->pFun     = pFun;
+    pEnc->Ctx      = Ctx;
+    pEnc->Done     = 0;
+    pEnc->Error    = ERR_SUCCESS;
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Encode the next chunk of stream.
+//! Only whole records are written, the chunk can be sent before the next call, and the
+//! tree MUST not be modified until the stream is done.
+//!
+//! \param  [in] pEnc is the encoder.
+//! \param  [in] pBuf is the chunk buffer.
+//! \param  [in] Size is the byte size of pBuf, at least \ref TREE_STREAM_REC_SIZE.
+//!
+//! \retval the number of bytes written, 0 if the stream is done, or -1 on failure and
+//!         the reason is saved in Error: \ref ERR_MEM if pBuf is too small or the stack
+//!         is full, or the non-zero value of encode function.
+//
+//****************************************************************************************
+int Tree_StreamEncode(TreeStreamEnc_t* pEnc, void* pBuf, int Size)
+{
+    unsigned char* pOut    = (unsigned char*)pBuf;
+    TreeNode_t*    pNode   = NULL;
+    int            RecSize = 0;
+    int            Used    = 0;
+    int            Ret     = 0;
+
+    ASSERT(NULL != pEnc);
+
+    if(pEnc->Done)
+    {
+        return (0);
+    }
+
+    RecSize = TREE_STREAM_REC_SIZE(pEnc->DataSize);
+    if(NULL == pBuf || Size < RecSize)
+    {
+        pEnc->Error = (NULL == pBuf) ? ERR_INVALID_POINTER : ERR_MEM;
+        return (-1);
+    }
+
+    //! Empty tree is one null marker.
+    if(NULL == pEnc->pNext)
+    {
+        pOut[0]    = STREAM_NULL;
+        pEnc->Done = 1;
+        return (1);
+    }
+
+    while(Size - Used >= RecSize)
+    {
+        pNode = pEnc->pNext;
+
+        //! Only the right child of node with both children is kept on stack.
+        if(NULL != pNode->left && NULL != pNode->right && pEnc->Top >= pEnc->Size)
+        {
+            pEnc->Error = ERR_MEM;
+            return (-1);
+        }
+
+        pOut[Used] = (unsigned char)(STREAM_NODE | ((NULL != pNode->left)  ? STREAM_LEFT  : 0)
+                                                 | ((NULL != pNode->right) ? STREAM_RIGHT : 0));
+        if(NULL != pEnc->pFun)
+        {
+            Ret = pEnc->pFun(pEnc->Ctx, pNode->data, pOut + Used + 1, pEnc->DataSize);
+            if(0 != Ret)
+            {
+                pEnc->Error = (TreeErrorCode_t)Ret;
+                return (-1);
+            }
+        }
+        else if(pEnc->DataSize > 0)
+        {
+            memcpy(pOut + Used + 1, pNode->data, (size_t)pEnc->DataSize);
+        }
+        Used += RecSize;
+
+        if(NULL != pNode->left)
+        {
+            if(NULL != pNode->right)
+            {
+                pEnc->pStack[pEnc->Top++] = pNode->right;
+            }
+            pEnc->pNext = pNode->left;
+        }
+        else if(NULL != pNode->right)
+        {
+            pEnc->pNext = pNode->right;
+        }
+        else if(pEnc->Top > 0)
+        {
+            pEnc->pNext = pEnc->pStack[--pEnc->Top];
+        }
+        else
+        {
+            pEnc->pNext = NULL;
+            pEnc->Done  = 1;
+            break;
+        }
+    }
+
+    return (Used);
+}
+
+//****************************************************************************************
+//
+//! \brief  Encode the whole stream through write function.
+//! pBuf is reused for every chunk, so no more memory is used for large tree.
+//!
+//! \param  [in] pEnc is the encoder.
+//! \param  [in] pBuf is the chunk buffer.
+//! \param  [in] Size is the byte size of pBuf, at least \ref TREE_STREAM_REC_SIZE.
+//! \param  [in] pWrite is the user's write function.
+//! \param  [in] Ctx is context environment, just for write function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, or the Error of encoder.
+//!         Writing stops at once when pWrite return non-zero, and the value is returned.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_StreamWrite(TreeStreamEnc_t* pEnc, void* pBuf, int Size,
+                                 TreeWriteFun_t pWrite, void* Ctx)
+{
+    int Len = 0;
+    int Ret = 0;
+
+    //! Check input parameters
+    if(NULL == pEnc || NULL == pBuf || NULL == pWrite)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    for(;;)
+    {
+        Len = Tree_StreamEncode(pEnc, pBuf, Size);
+        if(Len < 0)
+        {
+            return (pEnc->Error);
+        }
+
+        if(0 == Len)
+        {
+            return (ERR_SUCCESS);
+        }
+
+        Ret = pWrite(Ctx, pBuf, Len);
+        if(0 != Ret)
+        {
+            return ((TreeErrorCode_t)Ret);
+        }
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Initialize stream decoder.
+//!
+//! \param  [in] pDec is the decoder.
+//! \param  [in] pPool is the node pool, every record take one node from it.
+//! \param  [in] pStack is the work stack, one entry for every pending right child.
+//! \param  [in] Size is the capacity of pStack, the height of tree is enough.
+//! \param  [in] pRecBuf is the partial record buffer, at least \ref TREE_STREAM_REC_SIZE
+//!              bytes.
+//! \param  [in] DataSize is the payload size of every record, in bytes.
+//! \param  [in] pFun is the user's decode function. NULL is only allowed with
+//!              <USE_INLINE_DATA>, payload is copied into node then.
+//! \param  [in] Ctx is context environment, just for decode function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Size or
+//!         DataSize is wrong.
+//
+//****************************************************************************************
+TreeErrorCode_t Tree_StreamDecodeInit(TreeStreamDec_t* pDec, TreePool_t* pPool, TreeNode_t** pStack,
+                                      int Size, void* pRecBuf, int DataSize,
+                                      TreeDecodeFun_t pFun, void* Ctx)
+{
+    //! Check input parameters
+    if(NULL == pDec || NULL == pPool || NULL == pStack || NULL == pRecBuf)
+    {
+        return (ERR_INVALID_POINTER);
+    }
+
+    if(Size <= 0 || DataSize < 0)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+
+#ifdef USE_INLINE_DATA
+    //! Payload is copied into node without decode function.
+    if(NULL == pFun && DataSize > TREE_DATA_SIZE)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+#else
+    //! Data pointer can only be set by decode function.
+    if(NULL == pFun && DataSize > 0)
+    {
+        return (ERR_WRONG_PARAM);
+    }
+#endif
+
+    pDec->pPool    = pPool;
+    pDec->pStack   = pStack;
+    pDec->Size     = Size;
+    pDec->Top      = 0;
+    pDec->pLast    = NULL;
+    pDec->LastPos  = INSERT_POS_LEFT;
+    pDec->pRoot    = NULL;
+    pDec->pRec     = (unsigned char*)pRecBuf;
+    pDec->Fill     = 0;
+    pDec->DataSize = DataSize;
+    pDec->pFun     = pFun;
+    pDec->Ctx      = Ctx;
+    pDec->Done     = 0;
+    pDec->Error    = ERR_SUCCESS;
+
+    return (ERR_SUCCESS);
+}
+
+//****************************************************************************************
+//
+//! \brief  Decode the next chunk of stream.
+//! Chunk can be split at any byte. Every whole record is linked into tree at once, so
+//! pRoot is a valid part of tree between calls.
+//!
+//! \param  [in] pDec is the decoder.
+//! \param  [in] pBuf is the received bytes.
+//! \param  [in] Size is the number of received bytes.
+//!
+//! \retval the number of bytes used, it's less than Size only when the stream is done,
+//!         or -1 on failure and the reason is saved in Error: \ref ERR_MEM if pool or
+//!         stack is empty, \ref ERR_FAILURE if stream is broken, or the non-zero value
+//!         of decode function. Nodes decoded are left in tree.
+//
+//****************************************************************************************
+int Tree_StreamDecode(TreeStreamDec_t* pDec, const void* pBuf, int Size)
+{
+    const unsigned char* pIn     = (const unsigned char*)pBuf;
+    TreeErrorCode_t      Ret     = ERR_SUCCESS;
+    int                  RecSize = 0;
+    int                  Used    = 0;
+    int                  Part    = 0;
+
+    ASSERT(NULL != pDec);
+
+    if((NULL == pBuf && Size > 0) || Size < 0)
+    {
+        pDec->Error = (Size < 0) ? ERR_WRONG_PARAM : ERR_INVALID_POINTER;
+        return (-1);
+    }
+
+    RecSize = TREE_STREAM_REC_SIZE(pDec->DataSize);
+    while(!pDec->Done && Used < Size)
+    {
+        //! Empty tree is one null marker, it's shorter than record.
+        if(NULL == pDec->pRoot && 0 == pDec->Fill && STREAM_NULL == pIn[Used])
+        {
+            pDec->Done = 1;
+            Used++;
+            break;
+        }
+
+        if(0 == pDec->Fill && Size - Used >= RecSize)
+        {
+            //! Whole record in chunk, decode it in place.
+            Ret   = StreamRecDecode(pDec, pIn + Used);
+            Used += RecSize;
+        }
+        else
+        {
+            //! Record is split by chunks, gather it.
+            Part = RecSize - pDec->Fill;
+            if(Part > Size - Used)
+            {
+                Part = Size - Used;
+            }
+            memcpy(pDec->pRec + pDec->Fill, pIn + Used, (size_t)Part);
+            pDec->Fill += Part;
+            Used       += Part;
+            if(pDec->Fill < RecSize)
+            {
+                break;
+            }
+
+            pDec->Fill = 0;
+            Ret = StreamRecDecode(pDec, pDec->pRec);
+        }
+
+        if(ERR_SUCCESS != Ret)
+        {
+            pDec->Error = Ret;
+            return (-1);
+        }
+    }
+
+    return (Used);
+}
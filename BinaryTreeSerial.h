@@ -0,0 +1,444 @@
+//****************************************************************************************
+//!
+//! \file    BinaryTreeSerial.h
+//! \brief   Binary Tree Image Interface.
+//!          Save tree into a position independent image, and use the image in place.
+//!          Stream tree chunk by chunk with bounded memory.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#ifndef __BINARYTREESERIAL_H__
+#define __BINARYTREESERIAL_H__
+
+#include "BinaryTree.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//****************************************************************************************
+//!                           CONFIGURE MACRO
+//****************************************************************************************
+
+//! Work stack depth of \ref Tree_ImageSave.
+//! One entry is used for every pending right child on the path, they are located on the
+//! call stack.
+//!
+//! \note Default: 64 entries.
+#ifndef TREE_IMAGE_DEPTH
+#define TREE_IMAGE_DEPTH       64
+#endif
+
+//! Map image file by mmap ?
+//! <USE_IMAGE_MMAP> is defined on POSIX platform, define <TREE_IMAGE_NO_MMAP> to
+//! remove \ref Tree_ImageMap and \ref Tree_ImageUnmap.
+#if !defined(TREE_IMAGE_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define USE_IMAGE_MMAP
+#endif
+
+//****************************************************************************************
+//!                           PUBLIC DATA INTERFACE
+//****************************************************************************************
+
+//! \brief Record index of no record.
+#define TREE_IMAGE_NONE        ((int)-1)
+
+//****************************************************************************************
+//! \brief Encode function of \ref Tree_ImageSave and \ref Tree_StreamEncode.
+//!
+//! \param  [in] Context is the user's context.
+//! \param  [in] Data is the data of node, same as \ref TreeCallBackFun_t.
+//! \param  [in] pBuf is the payload of record, it's 8 bytes aligned in image, and not
+//!              aligned in stream.
+//! \param  [in] Size is the byte size of payload.
+//! \retval 0 to continue, non-zero to stop saving. Stop value MUST be negative or not
+//!         less than <TREE_STOP_BASE>, see \ref TreeCallBackFun_t.
+//****************************************************************************************
+typedef int (*TreeEncodeFun_t)(void* Context, void* Data, void* pBuf, int Size);
+
+//****************************************************************************************
+//! \brief Handle of tree image.
+//! Image is a header and an array of fixed size records, every record has the index of
+//! its children and the payload of node. The byte order is the native one.
+//****************************************************************************************
+typedef struct TreeImage
+{
+    const unsigned char* pRec;      //!< Record array.
+    int                  Count;     //!< Number of records.
+    int                  RecSize;   //!< Byte size of record.
+    int                  DataSize;  //!< Byte size of payload.
+    void*                pMap;      //!< Mapped file, NULL if not mapped.
+    size_t               MapSize;   //!< Byte size of mapped file.
+}TreeImage_t;
+
+//! \brief Byte size of record of stream with DataSize bytes payload.
+//! A record is one flag byte and the payload, the flag tells whether the node has left
+//! and right child, so it's the pre-order encoding with null markers packed in one byte.
+#define TREE_STREAM_REC_SIZE(DataSize) ((DataSize) + 1)
+
+//****************************************************************************************
+//! \brief Decode function of \ref Tree_StreamDecode.
+//!
+//! \param  [in] Context is the user's context.
+//! \param  [in] pNode is the new node, it's not linked into tree yet.
+//! \param  [in] pBuf is the payload of record, it's not aligned.
+//! \param  [in] Size is the byte size of payload.
+//! \retval 0 to continue, non-zero to stop decoding. Stop value MUST be negative or not
+//!         less than <TREE_STOP_BASE>, see \ref TreeCallBackFun_t.
+//****************************************************************************************
+typedef int (*TreeDecodeFun_t)(void* Context, TreeNode_t* pNode, const void* pBuf, int Size);
+
+//****************************************************************************************
+//! \brief Write function of \ref Tree_StreamWrite.
+//!
+//! \param  [in] Context is the user's context.
+//! \param  [in] pBuf is the encoded bytes.
+//! \param  [in] Size is the number of encoded bytes.
+//! \retval 0 to continue, non-zero to stop writing. Stop value MUST be negative or not
+//!         less than <TREE_STOP_BASE>, see \ref TreeCallBackFun_t.
+//****************************************************************************************
+typedef int (*TreeWriteFun_t)(void* Context, const void* pBuf, int Size);
+
+//****************************************************************************************
+//! \brief Stream encoder.
+//! Encoder keeps only the nodes whose right child is not written yet and whose left
+//! child is, in the stack supplied by user, so the memory is bounded by the height of
+//! tree.
+//****************************************************************************************
+typedef struct TreeStreamEnc
+{
+    TreeNode_t**    pStack;    //!< Right children to write.
+    int             Size;      //!< Capacity of stack, in entries.
+    int             Top;       //!< Number of entries in use.
+    TreeNode_t*     pNext;     //!< Next node to write, NULL for empty tree.
+    int             DataSize;  //!< Byte size of payload.
+    TreeEncodeFun_t pFun;      //!< User's encode function.
+    void*           Ctx;       //!< Context of encode function.
+    int             Done;      //!< Non-zero when the whole tree is written.
+    TreeErrorCode_t Error;     //!< Reason of the last failure.
+}TreeStreamEnc_t;
+
+//****************************************************************************************
+//! \brief Stream decoder.
+//! Decoder keeps the nodes whose right child is not read yet, and one partial record
+//! which is split by chunks, in the buffers supplied by user.
+//****************************************************************************************
+typedef struct TreeStreamDec
+{
+    TreePool_t*     pPool;     //!< Node pool of new nodes.
+    TreeNode_t**    pStack;    //!< Nodes whose right child is pending.
+    int             Size;      //!< Capacity of stack, in entries.
+    int             Top;       //!< Number of entries in use.
+    TreeNode_t*     pLast;     //!< Node whose child is the next record, or NULL.
+    int             LastPos;   //!< Position of the next record, INSERT_POS_LEFT/RIGHT.
+    TreeNode_t*     pRoot;     //!< Root of decoded tree.
+    unsigned char*  pRec;      //!< Partial record buffer.
+    int             Fill;      //!< Number of bytes in partial record buffer.
+    int             DataSize;  //!< Byte size of payload.
+    TreeDecodeFun_t pFun;      //!< User's decode function.
+    void*           Ctx;       //!< Context of decode function.
+    int             Done;      //!< Non-zero when the whole tree is read.
+    TreeErrorCode_t Error;     //!< Reason of the last failure.
+}TreeStreamDec_t;
+
+//****************************************************************************************
+//!                           PUBLIC API
+//****************************************************************************************
+
+//****************************************************************************************
+//
+//! \brief  Get the byte size of image of tree.
+//!
+//! \param  [in] pNode is the root of tree, NULL for empty tree.
+//! \param  [in] DataSize is the payload size of every record, in bytes.
+//! \retval the byte size of image, 0 if DataSize < 0.
+//
+//****************************************************************************************
+extern size_t Tree_ImageSize(TreeNode_t* pNode, int DataSize);
+
+//****************************************************************************************
+//
+//! \brief  Save tree into image buffer.
+//! Records are written in pre-order, so the left child of record i is record i + 1,
+//! and the right child is linked by its record index. No pointer is stored, the
+//! image can be loaded at any address.
+//!
+//! \param  [in] pNode is the root of tree, NULL for empty tree.
+//! \param  [in] pBuf is the image buffer, it MUST be 8 bytes aligned.
+//! \param  [in] BufSize is the byte size of pBuf, see \ref Tree_ImageSize.
+//! \param  [in] DataSize is the payload size of every record, in bytes.
+//! \param  [in] pEnc is the user's encode function, NULL to copy DataSize bytes from
+//!              the data of node (the data pointer, or inline data).
+//! \param  [in] Ctx is context environment, just for encode function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if pBuf
+//!         is NULL, \ref ERR_WRONG_PARAM if DataSize is wrong, \ref ERR_MEM if
+//!         BufSize is too small or the tree is deeper than <TREE_IMAGE_DEPTH>.
+//!         When pEnc return non-zero, saving stops at once and the value is returned.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_ImageSave(TreeNode_t* pNode, void* pBuf, size_t BufSize, int DataSize,
+                                      TreeEncodeFun_t pEnc, void* Ctx);
+
+//****************************************************************************************
+//
+//! \brief  Open image in memory, nothing is copied or allocated.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] pBuf is the image, it MUST be 8 bytes aligned and valid while the
+//!              handle is in use.
+//! \param  [in] Size is the byte size of pBuf.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if input
+//!         parameters contain invalid pointer, \ref ERR_FAILURE if pBuf is not a valid
+//!         image of this platform (magic, version, byte order or size is wrong).
+//!
+//! \note   O(1), records are not checked one by one. A child link which is not after
+//!         its parent in pre-order, or is out of image, is read as no child by
+//!         \ref Tree_ImageLeft, \ref Tree_ImageRight and \ref Tree_ImageFind.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_ImageOpen(TreeImage_t* pImage, const void* pBuf, size_t Size);
+
+#ifdef USE_IMAGE_MMAP
+//****************************************************************************************
+//
+//! \brief  Map image file into memory and open it.
+//! Pages are read by the operating system when records are visited, so load time does
+//! not depend on the size of tree.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] pPath is the file path.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if input
+//!         parameters contain invalid pointer, \ref ERR_FAILURE if file can not be
+//!         mapped or it's not a valid image.
+//!
+//! \note   Only available when <USE_IMAGE_MMAP> is defined.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_ImageMap(TreeImage_t* pImage, const char* pPath);
+
+//****************************************************************************************
+//
+//! \brief  Unmap image opened by \ref Tree_ImageMap.
+//!
+//! \param  [in] pImage is the image handle.
+//! \retval \ref ERR_FAILURE if image is not mapped, otherwise return \ref ERR_SUCCESS.
+//!
+//! \note   Only available when <USE_IMAGE_MMAP> is defined.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_ImageUnmap(TreeImage_t* pImage);
+#endif // USE_IMAGE_MMAP
+
+//****************************************************************************************
+//
+//! \brief  Get the root record of image.
+//!
+//! \param  [in] pImage is the image handle.
+//! \retval 0 if image is not empty, otherwise \ref TREE_IMAGE_NONE.
+//
+//****************************************************************************************
+extern int Tree_ImageRoot(const TreeImage_t* pImage);
+
+//****************************************************************************************
+//
+//! \brief  Get the left child record.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] Rec is a valid record index.
+//! \retval the record index of left child, or \ref TREE_IMAGE_NONE if it has no left
+//!         child or the link is broken.
+//
+//****************************************************************************************
+extern int Tree_ImageLeft(const TreeImage_t* pImage, int Rec);
+
+//****************************************************************************************
+//
+//! \brief  Get the right child record.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] Rec is a valid record index.
+//! \retval the record index of right child, or \ref TREE_IMAGE_NONE if it has no right
+//!         child or the link is broken.
+//
+//****************************************************************************************
+extern int Tree_ImageRight(const TreeImage_t* pImage, int Rec);
+
+//****************************************************************************************
+//
+//! \brief  Get the payload of record.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] Rec is a valid record index.
+//! \retval the address of payload in image, it's 8 bytes aligned and read only.
+//
+//****************************************************************************************
+extern const void* Tree_ImageData(const TreeImage_t* pImage, int Rec);
+
+//****************************************************************************************
+//
+//! \brief  Foreach record of image in pre-order.
+//! Records are stored in pre-order, so it's a sequential scan of image.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] pFun is the user's callback, its Data parameter is the payload of
+//!              record, it MUST not be written.
+//! \param  [in] Ctx is tree context environment, just for call back function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer.
+//!         Traversal stops at once when pFun return non-zero, and the value is returned.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_ImageTravesePreOrder(const TreeImage_t* pImage, TreeCallBackFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//
+//! \brief  Find record in image of binary search tree.
+//!
+//! \param  [in] pImage is the image handle.
+//! \param  [in] Key is the key that want to find, it is passed to pCmp.
+//! \param  [in] pCmp is the user's compare function, its Data parameter is the payload.
+//! \param  [in] Ctx is context environment, just for compare function.
+//!
+//! \retval the record whose payload is equal to Key, or \ref TREE_IMAGE_NONE.
+//!
+//! \note   O(height), like \ref Tree_BstFind.
+//
+//****************************************************************************************
+extern int Tree_ImageFind(const TreeImage_t* pImage, void* Key, TreeCompareFun_t pCmp, void* Ctx);
+
+//****************************************************************************************
+//
+//! \brief  Initialize stream encoder.
+//!
+//! \param  [in] pEnc is the encoder.
+//! \param  [in] pNode is the root of tree, NULL for empty tree.
+//! \param  [in] pStack is the work stack, one entry for every pending right child.
+//! \param  [in] Size is the capacity of pStack, the height of tree is enough.
+//! \param  [in] DataSize is the payload size of every record, in bytes.
+//! \param  [in] pFun is the user's encode function, NULL to copy DataSize bytes from
+//!              the data of node (the data pointer, or inline data).
+//! \param  [in] Ctx is context environment, just for encode function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Size or
+//!         DataSize is wrong.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_StreamEncodeInit(TreeStreamEnc_t* pEnc, TreeNode_t* pNode, TreeNode_t** pStack,
+                                             int Size, int DataSize, TreeEncodeFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//
+//! \brief  Encode the next chunk of stream.
+//! Only whole records are written, the chunk can be sent before the next call, and the
+//! tree MUST not be modified until the stream is done.
+//!
+//! \param  [in] pEnc is the encoder.
+//! \param  [in] pBuf is the chunk buffer.
+//! \param  [in] Size is the byte size of pBuf, at least \ref TREE_STREAM_REC_SIZE.
+//!
+//! \retval the number of bytes written, 0 if the stream is done, or -1 on failure and
+//!         the reason is saved in Error: \ref ERR_MEM if pBuf is too small or the stack
+//!         is full, or the non-zero value of encode function.
+//
+//****************************************************************************************
+extern int Tree_StreamEncode(TreeStreamEnc_t* pEnc, void* pBuf, int Size);
+
+//****************************************************************************************
+//
+//! \brief  Encode the whole stream through write function.
+//! pBuf is reused for every chunk, so no more memory is used for large tree.
+//!
+//! \param  [in] pEnc is the encoder.
+//! \param  [in] pBuf is the chunk buffer.
+//! \param  [in] Size is the byte size of pBuf, at least \ref TREE_STREAM_REC_SIZE.
+//! \param  [in] pWrite is the user's write function.
+//! \param  [in] Ctx is context environment, just for write function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, or the Error of encoder.
+//!         Writing stops at once when pWrite return non-zero, and the value is returned.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_StreamWrite(TreeStreamEnc_t* pEnc, void* pBuf, int Size,
+                                        TreeWriteFun_t pWrite, void* Ctx);
+
+//****************************************************************************************
+//
+//! \brief  Initialize stream decoder.
+//!
+//! \param  [in] pDec is the decoder.
+//! \param  [in] pPool is the node pool, every record take one node from it.
+//! \param  [in] pStack is the work stack, one entry for every pending right child.
+//! \param  [in] Size is the capacity of pStack, the height of tree is enough.
+//! \param  [in] pRecBuf is the partial record buffer, at least \ref TREE_STREAM_REC_SIZE
+//!              bytes.
+//! \param  [in] DataSize is the payload size of every record, in bytes.
+//! \param  [in] pFun is the user's decode function. NULL is only allowed with
+//!              <USE_INLINE_DATA>, payload is copied into node then.
+//! \param  [in] Ctx is context environment, just for decode function.
+//!
+//! \retval \ref ERR_SUCCESS if operate successfully, \ref ERR_INVALID_POINTER if
+//!         input parameters contain invalid pointer, \ref ERR_WRONG_PARAM if Size or
+//!         DataSize is wrong.
+//
+//****************************************************************************************
+extern TreeErrorCode_t Tree_StreamDecodeInit(TreeStreamDec_t* pDec, TreePool_t* pPool, TreeNode_t** pStack,
+                                             int Size, void* pRecBuf, int DataSize,
+                                             TreeDecodeFun_t pFun, void* Ctx);
+
+//****************************************************************************************
+//
+//! \brief  Decode the next chunk of stream.
+//! Chunk can be split at any byte. Every whole record is linked into tree at once, so
+//! pRoot is a valid part of tree between calls.
+//!
+//! \param  [in] pDec is the decoder.
+//! \param  [in] pBuf is the received bytes.
+//! \param  [in] Size is the number of received bytes.
+//!
+//! \retval the number of bytes used, it's less than Size only when the stream is done,
+//!         or -1 on failure and the reason is saved in Error: \ref ERR_MEM if pool or
+//!         stack is empty, \ref ERR_FAILURE if stream is broken, or the non-zero value
+//!         of decode function. Nodes decoded are left in tree.
+//
+//****************************************************************************************
+extern int Tree_StreamDecode(TreeStreamDec_t* pDec, const void* pBuf, int Size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BINARYTREESERIAL_H__
@@ -0,0 +1,374 @@
+//******************************************************************************
+//!
+//! \file    BinaryTreeStats.c
+//! \brief   Binary Tree Statistics Implement
+//!          Counters and latency histograms of hot paths, see <USE_TREE_STATS>.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    clock_gettime() of the default clock is POSIX.
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+//! clock_gettime() is hidden by strict ISO C mode.
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "BinaryTreeStats.h"
+#include <stddef.h>
+#include <string.h>
+
+#ifndef TREE_STATS_CLOCK
+#include <time.h>
+#endif
+
+//**************************************************************************************
+//!                     ASSERT MACRO
+//**************************************************************************************
+#ifndef ASSERT
+
+#ifdef  NDEBUG
+#define ASSERT(x)
+#else
+#define ASSERT(x) do {while(!(x));} while(0)
+#endif
+
+#endif  // ASSERT
+
+//! \internal
+//! \brief Add Value to a counter of block, only the owner thread writes it.
+#define STATS_ADD(Field, Value)   TREE_STATS_STORE(Field, (Field) + (Value))
+
+//! \internal
+//! \brief Raise a counter of block to Value.
+#define STATS_MAX(Field, Value)                                                       \
+    do                                                                                \
+    {                                                                                 \
+        if((Value) > (Field))                                                         \
+        {                                                                             \
+            TREE_STATS_STORE(Field, Value);                                           \
+        }                                                                             \
+    } while(0)
+
+TREE_STATS_TLS TreeStats_t* g_pTreeStats = NULL;
+
+//****************************************************************************************
+//
+//! \brief  Bind statistics block to calling thread.
+//! Every instrumented function called by this thread is accounted into pStats, bind
+//! the block of a tree before operating on it to get per tree statistics.
+//!
+//! \param  [in] pStats is the statistics block, NULL turns statistics off for calling
+//!              thread. It must be valid while it is bound.
+//! \retval the block bound before, so it can be restored.
+//!
+//! \note   When no block is bound, every hook costs a thread local load and a branch.
+//
+//****************************************************************************************
+TreeStats_t* Tree_StatsBind(TreeStats_t* pStats)
+{
+    TreeStats_t* pOld = g_pTreeStats;
+
+    g_pTreeStats = pStats;
+
+    return (pOld);
+}
+
+//****************************************************************************************
+//
+//! \brief  Clear all counters and histograms of statistics block.
+//!
+//! \param  [in] pStats is the statistics block.
+//!
+//! \note   Owner thread must not be operating on the block at the same time.
+//
+//****************************************************************************************
+void Tree_StatsReset(TreeStats_t* pStats)
+{
+    //! Check input parameter
+    ASSERT(NULL != pStats);
+
+    memset(pStats, 0, sizeof(TreeStats_t));
+}
+
+//! \internal
+//! \brief Merge histogram pSrc into pDst.
+static void HistMerge(TreeStatsHist_t* pDst, const TreeStatsHist_t* pSrc)
+{
+    uint64_t Max = TREE_STATS_LOAD(pSrc->Max);
+    int      i   = 0;
+
+    for(i = 0; i < TREE_STATS_HIST_SIZE; i++)
+    {
+        pDst->Count[i] += TREE_STATS_LOAD(pSrc->Count[i]);
+    }
+
+    pDst->Sum += TREE_STATS_LOAD(pSrc->Sum);
+    if(Max > pDst->Max)
+    {
+        pDst->Max = Max;
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Take a snapshot of statistics blocks.
+//! Blocks are merged, so the blocks of several threads working on one tree can be
+//! exported as one.
+//!
+//! \param  [out] pSnap is the snapshot.
+//! \param  [in]  pStats is the array of statistics blocks.
+//! \param  [in]  Count is the number of blocks.
+//!
+//! \note   It can be called by any thread while owners are updating blocks, then every
+//!         counter is read atomically, but not the whole block at one instant.
+//
+//****************************************************************************************
+void Tree_StatsSnapshot(TreeStatsSnap_t* pSnap, const TreeStats_t* pStats, int Count)
+{
+    uint64_t DepthSum        = 0;
+    uint64_t DepthMax        = 0;
+    uint64_t TraveseDepthSum = 0;
+    int      i               = 0;
+
+    //! Check input parameter
+    ASSERT(NULL != pSnap);
+    ASSERT(NULL != pStats || 0 == Count);
+
+    memset(pSnap, 0, sizeof(TreeStatsSnap_t));
+    for(i = 0; i < Count; i++)
+    {
+        pSnap->Allocs    += TREE_STATS_LOAD(pStats[i].Allocs);
+        pSnap->Frees     += TREE_STATS_LOAD(pStats[i].Frees);
+        pSnap->Frees     += TREE_STATS_LOAD(pStats[i].Reclaimed);
+        pSnap->Appends     += TREE_STATS_LOAD(pStats[i].Appends);
+        pSnap->AppendFails += TREE_STATS_LOAD(pStats[i].AppendFails);
+        pSnap->Callbacks   += TREE_STATS_LOAD(pStats[i].Callbacks);
+        pSnap->Traverses   += TREE_STATS_LOAD(pStats[i].Traverses);
+        TraveseDepthSum    += TREE_STATS_LOAD(pStats[i].TraveseDepthSum);
+        pSnap->Descents    += TREE_STATS_LOAD(pStats[i].Descents);
+        DepthSum           += TREE_STATS_LOAD(pStats[i].DepthSum);
+
+        DepthMax = TREE_STATS_LOAD(pStats[i].TraveseDepthMax);
+        if(DepthMax > pSnap->TraveseDepthMax)
+        {
+            pSnap->TraveseDepthMax = DepthMax;
+        }
+
+        DepthMax = TREE_STATS_LOAD(pStats[i].DepthMax);
+        if(DepthMax > pSnap->DepthMax)
+        {
+            pSnap->DepthMax = DepthMax;
+        }
+
+        HistMerge(&pSnap->Travese, &pStats[i].Travese);
+        HistMerge(&pSnap->Delete,  &pStats[i].Delete);
+    }
+
+    pSnap->Nodes = (int64_t)(pSnap->Allocs - pSnap->Frees);
+    if(0 != pSnap->Traverses)
+    {
+        pSnap->TraveseDepthMean = (double)TraveseDepthSum / (double)pSnap->Traverses;
+    }
+    if(0 != pSnap->Descents)
+    {
+        pSnap->DepthMean = (double)DepthSum / (double)pSnap->Descents;
+    }
+}
+
+//****************************************************************************************
+//
+//! \brief  Get the upper bound of latency of a percentage of calls.
+//!
+//! \param  [in] pHist is the latency histogram, such as the one of snapshot.
+//! \param  [in] Percent is in [0, 100].
+//! \retval the upper bound in ns of the bucket where Percent of calls are reached, or
+//!         0 if histogram is empty. The last bucket has no bound, Max is returned.
+//
+//****************************************************************************************
+uint64_t Tree_StatsPercentile(const TreeStatsHist_t* pHist, int Percent)
+{
+    uint64_t Total  = 0;
+    uint64_t Target = 0;
+    uint64_t Bound  = 0;
+    int      i      = 0;
+
+    //! Check input parameter
+    ASSERT(NULL != pHist);
+    ASSERT(0 <= Percent && Percent <= 100);
+
+    for(i = 0; i < TREE_STATS_HIST_SIZE; i++)
+    {
+        Total += pHist->Count[i];
+    }
+
+    if(0 == Total)
+    {
+        return (0);
+    }
+
+    //! Rank of the call wanted, the first call at least.
+    Target = (Total * (uint64_t)Percent + 99) / 100;
+    if(0 == Target)
+    {
+        Target = 1;
+    }
+
+    for(i = 0; i < TREE_STATS_HIST_SIZE - 1; i++)
+    {
+        Target = (Target > pHist->Count[i]) ? Target - pHist->Count[i] : 0;
+        if(0 == Target)
+        {
+            break;
+        }
+    }
+
+    //! A bucket never holds a call slower than Max.
+    Bound = (i < TREE_STATS_HIST_SIZE - 1) ? ((uint64_t)2 << i) - 1 : pHist->Max;
+
+    return ((Bound < pHist->Max) ? Bound : pHist->Max);
+}
+
+//****************************************************************************************
+//
+//! \brief  Account one root to node walk of a search tree.
+//!
+//! \param  [in] Depth is the number of nodes passed by the walk.
+//!
+//! \note   It's called by search tree functions, call it from your own search loop
+//!         to get its depth accounted too.
+//
+//****************************************************************************************
+void Tree_StatsDescent(int Depth)
+{
+    TreeStats_t* pStats = g_pTreeStats;
+
+    if(NULL == pStats)
+    {
+        return;
+    }
+
+    STATS_ADD(pStats->Descents, 1);
+    STATS_ADD(pStats->DepthSum, (uint64_t)Depth);
+    STATS_MAX(pStats->DepthMax, (uint64_t)Depth);
+}
+
+//****************************************************************************************
+//
+//! \brief  Account the work depth of one traverse call.
+//!
+//! \param  [in] Depth is the levels of recursion, or the most entries of work stack,
+//!              reached by the call. It is about the height of tree, never more.
+//!
+//! \note
+//!         -# It's called by traverse functions when they return, except for
+//!            \ref ERR_MEM.
+//!         -# Functions that follow parent pointer and level-order traverse hold no path
+//!            of tree, they are not accounted.
+//
+//****************************************************************************************
+void Tree_StatsTravese(int Depth)
+{
+    TreeStats_t* pStats = g_pTreeStats;
+
+    if(NULL == pStats)
+    {
+        return;
+    }
+
+    STATS_ADD(pStats->Traverses, 1);
+    STATS_ADD(pStats->TraveseDepthSum, (uint64_t)Depth);
+    STATS_MAX(pStats->TraveseDepthMax, (uint64_t)Depth);
+}
+
+//****************************************************************************************
+//
+//! \brief  Account nodes freed for the owner of a block by another thread.
+//! Unlike other counters, Reclaimed is added atomically, so a thread freeing nodes on
+//! behalf of the owner (such as the reclaimer of \ref Tree_SubTreeDelete_Async) can
+//! account them into the owner's block while the owner is using it.
+//!
+//! \param  [in] pStats is the block of the owner, NULL is ignored.
+//! \param  [in] Count is the number of nodes freed.
+//
+//****************************************************************************************
+void Tree_StatsReclaimed(TreeStats_t* pStats, uint64_t Count)
+{
+    if(NULL == pStats)
+    {
+        return;
+    }
+
+    TREE_STATS_ADD_SHARED(pStats->Reclaimed, Count);
+}
+
+//****************************************************************************************
+//
+//! \brief  Get time of latency clock.
+//!
+//! \retval monotonic time in ns, see <TREE_STATS_CLOCK>.
+//
+//****************************************************************************************
+uint64_t Tree_StatsClock(void)
+{
+#ifdef TREE_STATS_CLOCK
+    return (TREE_STATS_CLOCK());
+#else
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+
+    return ((uint64_t)Now.tv_sec * 1000000000u + (uint64_t)Now.tv_nsec);
+#endif
+}
+
+//****************************************************************************************
+//
+//! \brief  Account one call into latency histogram.
+//!
+//! \param  [in] pHist is the histogram of bound block.
+//! \param  [in] Start is the time got by \ref Tree_StatsClock when the call begins.
+//
+//****************************************************************************************
+void Tree_StatsLatency(TreeStatsHist_t* pHist, uint64_t Start)
+{
+    uint64_t Time = Tree_StatsClock() - Start;
+    uint64_t Ns   = Time;
+    int      i    = 0;
+
+    //! Bucket is floor(log2(Time)), slower calls are in the last bucket.
+    while(Ns > 1 && i < TREE_STATS_HIST_SIZE - 1)
+    {
+        Ns >>= 1;
+        i++;
+    }
+
+    STATS_ADD(pHist->Count[i], 1);
+    STATS_ADD(pHist->Sum, Time);
+    STATS_MAX(pHist->Max, Time);
+}
@@ -0,0 +1,289 @@
+//****************************************************************************************
+//!
+//! \file    BinaryTreeStats.h
+//! \brief   Binary Tree Statistics Interface.
+//!          Counters and latency histograms of hot paths, compiled out by default,
+//!          see <USE_TREE_STATS>.
+//! \version V1.0
+//! \author  cedar
+//! \date    2026-10-14
+//! \email   xuesong5825718@gmail.com
+//!
+//! \note    Statistics are accounted into the block bound to calling thread by
+//!          \ref Tree_StatsBind, so one block can be bound per tree (or per thread)
+//!          and nothing is shared by writers, except Reclaimed, see
+//!          \ref Tree_StatsReclaimed.
+//!
+//! \license
+//!
+//! Copyright (c) 2013 Cedar MIT License
+//!
+//! Permission is hereby granted, free of charge, to any person obtaining a copy
+//! of this software and associated documentation files (the "Software"), to deal
+//! in the Software without restriction, including without limitation the rights to
+//! use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+//! the Software, and to permit persons to whom the Software is furnished to do so,
+//! subject to the following conditions:
+//!
+//! The above copyright notice and this permission notice shall be included in all
+//! copies or substantial portions of the Software.
+//!
+//! THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//! IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//! FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//! AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//! LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//! OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+//! IN THE SOFTWARE.
+///
+//****************************************************************************************
+
+#ifndef __BINARYTREESTATS_H__
+#define __BINARYTREESTATS_H__
+
+#include "BinaryTree.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//****************************************************************************************
+//!                           CONFIGURE MACRO
+//****************************************************************************************
+
+//! Number of buckets of latency histogram.
+//! Bucket i counts the calls that take [2^i, 2^(i+1)) ns, bucket 0 also counts 0 ns,
+//! and the last bucket counts all slower calls.
+//!
+//! \note Default: 32 buckets, the last one starts at about 2 seconds.
+#ifndef TREE_STATS_HIST_SIZE
+#define TREE_STATS_HIST_SIZE   32
+#endif
+
+//! Thread local storage class of the bound block pointer.
+//! Define it to nothing on a single thread platform without thread local storage.
+//!
+//! \note Default: __thread of GCC or clang.
+#ifndef TREE_STATS_TLS
+#if defined(__GNUC__) || defined(__clang__)
+#define TREE_STATS_TLS         __thread
+#else
+#error "Please define TREE_STATS_TLS for your compiler."
+#endif
+#endif
+
+//! Clock of latency histogram, it returns a monotonic time in ns as uint64_t.
+//! Define it to the cycle counter or the timer of your platform.
+//!
+//! \note Default: clock_gettime(CLOCK_MONOTONIC), see \ref Tree_StatsClock.
+//#define TREE_STATS_CLOCK()     MyClockNs()
+
+//! \brief Store/load one counter. Every block has only one writer, the owner thread,
+//!        relaxed atomic access let other threads take a snapshot at any time.
+//!        Shared add is for the counters written by several threads, see
+//!        \ref Tree_StatsReclaimed.
+#if defined(__GNUC__) || defined(__clang__)
+#define TREE_STATS_STORE(Field, Value) __atomic_store_n(&(Field), (Value), __ATOMIC_RELAXED)
+#define TREE_STATS_LOAD(Field)         __atomic_load_n(&(Field), __ATOMIC_RELAXED)
+#define TREE_STATS_ADD_SHARED(Field, Value)                                           \
+    ((void)__atomic_fetch_add(&(Field), (Value), __ATOMIC_RELAXED))
+#else
+#define TREE_STATS_STORE(Field, Value) ((Field) = (Value))
+#define TREE_STATS_LOAD(Field)         (Field)
+#define TREE_STATS_ADD_SHARED(Field, Value) ((void)((Field) += (Value)))
+#endif
+
+//****************************************************************************************
+//!                           PUBLIC DATA INTERFACE
+//****************************************************************************************
+
+//! \brief Latency histogram, times are in ns.
+typedef struct TreeStatsHist
+{
+    uint64_t Count[TREE_STATS_HIST_SIZE];
+    uint64_t Sum;              //!< Total time of all calls.
+    uint64_t Max;              //!< The slowest call.
+}TreeStatsHist_t;
+
+//****************************************************************************************
+//! \brief Statistics block, it is written by the thread it is bound to.
+//! - Allocs/Frees: nodes got/put by dynamic and pool API.
+//! - Reclaimed: nodes freed for the owner by other threads, counted as Frees by
+//!   \ref Tree_StatsSnapshot.
+//! - Appends: nodes linked by \ref Tree_NodeAppend, include the ones of search tree.
+//! - AppendFails: calls of \ref Tree_NodeAppend that return \ref ERR_NODE_EXIST.
+//! - Callbacks: calls of user's callback by traverse functions.
+//! - Traverses/TraveseDepthSum/TraveseDepthMax: traverse calls and the work depth each
+//!   one reached, levels of recursion of recursive algorithm or the most entries of
+//!   work stack of stack algorithm, see \ref Tree_StatsTravese.
+//! - Descents/DepthSum/DepthMax: root to node walks of search tree functions, depth is
+//!   the number of nodes passed.
+//! - Travese/Delete: latency of traverse functions and subtree delete functions.
+//****************************************************************************************
+typedef struct TreeStats
+{
+    uint64_t        Allocs;
+    uint64_t        Frees;
+    uint64_t        Reclaimed;
+    uint64_t        Appends;
+    uint64_t        AppendFails;
+    uint64_t        Callbacks;
+    uint64_t        Traverses;
+    uint64_t        TraveseDepthSum;
+    uint64_t        TraveseDepthMax;
+    uint64_t        Descents;
+    uint64_t        DepthSum;
+    uint64_t        DepthMax;
+    TreeStatsHist_t Travese;
+    TreeStatsHist_t Delete;
+}TreeStats_t;
+
+//! \brief Snapshot of one or more statistics blocks, see \ref Tree_StatsSnapshot.
+typedef struct TreeStatsSnap
+{
+    int64_t         Nodes;     //!< Allocs - Frees, the number of nodes in use.
+    uint64_t        Allocs;
+    uint64_t        Frees;
+    uint64_t        Appends;
+    uint64_t        AppendFails;
+    uint64_t        Callbacks;
+    uint64_t        Traverses;
+    uint64_t        TraveseDepthMax;
+    double          TraveseDepthMean; //!< TraveseDepthSum / Traverses, 0 if no traverse.
+    uint64_t        Descents;
+    uint64_t        DepthMax;
+    double          DepthMean; //!< DepthSum / Descents, 0 if nothing is found.
+    TreeStatsHist_t Travese;
+    TreeStatsHist_t Delete;
+}TreeStatsSnap_t;
+
+//! \internal
+//! \brief The block bound to calling thread, NULL if statistics is off for it.
+//!        Use \ref Tree_StatsBind to change it.
+extern TREE_STATS_TLS TreeStats_t* g_pTreeStats;
+
+//****************************************************************************************
+//!                           PUBLIC API
+//****************************************************************************************
+
+//****************************************************************************************
+//
+//! \brief  Bind statistics block to calling thread.
+//! Every instrumented function called by this thread is accounted into pStats, bind
+//! the block of a tree before operating on it to get per tree statistics.
+//!
+//! \param  [in] pStats is the statistics block, NULL turns statistics off for calling
+//!              thread. It must be valid while it is bound.
+//! \retval the block bound before, so it can be restored.
+//!
+//! \note   When no block is bound, every hook costs a thread local load and a branch.
+//
+//****************************************************************************************
+extern TreeStats_t* Tree_StatsBind(TreeStats_t* pStats);
+
+//****************************************************************************************
+//
+//! \brief  Clear all counters and histograms of statistics block.
+//!
+//! \param  [in] pStats is the statistics block.
+//!
+//! \note   Owner thread must not be operating on the block at the same time.
+//
+//****************************************************************************************
+extern void Tree_StatsReset(TreeStats_t* pStats);
+
+//****************************************************************************************
+//
+//! \brief  Take a snapshot of statistics blocks.
+//! Blocks are merged, so the blocks of several threads working on one tree can be
+//! exported as one.
+//!
+//! \param  [out] pSnap is the snapshot.
+//! \param  [in]  pStats is the array of statistics blocks.
+//! \param  [in]  Count is the number of blocks.
+//!
+//! \note   It can be called by any thread while owners are updating blocks, then every
+//!         counter is read atomically, but not the whole block at one instant.
+//
+//****************************************************************************************
+extern void Tree_StatsSnapshot(TreeStatsSnap_t* pSnap, const TreeStats_t* pStats, int Count);
+
+//****************************************************************************************
+//
+//! \brief  Get the upper bound of latency of a percentage of calls.
+//!
+//! \param  [in] pHist is the latency histogram, such as the one of snapshot.
+//! \param  [in] Percent is in [0, 100].
+//! \retval the upper bound in ns of the bucket where Percent of calls are reached, or
+//!         0 if histogram is empty. The last bucket has no bound, Max is returned.
+//
+//****************************************************************************************
+extern uint64_t Tree_StatsPercentile(const TreeStatsHist_t* pHist, int Percent);
+
+//****************************************************************************************
+//
+//! \brief  Account one root to node walk of a search tree.
+//!
+//! \param  [in] Depth is the number of nodes passed by the walk.
+//!
+//! \note   It's called by search tree functions, call it from your own search loop
+//!         to get its depth accounted too.
+//
+//****************************************************************************************
+extern void Tree_StatsDescent(int Depth);
+
+//****************************************************************************************
+//
+//! \brief  Account the work depth of one traverse call.
+//!
+//! \param  [in] Depth is the levels of recursion, or the most entries of work stack,
+//!              reached by the call. It is about the height of tree, never more.
+//!
+//! \note
+//!         -# It's called by traverse functions when they return, except for
+//!            \ref ERR_MEM.
+//!         -# Functions that follow parent pointer and level-order traverse hold no path
+//!            of tree, they are not accounted.
+//
+//****************************************************************************************
+extern void Tree_StatsTravese(int Depth);
+
+//****************************************************************************************
+//
+//! \brief  Account nodes freed for the owner of a block by another thread.
+//! Unlike other counters, Reclaimed is added atomically, so a thread freeing nodes on
+//! behalf of the owner (such as the reclaimer of \ref Tree_SubTreeDelete_Async) can
+//! account them into the owner's block while the owner is using it.
+//!
+//! \param  [in] pStats is the block of the owner, NULL is ignored.
+//! \param  [in] Count is the number of nodes freed.
+//
+//****************************************************************************************
+extern void Tree_StatsReclaimed(TreeStats_t* pStats, uint64_t Count);
+
+//****************************************************************************************
+//
+//! \brief  Get time of latency clock.
+//!
+//! \retval monotonic time in ns, see <TREE_STATS_CLOCK>.
+//
+//****************************************************************************************
+extern uint64_t Tree_StatsClock(void);
+
+//****************************************************************************************
+//
+//! \brief  Account one call into latency histogram.
+//!
+//! \param  [in] pHist is the histogram of bound block.
+//! \param  [in] Start is the time got by \ref Tree_StatsClock when the call begins.
+//
+//****************************************************************************************
+extern void Tree_StatsLatency(TreeStatsHist_t* pHist, uint64_t Start);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BINARYTREESTATS_H__